@@ -36,20 +36,13 @@ extern "C" void Game_GetAudioSamples(game_memory* Memory, u32 SampleCount, audio
                 {
                     Assert(Sound->Source->ChannelCount == 1); // TODO
 
-                    audio_sample* Dst = Samples;
-                    for (u32 SampleIndex = 0; SampleIndex < SampleCount; SampleIndex++)
-                    {
-                        if (Sound->SampleIndex == Sound->Source->SampleCount)
-                        {
-                            AtomicExchange(&Sound->IsValid, false);
-                            break;
-                        }
+                    u32 MixCount = Min(SampleCount, Sound->Source->SampleCount - Sound->SampleIndex);
+                    Kernels->MixMono(Samples, (s16*)Sound->Source->SampleData + Sound->SampleIndex, MixCount, MasterFader);
+                    Sound->SampleIndex += MixCount;
 
-                        s16 SourceSample = ((s16*)Sound->Source->SampleData)[Sound->SampleIndex++];
-                        f32 Sample = SourceSample / 32768.0f;
-                        Dst->Left += MasterFader * Sample;
-                        Dst->Right += MasterFader * Sample;
-                        Dst++;
+                    if (Sound->SampleIndex == Sound->Source->SampleCount)
+                    {
+                        AtomicExchange(&Sound->IsValid, false);
                     }
                 }
                 else
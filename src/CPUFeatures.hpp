@@ -0,0 +1,109 @@
+#pragma once
+
+#include <Common.hpp>
+#include <Intrinsics.hpp>
+
+//
+// CPU features
+//
+// NOTE(boti): Everything is built for the SSE2 baseline of x64, so the same binary runs on any x64 CPU.
+//             Detected once at startup by the platform layer/tools, the SIMD kernels (Kernels.hpp)
+//             and the 8-wide generator paths are then picked for the highest supported level.
+//             Each level implies all of the ones below it.
+//
+enum cpu_level : u32
+{
+    CPULevel_Scalar = 0,
+    CPULevel_SSE41,
+    CPULevel_AVX2,      // AVX2 + FMA
+    CPULevel_AVX512,    // AVX-512 F + BW + DQ + VL
+
+    CPULevel_Count,
+};
+
+static const char* CPULevelNames[CPULevel_Count] =
+{
+    "Scalar",
+    "SSE4.1",
+    "AVX2",
+    "AVX-512",
+};
+
+struct cpu_features
+{
+    bool SSE41;
+    bool AVX;
+    bool AVX2;
+    bool FMA;
+    bool AVX512F;
+    bool AVX512BW;
+    bool AVX512DQ;
+    bool AVX512VL;
+
+    // NOTE(boti): Whether the OS saves the upper halves of the ymm/zmm registers on context switches,
+    //             without this the instructions are there but not usable
+    bool OSSavesYMM;
+    bool OSSavesZMM;
+};
+
+TARGET_XSAVE inline cpu_features DetectCPUFeatures();
+inline cpu_level GetCPULevel(const cpu_features* Features);
+
+//
+// Implementation
+//
+
+TARGET_XSAVE inline cpu_features DetectCPUFeatures()
+{
+    cpu_features Result = {};
+
+    s32 Info[4]; // eax, ebx, ecx, edx
+    __cpuid(Info, 0);
+    s32 MaxLeaf = Info[0];
+
+    if (MaxLeaf >= 1)
+    {
+        __cpuid(Info, 1);
+        Result.SSE41 = (Info[2] & (1 << 19)) != 0;
+        Result.FMA = (Info[2] & (1 << 12)) != 0;
+        Result.AVX = (Info[2] & (1 << 28)) != 0;
+
+        bool HasOSXSave = (Info[2] & (1 << 27)) != 0;
+        if (HasOSXSave)
+        {
+            u64 XCR0 = _xgetbv(0);
+            Result.OSSavesYMM = (XCR0 & 0x06) == 0x06; // xmm, ymm
+            Result.OSSavesZMM = (XCR0 & 0xE6) == 0xE6; // xmm, ymm, opmask, zmm0-15, zmm16-31
+        }
+    }
+
+    if (MaxLeaf >= 7)
+    {
+        __cpuidex(Info, 7, 0);
+        Result.AVX2 = (Info[1] & (1 << 5)) != 0;
+        Result.AVX512F = (Info[1] & (1 << 16)) != 0;
+        Result.AVX512DQ = (Info[1] & (1 << 17)) != 0;
+        Result.AVX512BW = (Info[1] & (1 << 30)) != 0;
+        Result.AVX512VL = (Info[1] & (1 << 31)) != 0;
+    }
+
+    return(Result);
+}
+
+inline cpu_level GetCPULevel(const cpu_features* Features)
+{
+    cpu_level Result = CPULevel_Scalar;
+    if (Features->SSE41)
+    {
+        Result = CPULevel_SSE41;
+        if (Features->AVX && Features->AVX2 && Features->FMA && Features->OSSavesYMM)
+        {
+            Result = CPULevel_AVX2;
+            if (Features->AVX512F && Features->AVX512BW && Features->AVX512DQ && Features->AVX512VL && Features->OSSavesZMM)
+            {
+                Result = CPULevel_AVX512;
+            }
+        }
+    }
+    return(Result);
+}
@@ -1,87 +1,5 @@
 #include "Chunk.hpp"
 
-static void Generate(chunk* Chunk, world* World)
-{
-    TIMED_FUNCTION();
-
-    assert(Chunk);
-    assert(Chunk->Data);
-
-    world_generator* Gen = &World->Generator;
-    vec2 ChunkP = { (f32)Chunk->P.x, (f32)Chunk->P.y };
-    for (u32 y = 0; y < CHUNK_DIM_XY; y++)
-    {
-        for (u32 x = 0; x < CHUNK_DIM_XY; x++)
-        {
-            constexpr f32 TerrainBaseFrequency = 1.0f / 64.0f;
-            constexpr f32 TerrainBaseScale = 32.0f;
-            constexpr u32 TerrainBaseHeight = 80;
-
-            vec2 TerrainP = TerrainBaseFrequency * (vec2{ (f32)x, (f32)y } + ChunkP);
-
-            f32 TerrainSample = SampleOctave(&Gen->Perlin2, TerrainP, 8, 0.5f, 2.0f);
-            TerrainSample = 0.5f * (TerrainSample + 1.0f);
-            TerrainSample = Fade3(TerrainSample*TerrainSample);
-            s32 Height = (s32)Round(TerrainBaseScale * TerrainSample) + TerrainBaseHeight;
-
-            for (u32 z = 0; z < CHUNK_DIM_Z; z++)
-            {
-                // Generate base terrain
-                if ((s32)z > Height)
-                {
-                    Chunk->Data->Voxels[z][y][x] = VOXEL_AIR;
-                }
-                else if ((s32)z > Height - 3)
-                {
-                    Chunk->Data->Voxels[z][y][x] = VOXEL_GROUND;
-                }
-                else
-                {
-                    Chunk->Data->Voxels[z][y][x] = VOXEL_STONE;
-                }
-
-                vec3 P = vec3{ x + ChunkP.x, y + ChunkP.y, (f32)z };
-
-                // Generate ores
-                constexpr f32 OreScale = 1.0f / 8.0f;
-                f32 OreSample = OctaveNoise(&Gen->Perlin3, OreScale*P, 3, 0.5f, 2.0f);
-                // Only replace stone with ores
-                if (Chunk->Data->Voxels[z][y][x] == VOXEL_STONE)
-                {
-                    if (OreSample > 0.75f)
-                    {
-                        Chunk->Data->Voxels[z][y][x] = VOXEL_COAL;
-                    }
-                    else if (OreSample < -0.75f)
-                    {
-                        Chunk->Data->Voxels[z][y][x] = VOXEL_IRON;
-                    }
-                }
-
-                // Generate caves
-                constexpr f32 CaveScale = 1.0f / 16.0f;
-                f32 CaveSample = OctaveNoise(&Gen->Perlin3, CaveScale*P, 1, 0.5f, 2.0f);
-#if 0
-                CaveSample = Abs(CaveSample);
-                if (CaveSample < 0.01f)
-                {
-                    Chunk->Data->Voxels[z][y][x] = VOXEL_AIR;
-                }
-                else
-                {
-                    Chunk->Data->Voxels[z][y][x] = VOXEL_GROUND;
-                }
-#else
-                if (CaveSample < -0.5f && ((z < (TerrainBaseHeight + (s32)TerrainBaseScale)) || ((s32)z < Height)))
-                {
-                    Chunk->Data->Voxels[z][y][x] = VOXEL_AIR;
-                }
-#endif
-            }
-        }
-    }
-}
-
 static const vertex Cube[] = 
 {
     // EAST
@@ -176,15 +94,111 @@ static chunk_mesh BuildMesh(const chunk* Chunk, world* World, memory_arena* Aren
     }
 #endif
 
-    for (s32 z = 0; z < CHUNK_DIM_Z; z++)
+    // NOTE(boti): The sections are unpacked once up front instead of decoding the palette indices voxel by voxel,
+    //             except for the uniform ones: those have the same type everywhere
+    //
+    //             Voxels with opaque neighbors on all 6 sides can't have any visible faces,
+    //             so they're skipped without looking at their neighborhood.
+    //             Only the neighbors inside the chunk are known here, the voxels on the sides of the chunk are never skipped.
+    static_assert(CHUNK_DIM_XY == 16);
+    chunk_voxels* Voxels = PushStruct<chunk_voxels>(Arena);
+    u16* BuriedMask = PushArray<u16>(Arena, CHUNK_DIM_Z * CHUNK_DIM_XY);
+    bool IsUniformSections[CHUNK_SECTION_COUNT];
+    u16 UniformSectionTypes[CHUNK_SECTION_COUNT];
+    for (u32 SectionIndex = 0; SectionIndex < CHUNK_SECTION_COUNT; SectionIndex++)
+    {
+        s32 BeginZ = (s32)SectionIndex * CHUNK_SECTION_DIM;
+        UniformSectionTypes[SectionIndex] = VOXEL_AIR;
+        IsUniformSections[SectionIndex] = !UnpackNonUniformChunkSection(Chunk->Data, SectionIndex, &Voxels->Voxels[BeginZ][0][0],
+                                                                         &UniformSectionTypes[SectionIndex]);
+    }
+
+    // NOTE(boti): Opaque mask of the chunk and the 1 voxel border around it from the neighbors' masks,
+    //             bit x + 1 of row [z + 1][y + 1] is the voxel at (x, y, z) relative to the chunk.
+    //             The face and AO tests read this instead of looking up the desc of each neighbor,
+    //             the neighbors that aren't loaded or final yet are air (same as GetVoxelTypeAt).
+    u32 PaddedOpaqueMask[CHUNK_DIM_Z + 2][CHUNK_DIM_XY + 2];
+    {
+        const chunk* Neighbors[3][3][3];
+        for (s32 dz = -1; dz <= 1; dz++)
+        {
+            for (s32 dy = -1; dy <= 1; dy++)
+            {
+                for (s32 dx = -1; dx <= 1; dx++)
+                {
+                    const chunk* Neighbor = Chunk->Neighbors[dz + 1][dy + 1][dx + 1];
+                    if (Neighbor && (Neighbor->GenerationLevel != ChunkGen_LevelFinal))
+                    {
+                        Neighbor = nullptr;
+                    }
+                    Neighbors[dz + 1][dy + 1][dx + 1] = Neighbor;
+                }
+            }
+        }
+
+        for (s32 z = -1; z <= CHUNK_DIM_Z; z++)
+        {
+            s32 dz = (z < 0) ? -1 : ((z < CHUNK_DIM_Z) ? 0 : 1);
+            s32 NeighborZ = z - dz * CHUNK_DIM_Z;
+            for (s32 y = -1; y <= CHUNK_DIM_XY; y++)
+            {
+                s32 dy = (y < 0) ? -1 : ((y < CHUNK_DIM_XY) ? 0 : 1);
+                s32 NeighborY = y - dy * CHUNK_DIM_XY;
+
+                const chunk* West = Neighbors[dz + 1][dy + 1][0];
+                const chunk* Center = Neighbors[dz + 1][dy + 1][1];
+                const chunk* East = Neighbors[dz + 1][dy + 1][2];
+
+                u32 Row = 0;
+                if (West)   Row |= (West->OpaqueMask[NeighborZ][NeighborY] >> (CHUNK_DIM_XY - 1)) & 1u;
+                if (Center) Row |= (u32)Center->OpaqueMask[NeighborZ][NeighborY] << 1;
+                if (East)   Row |= (u32)(East->OpaqueMask[NeighborZ][NeighborY] & 1u) << (CHUNK_DIM_XY + 1);
+                PaddedOpaqueMask[z + 1][y + 1] = Row;
+            }
+        }
+    }
+
+    auto IsOpaqueAt = [&PaddedOpaqueMask](vec3i P) -> bool
+    {
+        bool Result = (PaddedOpaqueMask[P.z + 1][P.y + 1] >> (P.x + 1)) & 1u;
+        return(Result);
+    };
+
+    Kernels->FindBuriedVoxels(CHUNK_DIM_Z, &Chunk->OpaqueMask[0][0], BuriedMask);
+
+    // NOTE(boti): Nothing above the highest non-air voxel of every column has anything to mesh
+    s32 MaxZ = -1;
+    for (s32 y = 0; y < CHUNK_DIM_XY; y++)
     {
+        for (s32 x = 0; x < CHUNK_DIM_XY; x++)
+        {
+            MaxZ = Max(MaxZ, (s32)Chunk->HighestNonAirZ[y][x]);
+        }
+    }
+
+    for (s32 z = 0; z <= MaxZ; z++)
+    {
+        // NOTE(boti): Uniform air sections don't have anything to mesh,
+        //             only the sides of uniform solid sections can be visible and everything else is buried
+        bool IsUniform = IsUniformSections[z / CHUNK_SECTION_DIM];
+        u16 UniformType = UniformSectionTypes[z / CHUNK_SECTION_DIM];
+        if (IsUniform && (VoxelDescs[UniformType].Flags & VOXEL_FLAGS_NO_MESH))
+        {
+            continue;
+        }
+
         for (s32 y = 0; y < CHUNK_DIM_XY; y++)
         {
             for (s32 x = 0; x < CHUNK_DIM_XY; x++)
             {
+                if (BuriedMask[z * CHUNK_DIM_XY + y] & (1u << x))
+                {
+                    continue;
+                }
+
                 vec3 VoxelP = vec3{ (f32)x, (f32)y, (f32)z };
 
-                u16 VoxelType = Chunk->Data->Voxels[z][y][x];
+                u16 VoxelType = IsUniform ? UniformType : Voxels->Voxels[z][y][x];
                 voxel_desc Desc = VoxelDescs[VoxelType];
 #if 0
                 if ((Desc.Flags & VOXEL_FLAGS_NO_MESH) != 0 || 
@@ -199,19 +213,14 @@ static chunk_mesh BuildMesh(const chunk* Chunk, world* World, memory_arena* Aren
                 }
                 else
                 {
-                    vec3i WorldVoxelP = vec3i{ x, y, z } + vec3i{Chunk->P.x, Chunk->P.y, 0 };
-                    voxel_neighborhood Neighborhood = GetVoxelNeighborhood(World, WorldVoxelP);
+                    vec3i RelVoxelP = vec3i{ x, y, z };
 
                     for (u32 Direction = DIRECTION_First; Direction < DIRECTION_Count; Direction++)
                     {
                         // Delta in the direction of the surface normal
                         vec3i NormalDelta = GlobalDirections[Direction];
 
-                        bool IsOccluded = false;
-                        u16 NeighborType = Neighborhood.GetVoxel(NormalDelta);
-                        const voxel_desc* NeighborDesc = &VoxelDescs[NeighborType];
-
-                        if ((NeighborDesc->Flags & VOXEL_FLAGS_NO_MESH) || (NeighborDesc->Flags & VOXEL_FLAGS_TRANSPARENT))
+                        if (!IsOpaqueAt(RelVoxelP + NormalDelta))
                         {
                             for (u32 i = 0; i < 6; i++)
                             {
@@ -245,29 +254,13 @@ static chunk_mesh BuildMesh(const chunk* Chunk, world* World, memory_arena* Aren
                                     for (u32 j = 0; j < 2; j++)
                                     {
                                         vec3i DeltaP = PlaneDeltaP[j] + NormalDelta;
-                                        u16 AONeighborType = Neighborhood.GetVoxel(DeltaP);
-                                        const voxel_desc* AONeighborDesc = &VoxelDescs[AONeighborType];
-                                        if (!(AONeighborDesc->Flags & VOXEL_FLAGS_NO_MESH) && 
-                                            !(AONeighborDesc->Flags & VOXEL_FLAGS_TRANSPARENT))
-                                        {
-                                            bSideAO[j] = 1;
-                                        }
-                                        else
-                                        {
-                                            bSideAO[j] = 0;
-                                        }
+                                        bSideAO[j] = IsOpaqueAt(RelVoxelP + DeltaP) ? 1 : 0;
                                     }
 
                                     u32 bCornerAO = 0;
                                     {
                                         vec3i DeltaP = PlaneDeltaP[0] + PlaneDeltaP[1] + NormalDelta;
-                                        u16 AONeighborType = Neighborhood.GetVoxel(DeltaP);
-                                        const voxel_desc* AONeighborDesc = &VoxelDescs[AONeighborType];
-                                        if (!(AONeighborDesc->Flags & VOXEL_FLAGS_NO_MESH) && 
-                                            !(AONeighborDesc->Flags & VOXEL_FLAGS_TRANSPARENT))
-                                        {
-                                            bCornerAO = 1;
-                                        }
+                                        bCornerAO = IsOpaqueAt(RelVoxelP + DeltaP) ? 1 : 0;
                                     }
 
                                     if (bSideAO[0] && bSideAO[1])
@@ -4,11 +4,15 @@
 #include <Math.hpp>
 #include <Random.hpp>
 #include <Memory.hpp>
+#include <Intrinsics.hpp>
 
 struct world;
 
+// NOTE(boti): Chunks are cubes stacked in every direction, there's no limit on the height of the world.
+//             chunk::P is the position of the minimum corner of the chunk in voxels, a multiple of the chunk dimensions.
 constexpr s32 CHUNK_DIM_XY = 16;
-constexpr s32 CHUNK_DIM_Z = 256;
+constexpr s32 CHUNK_DIM_Z = 16;
+constexpr vec3i CHUNK_DIM = { CHUNK_DIM_XY, CHUNK_DIM_XY, CHUNK_DIM_Z };
 
 enum axis : u32
 {
@@ -72,6 +76,8 @@ constexpr u16 VOXEL_COAL = 3;
 constexpr u16 VOXEL_IRON = 4;
 constexpr u16 VOXEL_TREE_TRUNK = 5;
 constexpr u16 VOXEL_LEAVES = 6;
+constexpr u16 VOXEL_SAND = 7;
+constexpr u16 VOXEL_SNOW = 8;
 constexpr u16 VOXEL_INVALID = 0xFFFFu;
 
 enum voxel_flags : u32
@@ -97,36 +103,274 @@ static const voxel_desc VoxelDescs[] =
     { VOXEL_FLAGS_SOLID,    { 5, 5, 5, 5, 5, 5 } },
     { VOXEL_FLAGS_SOLID,    { 6, 6, 6, 6, 7, 7 } },
     { VOXEL_FLAGS_SOLID,    { 8, 8, 8, 8, 8, 8 } },
+    { VOXEL_FLAGS_SOLID,    { 9, 9, 9, 9, 9, 9 } },
+    { VOXEL_FLAGS_SOLID,    { 10, 10, 10, 10, 11, 2 } },
 };
 static constexpr u32 VoxelDescCount = CountOf(VoxelDescs);
 
+// Opaque voxels hide the faces of their neighbors and occlude their corners (AO),
+// solid voxels block movement and rays
+inline bool IsOpaqueVoxel(u16 Type);
+inline bool IsSolidVoxel(u16 Type);
+
+//
+// Chunk data
+//
+// NOTE(boti): The voxels of a chunk are stored in 16x16x16 sections, each with its own palette of voxel types
+//             and bit-packed indices into that palette in the order of the chunk's voxel layout.
+//             An index is 0, 1, 2 or 4 bits wide. 0 bits means that the section is uniform: every voxel is Palette[0]
+//             and it has no index memory at all. The indices of the other sections are allocated from the section pool
+//             at the size their width needs.
+//             SetVoxel grows the width when a new type doesn't fit in the palette anymore, the palette never shrinks,
+//             only packing the section again (e.g. when it's generated) makes it as narrow as possible.
+//
+//             The zero initialized chunk_data is all air, but it needs a pool before anything can be written to it.
+//
+//             The layout only changes how the indices are ordered, everything outside of the chunk data
+//             (the unpacked chunk_voxels, the generator, the chunk files) always sees [z][y][x].
+//             Linear is [z][y][x] order, the neighbors of a voxel are 1, 16 and 256 indices away.
+//             Brick groups the voxels into 4x4x4 bricks (the bricks and the voxels inside them are in [z][y][x] order),
+//             so most of a voxel's neighbors are in the same 64 indices (32 bytes at 4 bits per index).
+//             Every layout keeps runs of 4 voxels along x next to each other, packing and unpacking relies on that.
+//
+enum voxel_layout : u32
+{
+    VoxelLayout_Linear = 0,
+    VoxelLayout_Brick,
+
+    VoxelLayout_Count,
+};
+
+static const char* VoxelLayoutNames[VoxelLayout_Count] =
+{
+    "Linear",
+    "Brick",
+};
+
+constexpr s32 CHUNK_SECTION_DIM = 16;
+constexpr u32 CHUNK_SECTION_COUNT = CHUNK_DIM_Z / CHUNK_SECTION_DIM;
+constexpr u32 CHUNK_SECTION_VOXEL_COUNT = CHUNK_SECTION_DIM * CHUNK_DIM_XY * CHUNK_DIM_XY;
+constexpr u32 CHUNK_MAX_BITS_PER_INDEX = 4;
+constexpr u32 CHUNK_MAX_PALETTE_COUNT = 1u << CHUNK_MAX_BITS_PER_INDEX;
+constexpr u64 CHUNK_MAX_SECTION_INDICES_SIZE = CHUNK_SECTION_VOXEL_COUNT * CHUNK_MAX_BITS_PER_INDEX / 8;
+static_assert((CHUNK_DIM_Z % CHUNK_SECTION_DIM) == 0);
+static_assert(VoxelDescCount <= CHUNK_MAX_PALETTE_COUNT);
+
+// NOTE(boti): Fixed size blocks for each index width (1, 2 and 4 bits), carved from an arena and recycled through free lists.
+//             The generator runs on the workers, so allocations are serialized with a mutex.
+struct chunk_section_pool
+{
+    static constexpr u32 SizeClassCount = 3;
+
+    ticket_mutex Mutex;
+    memory_arena Arena;
+    void* FreeLists[SizeClassCount];
+    u64 UsedBlockCounts[SizeClassCount];
+};
+
+struct chunk_section
+{
+    u16 BitsPerIndex;
+    u16 PaletteCount;
+    u16 RunCount; // Non-zero if the section is compressed, Indices points to the runs then (see CompressChunkData)
+    u16 Palette[CHUNK_MAX_PALETTE_COUNT];
+    u64* Indices; // nullptr for uniform sections
+};
+
 struct chunk_data
+{
+    chunk_section_pool* Pool;
+    voxel_layout Layout; // Fixed for the lifetime of the chunk data
+    mutable ticket_mutex IndicesMutex; // Guards editing the sections against UnpackNonUniformChunkSection
+    chunk_section Sections[CHUNK_SECTION_COUNT];
+};
+
+// Unpacked voxels of a whole chunk, this is what the generator works on and what the chunk files store
+struct chunk_voxels
 {
     u16 Voxels[CHUNK_DIM_Z][CHUNK_DIM_XY][CHUNK_DIM_XY];
 };
 
+static void InitializeChunkSectionPool(chunk_section_pool* Pool, u64 Size, void* Base);
+// Bytes of index memory in use
+static u64 GetChunkSectionPoolUsedSize(const chunk_section_pool* Pool);
+
+// Index of a voxel inside the palette indices of a section, z is relative to the section
+inline u32 GetSectionVoxelIndex(voxel_layout Layout, s32 x, s32 y, s32 z);
+
+inline u16 GetVoxel(const chunk_data* Data, s32 x, s32 y, s32 z);
+static void SetVoxel(chunk_data* Data, s32 x, s32 y, s32 z, u16 Type);
+
+inline bool IsUniformSection(const chunk_section* Section);
+static void SetUniformSection(chunk_data* Data, u32 SectionIndex, u16 Type);
+static void PackChunkSection(chunk_data* Data, u32 SectionIndex, const u16* Voxels);
+// NOTE(boti): Leaves Voxels untouched and returns false with the type of the section if it's uniform
+static bool UnpackNonUniformChunkSection(const chunk_data* Data, u32 SectionIndex, u16* Voxels, u16* UniformType);
+static void UnpackChunkSection(const chunk_data* Data, u32 SectionIndex, u16* Voxels);
+static void PackChunkData(chunk_data* Data, const chunk_voxels* Voxels);
+static void UnpackChunkData(const chunk_data* Data, chunk_voxels* Voxels);
+
+// Returns all of the index memory to the pool, the chunk data is all air afterwards
+static void ResetChunkData(chunk_data* Data);
+
+// Bytes used by the chunk data, including its section indices (or runs, if it's compressed)
+static u64 GetChunkDataSize(const chunk_data* Data);
+// Bytes the chunk data would use if it wasn't compressed
+static u64 GetDenseChunkDataSize(const chunk_data* Data);
+
+// NOTE(boti): Compressed chunk data is for the chunks that nobody reads for a while (see the cold chunks in World.hpp).
+//             Each section's palette indices are run-length encoded in [z][y][x] (layout) order,
+//             a run is a u16 with the palette index in the top 4 bits and the length - 1 in the rest.
+//             The runs go into a block from a smaller size class than the indices, the sections that wouldn't fit are left alone.
+//             Nothing can read or write compressed data other than DecompressChunkData, GetChunkDataSize and ResetChunkData.
+//
+// Returns true if any of the sections got compressed
+static bool CompressChunkData(chunk_data* Data);
+static void DecompressChunkData(chunk_data* Data);
+static bool IsCompressedChunkData(const chunk_data* Data);
+
+// NOTE(boti): The generation level of a chunk is the next generation pass it needs,
+//             Level0 is the terrain (and structure placement) and Level1 is the decorations.
+//             Level1 needs all 26 neighbors to have finished Level0.
 enum chunk_gen_level : u32
 {
     ChunkGen_Level0 = 0,
     ChunkGen_Level1,
+    ChunkGen_Level2,
 
     ChunkGen_LevelCount,
     ChunkGen_LevelFinal = ChunkGen_LevelCount - 1,
 };
 
+// Structure (e.g. a tree) placed by the generator, P is the bottom center of the structure relative to the chunk.
+// P.z can be CHUNK_DIM_Z, i.e. the structure is rooted on the top of the chunk and starts in the one above it.
+struct structure_placement
+{
+    u32 StructureIndex;
+    vec3i P;
+};
+
 struct chunk 
 {
-    vec2i P;
+    vec3i P;
     u32 GenerationLevel;
+    b32 IsMeshed; // The mesh is up to date with the voxels unless IsMeshDirty, empty meshes have no vertex block
     b32 IsMeshDirty;
     b32 InGenerationQueue;
     b32 InMeshQueue;
 
     chunk_data* Data;
-
     struct vertex_buffer_block* VertexBlock;
+
+    // The 3x3x3 chunks around this one, [1][1][1] is the chunk itself. nullptr if they're not loaded.
+    // Kept up to date by the chunk table as the chunks get inserted and erased
+    chunk* Neighbors[3][3][3];
+
+    // Terrain height (in world z) of each column before caves are carved out, filled in by the generator.
+    // Every chunk of a column has the same heightmap.
+    s16 Heightmap[CHUNK_DIM_XY][CHUNK_DIM_XY];
+    // Biome of each column (index into the generator's noise graph), filled in by the generator
+    u8 Biomes[CHUNK_DIM_XY][CHUNK_DIM_XY];
+
+    // Highest non-air and lowest air voxel of each column (relative to the chunk): everything above HighestNonAirZ is air
+    // and nothing below LowestAirZ is. They're -1 and CHUNK_DIM_Z when the column has no non-air or no air voxels.
+    // Filled in by the generator, every later edit has to go through UpdateColumnBounds
+    s8 HighestNonAirZ[CHUNK_DIM_XY][CHUNK_DIM_XY];
+    s8 LowestAirZ[CHUNK_DIM_XY][CHUNK_DIM_XY];
+
+    // Bit x of row [z][y] is set if the voxel is opaque/solid (IsOpaqueVoxel/IsSolidVoxel),
+    // so that meshing, collision and ray casts can test a whole row with one instruction instead of looking up each voxel's desc.
+    // Filled in by the generator, every later edit has to go through UpdateVoxelMasks
+    u16 OpaqueMask[CHUNK_DIM_Z][CHUNK_DIM_XY];
+    u16 SolidMask[CHUNK_DIM_Z][CHUNK_DIM_XY];
+
+    // Structures rooted in this chunk, these are placed by the Level0 pass and written into the chunk data
+    // (and the neighbors' data) by the Level1 pass
+    static constexpr u32 MaxStructurePlacementCount = 8;
+    u32 StructurePlacementCount;
+    structure_placement StructurePlacements[MaxStructurePlacementCount];
+};
+
+// Updates the bounds of the column after the voxel at z was set to Type
+static void UpdateColumnBounds(chunk* Chunk, s32 x, s32 y, s32 z, u16 Type);
+// Updates the opaque and solid bits of the voxel after it was set to Type
+inline void UpdateVoxelMasks(chunk* Chunk, s32 x, s32 y, s32 z, u16 Type);
+
+// NOTE(boti): The chunk_datas of the loaded chunks, recycled through a free list.
+//             Only the main thread allocates and frees them, so there's no locking.
+//             Owners[i] is the chunk that Data[i] belongs to (nullptr if it's free),
+//             this is how the loaded chunks can be walked without going through the chunk table.
+struct chunk_data_pool
+{
+    u32 Capacity;
+    u32 FreeCount;
+    chunk_data* Data;
+    chunk** Owners;
+    u32* FreeIndices;
+};
+
+// Capacity all air chunk_datas with Layout that allocate their sections from SectionPool, returns false if the arena is too small
+static bool InitializeChunkDataPool(chunk_data_pool* Pool, u32 Capacity, voxel_layout Layout,
+                                    chunk_section_pool* SectionPool, memory_arena* Arena);
+// Returns all air chunk data owned by Owner, nullptr if the pool is empty
+static chunk_data* AllocateChunkData(chunk_data_pool* Pool, chunk* Owner);
+// Returns the section indices to the section pool and the data to the free list
+static void FreeChunkData(chunk_data_pool* Pool, chunk_data* Data);
+
+// NOTE(boti): Open addressing hash table from chunk position to chunk with SwissTable-style control bytes.
+//             Every slot has a control byte that's either empty, deleted (tombstone), or the low 7 bits of the hash,
+//             lookups compare the control bytes of a 16 slot group at once and only look at the chunks that match,
+//             probing group by group until a group with an empty slot.
+//
+//             Only the main thread uses the table, the workers get to the neighbors of their chunks through Chunk->Neighbors.
+//             Erasing leaves a tombstone unless the group has an empty slot already (then no probe can go past it),
+//             so that the probe sequences of the other chunks never get cut short.
+//             The tombstones are cleared by RehashChunkTable once they take up the space needed for inserting.
+struct chunk_table
+{
+    u32 Capacity; // Power of 2, at least one group
+    u32 MaxUsedCount; // Count + TombstoneCount limit, so that there are always empty slots to end the probes
+    u32 Count;
+    u32 TombstoneCount;
+    u8* Control;
+    chunk** Slots;
+    chunk** Scratch; // For rehashing
+};
+
+constexpr u32 CHUNK_TABLE_GROUP_SIZE = 16;
+constexpr u8 CHUNK_TABLE_EMPTY = 0x80;
+constexpr u8 CHUNK_TABLE_DELETED = 0xFE;
+
+// Capacity is rounded up to a power of 2, returns false if the arena is too small
+static bool InitializeChunkTable(chunk_table* Table, u32 Capacity, memory_arena* Arena);
+inline u32 HashChunkP(vec3i P);
+// Returns the chunk at chunk position P, nullptr if it's not in the table
+inline chunk* FindChunk(const chunk_table* Table, vec3i P);
+// Returns false if the table needs rehashing to make space, the chunk at Chunk->P must not be in the table already.
+// Links the chunk with its neighbors in the table
+static bool InsertChunk(chunk_table* Table, chunk* Chunk);
+// Unlinks the chunk from its neighbors
+static void EraseChunk(chunk_table* Table, chunk* Chunk);
+// Reinserts every chunk to clear the tombstones
+static void RehashChunkTable(chunk_table* Table);
+
+// NOTE(boti): Caches the chunk of the last access, so that the accesses in the same chunk or one of its 26 neighbors
+//             go through the chunk's neighbor pointers instead of hashing into the chunk table.
+//             Only the final chunks are read, everything else is air (same as GetVoxelTypeAt).
+//             The cached chunk is only valid until the next eviction, the accessors shouldn't be kept around across frames.
+struct voxel_accessor
+{
+    const chunk_table* Table;
+    chunk* Chunk; // nullptr if the chunk at ChunkP isn't loaded
+    vec3i ChunkP;
 };
 
+inline voxel_accessor MakeVoxelAccessor(const chunk_table* Table);
+// Returns the chunk of the voxel at P (nullptr if it's not loaded) and P relative to that chunk
+inline chunk* GetChunk(voxel_accessor* Accessor, vec3i P, vec3i* RelP);
+// The chunk data must not be compressed, the world's GetVoxelTypeAt decompresses it when it needs to
+inline u16 GetVoxelType(voxel_accessor* Accessor, vec3i P);
+
 struct voxel_neighborhood
 {
     u16 VoxelTypes[27];
@@ -148,10 +392,165 @@ struct chunk_mesh
     terrain_vertex* VertexData;
 };
 
-static void Generate(chunk* Chunk, world* World);
 static chunk_mesh BuildMesh(const chunk* Chunk, world* World, memory_arena* Arena);
 
 /* Implementations */
+inline bool IsOpaqueVoxel(u16 Type)
+{
+    u32 Flags = VoxelDescs[Type].Flags;
+    bool Result = !(Flags & VOXEL_FLAGS_NO_MESH) && !(Flags & VOXEL_FLAGS_TRANSPARENT);
+    return(Result);
+}
+
+inline bool IsSolidVoxel(u16 Type)
+{
+    bool Result = (VoxelDescs[Type].Flags & VOXEL_FLAGS_SOLID) != 0;
+    return(Result);
+}
+
+inline u32 HashChunkP(vec3i P)
+{
+    u32 x = (u32)FloorDiv(P.x, CHUNK_DIM_XY);
+    u32 y = (u32)FloorDiv(P.y, CHUNK_DIM_XY);
+    u32 z = (u32)FloorDiv(P.z, CHUNK_DIM_Z);
+
+    u32 Result = (x * 0x8DA6B343u) ^ (y * 0xD8163841u) ^ (z * 0xCB1AB31Fu);
+    Result ^= Result >> 16;
+    Result *= 0x7FEB352Du;
+    Result ^= Result >> 15;
+    Result *= 0x846CA68Bu;
+    Result ^= Result >> 16;
+    return(Result);
+}
+
+inline chunk* FindChunk(const chunk_table* Table, vec3i P)
+{
+    chunk* Result = nullptr;
+
+    u32 Hash = HashChunkP(P);
+    __m128i Tag = _mm_set1_epi8((char)(Hash & 0x7F));
+    __m128i Empty = _mm_set1_epi8((char)CHUNK_TABLE_EMPTY);
+    u32 Mask = Table->Capacity - 1;
+    for (u32 Group = (Hash >> 7) & Mask & ~(CHUNK_TABLE_GROUP_SIZE - 1); ; Group = (Group + CHUNK_TABLE_GROUP_SIZE) & Mask)
+    {
+        __m128i Control = _mm_loadu_si128((const __m128i*)(Table->Control + Group));
+        u32 Matches = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(Control, Tag));
+        u32 Index = 0;
+        while (BitScanForward(&Index, Matches))
+        {
+            chunk* Chunk = Table->Slots[Group + Index];
+            if (Chunk->P == P)
+            {
+                Result = Chunk;
+                break;
+            }
+            Matches &= Matches - 1;
+        }
+
+        if (Result || _mm_movemask_epi8(_mm_cmpeq_epi8(Control, Empty)))
+        {
+            break;
+        }
+    }
+    return(Result);
+}
+
+inline voxel_accessor MakeVoxelAccessor(const chunk_table* Table)
+{
+    voxel_accessor Result = {};
+    Result.Table = Table;
+    Result.Chunk = nullptr;
+    Result.ChunkP = { 1, 1, 1 }; // Not a chunk position, the first access always goes through the table
+    return(Result);
+}
+
+inline chunk* GetChunk(voxel_accessor* Accessor, vec3i P, vec3i* RelP)
+{
+    static_assert(((CHUNK_DIM_XY & (CHUNK_DIM_XY - 1)) == 0) && ((CHUNK_DIM_Z & (CHUNK_DIM_Z - 1)) == 0));
+
+    vec3i ChunkP = { P.x & ~(CHUNK_DIM_XY - 1), P.y & ~(CHUNK_DIM_XY - 1), P.z & ~(CHUNK_DIM_Z - 1) };
+    *RelP = P - ChunkP;
+    if (ChunkP != Accessor->ChunkP)
+    {
+        vec3i Delta = ChunkP - Accessor->ChunkP;
+        if (Accessor->Chunk && 
+            (Abs(Delta.x) <= CHUNK_DIM_XY) && (Abs(Delta.y) <= CHUNK_DIM_XY) && (Abs(Delta.z) <= CHUNK_DIM_Z))
+        {
+            Accessor->Chunk = Accessor->Chunk->Neighbors[Delta.z / CHUNK_DIM_Z + 1][Delta.y / CHUNK_DIM_XY + 1][Delta.x / CHUNK_DIM_XY + 1];
+        }
+        else
+        {
+            Accessor->Chunk = FindChunk(Accessor->Table, ChunkP);
+        }
+        Accessor->ChunkP = ChunkP;
+    }
+    return(Accessor->Chunk);
+}
+
+inline u16 GetVoxelType(voxel_accessor* Accessor, vec3i P)
+{
+    u16 Result = VOXEL_AIR;
+
+    vec3i RelP;
+    chunk* Chunk = GetChunk(Accessor, P, &RelP);
+    if (Chunk && (Chunk->GenerationLevel == ChunkGen_LevelFinal))
+    {
+        Result = GetVoxel(Chunk->Data, RelP.x, RelP.y, RelP.z);
+    }
+    return(Result);
+}
+
+inline void UpdateVoxelMasks(chunk* Chunk, s32 x, s32 y, s32 z, u16 Type)
+{
+    assert((0 <= x) && (x < CHUNK_DIM_XY) && (0 <= y) && (y < CHUNK_DIM_XY) && (0 <= z) && (z < CHUNK_DIM_Z));
+
+    u16 Bit = (u16)(1u << x);
+    Chunk->OpaqueMask[z][y] = IsOpaqueVoxel(Type) ? (Chunk->OpaqueMask[z][y] | Bit) : (Chunk->OpaqueMask[z][y] & ~Bit);
+    Chunk->SolidMask[z][y] = IsSolidVoxel(Type) ? (Chunk->SolidMask[z][y] | Bit) : (Chunk->SolidMask[z][y] & ~Bit);
+}
+
+inline bool IsUniformSection(const chunk_section* Section)
+{
+    bool Result = (Section->BitsPerIndex == 0);
+    return(Result);
+}
+
+inline u32 GetSectionVoxelIndex(voxel_layout Layout, s32 x, s32 y, s32 z)
+{
+    static_assert((CHUNK_DIM_XY == 16) && (CHUNK_SECTION_DIM == 16));
+
+    u32 Result = 0;
+    if (Layout == VoxelLayout_Brick)
+    {
+        u32 BrickIndex = (u32)((((z >> 2) << 4) | ((y >> 2) << 2) | (x >> 2)));
+        u32 VoxelIndex = (u32)((((z & 3) << 4) | ((y & 3) << 2) | (x & 3)));
+        Result = (BrickIndex << 6) | VoxelIndex;
+    }
+    else
+    {
+        Result = (u32)((z << 8) | (y << 4) | x);
+    }
+    return(Result);
+}
+
+inline u16 GetVoxel(const chunk_data* Data, s32 x, s32 y, s32 z)
+{
+    assert((0 <= x) && (x < CHUNK_DIM_XY) && (0 <= y) && (y < CHUNK_DIM_XY) && (0 <= z) && (z < CHUNK_DIM_Z));
+
+    const chunk_section* Section = Data->Sections + (z / CHUNK_SECTION_DIM);
+    assert(!Section->RunCount);
+    u32 PaletteIndex = 0;
+    if (!IsUniformSection(Section))
+    {
+        u32 Index = GetSectionVoxelIndex(Data->Layout, x, y, z % CHUNK_SECTION_DIM);
+        u32 Bit = Index * Section->BitsPerIndex;
+        u64 Mask = (1llu << Section->BitsPerIndex) - 1;
+        PaletteIndex = (u32)((Section->Indices[Bit / 64] >> (Bit % 64)) & Mask);
+    }
+    u16 Result = Section->Palette[PaletteIndex];
+    return(Result);
+}
+
 inline constexpr u32 CardinalOpposite(u32 Cardinal)
 {
     u32 Result = (u32)((Cardinal + 2) % Cardinal_Count);
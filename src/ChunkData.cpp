@@ -0,0 +1,755 @@
+#include "Chunk.hpp"
+
+static u32 GetBitsPerIndex(u32 PaletteCount)
+{
+    u32 Result = 0;
+    if (PaletteCount > 4)
+    {
+        Result = 4;
+    }
+    else if (PaletteCount > 2)
+    {
+        Result = 2;
+    }
+    else if (PaletteCount > 1)
+    {
+        Result = 1;
+    }
+    return(Result);
+}
+
+static u32 GetSectionSizeClass(u32 BitsPerIndex)
+{
+    u32 Result = 0;
+    switch (BitsPerIndex)
+    {
+        case 1: Result = 0; break;
+        case 2: Result = 1; break;
+        case 4: Result = 2; break;
+        default: assert(!"Invalid code path"); break;
+    }
+    return(Result);
+}
+
+static u64 GetSectionIndicesSize(u32 BitsPerIndex)
+{
+    u64 Result = (u64)BitsPerIndex * CHUNK_SECTION_VOXEL_COUNT / 8;
+    return(Result);
+}
+
+static void InitializeChunkSectionPool(chunk_section_pool* Pool, u64 Size, void* Base)
+{
+    *Pool = {};
+    Pool->Arena = InitializeArena(Size, Base);
+}
+
+static u64 GetChunkSectionPoolUsedSize(const chunk_section_pool* Pool)
+{
+    u64 Result = 0;
+    for (u32 SizeClass = 0; SizeClass < chunk_section_pool::SizeClassCount; SizeClass++)
+    {
+        Result += Pool->UsedBlockCounts[SizeClass] * GetSectionIndicesSize(1u << SizeClass);
+    }
+    return(Result);
+}
+
+static u64* AllocateSectionIndices(chunk_section_pool* Pool, u32 BitsPerIndex)
+{
+    assert(Pool);
+    u32 SizeClass = GetSectionSizeClass(BitsPerIndex);
+
+    BeginTicketMutex(&Pool->Mutex);
+    void* Result = Pool->FreeLists[SizeClass];
+    if (Result)
+    {
+        Pool->FreeLists[SizeClass] = *(void**)Result;
+    }
+    else
+    {
+        Result = PushSize(&Pool->Arena, GetSectionIndicesSize(BitsPerIndex));
+    }
+
+    if (Result)
+    {
+        Pool->UsedBlockCounts[SizeClass]++;
+    }
+    EndTicketMutex(&Pool->Mutex);
+
+    // NOTE(boti): The pool is sized for the worst case of every section being 4 bits wide
+    assert(Result);
+    return((u64*)Result);
+}
+
+static void FreeSectionIndices(chunk_section_pool* Pool, u32 BitsPerIndex, u64* Indices)
+{
+    assert(Pool);
+    assert(Indices);
+    u32 SizeClass = GetSectionSizeClass(BitsPerIndex);
+
+    BeginTicketMutex(&Pool->Mutex);
+    *(void**)Indices = Pool->FreeLists[SizeClass];
+    Pool->FreeLists[SizeClass] = Indices;
+    Pool->UsedBlockCounts[SizeClass]--;
+    EndTicketMutex(&Pool->Mutex);
+}
+
+// NOTE(boti): Writes every index, so the old indices don't need to be cleared first
+static void PackSectionIndices(u64* Indices, u32 BitsPerIndex, const u8* PaletteIndices)
+{
+    assert((BitsPerIndex == 1) || (BitsPerIndex == 2) || (BitsPerIndex == 4));
+
+    const u32 IndicesPerWord = 64 / BitsPerIndex;
+    const u32 WordCount = CHUNK_SECTION_VOXEL_COUNT / IndicesPerWord;
+    for (u32 WordIndex = 0; WordIndex < WordCount; WordIndex++)
+    {
+        const u8* At = PaletteIndices + WordIndex * IndicesPerWord;
+        u64 Word = 0;
+        for (u32 i = 0; i < IndicesPerWord; i++)
+        {
+            Word |= (u64)At[i] << (i * BitsPerIndex);
+        }
+        Indices[WordIndex] = Word;
+    }
+}
+
+static void UnpackSectionIndices(const chunk_section* Section, u8* PaletteIndices)
+{
+    assert(!Section->RunCount);
+    const u32 BitsPerIndex = Section->BitsPerIndex;
+    if (BitsPerIndex == 0)
+    {
+        memset(PaletteIndices, 0, CHUNK_SECTION_VOXEL_COUNT);
+    }
+    else
+    {
+        const u32 IndicesPerWord = 64 / BitsPerIndex;
+        const u32 WordCount = CHUNK_SECTION_VOXEL_COUNT / IndicesPerWord;
+        const u64 Mask = (1llu << BitsPerIndex) - 1;
+        for (u32 WordIndex = 0; WordIndex < WordCount; WordIndex++)
+        {
+            u8* At = PaletteIndices + WordIndex * IndicesPerWord;
+            u64 Word = Section->Indices[WordIndex];
+            for (u32 i = 0; i < IndicesPerWord; i++)
+            {
+                At[i] = (u8)((Word >> (i * BitsPerIndex)) & Mask);
+            }
+        }
+    }
+}
+
+// Changes the index width of the section and repacks its indices if it had any, Palette replaces the palette of the section
+static void ResizeSectionIndices(chunk_data* Data, chunk_section* Section, u32 NewBitsPerIndex, const u8* PaletteIndices,
+                                 const u16* Palette, u32 PaletteCount)
+{
+    assert(!Section->RunCount);
+
+    u64* OldIndices = Section->Indices;
+    u32 OldBitsPerIndex = Section->BitsPerIndex;
+
+    u64* NewIndices = Section->Indices;
+    if (NewBitsPerIndex != OldBitsPerIndex)
+    {
+        NewIndices = NewBitsPerIndex ? AllocateSectionIndices(Data->Pool, NewBitsPerIndex) : nullptr;
+    }
+    if (NewBitsPerIndex)
+    {
+        PackSectionIndices(NewIndices, NewBitsPerIndex, PaletteIndices);
+    }
+
+    // NOTE(boti): The width, the block and the palette are swapped together under the lock (see UnpackNonUniformChunkSection),
+    //             the old block can only be freed once no reader can be in the middle of decoding it
+    assert(PaletteCount <= CHUNK_MAX_PALETTE_COUNT);
+    BeginTicketMutex(&Data->IndicesMutex);
+    Section->BitsPerIndex = (u16)NewBitsPerIndex;
+    Section->Indices = NewIndices;
+    memcpy(Section->Palette, Palette, PaletteCount * sizeof(u16));
+    Section->PaletteCount = (u16)PaletteCount;
+    EndTicketMutex(&Data->IndicesMutex);
+    if (OldIndices && (OldIndices != NewIndices))
+    {
+        FreeSectionIndices(Data->Pool, OldBitsPerIndex, OldIndices);
+    }
+}
+
+static void SetVoxel(chunk_data* Data, s32 x, s32 y, s32 z, u16 Type)
+{
+    assert((0 <= x) && (x < CHUNK_DIM_XY) && (0 <= y) && (y < CHUNK_DIM_XY) && (0 <= z) && (z < CHUNK_DIM_Z));
+    assert(Type < VoxelDescCount);
+
+    if (GetVoxel(Data, x, y, z) == Type)
+    {
+        return;
+    }
+
+    chunk_section* Section = Data->Sections + (z / CHUNK_SECTION_DIM);
+
+    // NOTE(boti): The zero initialized section has an empty palette, but it's still all air
+    u16 Palette[CHUNK_MAX_PALETTE_COUNT];
+    u32 PaletteCount = Section->PaletteCount;
+    memcpy(Palette, Section->Palette, sizeof(Palette));
+    if (PaletteCount == 0)
+    {
+        static_assert(VOXEL_AIR == 0);
+        PaletteCount = 1;
+        Palette[0] = VOXEL_AIR;
+    }
+
+    u32 PaletteIndex = PaletteCount;
+    for (u32 i = 0; i < PaletteCount; i++)
+    {
+        if (Palette[i] == Type)
+        {
+            PaletteIndex = i;
+            break;
+        }
+    }
+
+    // NOTE(boti): The mesher can be reading the chunk on a worker while the game edits it on the main thread,
+    //             so the new palette entry is published before (or together with) the first index that refers to it,
+    //             and everything else is written under the lock too (see UnpackNonUniformChunkSection)
+    if (PaletteIndex == PaletteCount)
+    {
+        assert(PaletteCount < CHUNK_MAX_PALETTE_COUNT);
+        Palette[PaletteCount++] = Type;
+
+        u32 NewBitsPerIndex = GetBitsPerIndex(PaletteCount);
+        if (NewBitsPerIndex != Section->BitsPerIndex)
+        {
+            u8 PaletteIndices[CHUNK_SECTION_VOXEL_COUNT];
+            UnpackSectionIndices(Section, PaletteIndices);
+            ResizeSectionIndices(Data, Section, NewBitsPerIndex, PaletteIndices, Palette, PaletteCount);
+        }
+    }
+
+    BeginTicketMutex(&Data->IndicesMutex);
+    memcpy(Section->Palette, Palette, PaletteCount * sizeof(u16));
+    Section->PaletteCount = (u16)PaletteCount;
+
+    assert(!IsUniformSection(Section));
+    u32 Index = GetSectionVoxelIndex(Data->Layout, x, y, z % CHUNK_SECTION_DIM);
+    u32 Bit = Index * Section->BitsPerIndex;
+    u64 Mask = ((1llu << Section->BitsPerIndex) - 1) << (Bit % 64);
+    u64* Word = Section->Indices + Bit / 64;
+    *Word = (*Word & ~Mask) | ((u64)PaletteIndex << (Bit % 64));
+    EndTicketMutex(&Data->IndicesMutex);
+}
+
+static void SetUniformSection(chunk_data* Data, u32 SectionIndex, u16 Type)
+{
+    assert(SectionIndex < CHUNK_SECTION_COUNT);
+    chunk_section* Section = Data->Sections + SectionIndex;
+
+    ResizeSectionIndices(Data, Section, 0, nullptr, &Type, 1);
+}
+
+static void PackChunkSection(chunk_data* Data, u32 SectionIndex, const u16* Voxels)
+{
+    assert(SectionIndex < CHUNK_SECTION_COUNT);
+    chunk_section* Section = Data->Sections + SectionIndex;
+
+    // NOTE(boti): The palette is sorted by type, so the same voxels always pack to the same bytes
+    u32 TypeMask = 0;
+    for (u32 i = 0; i < CHUNK_SECTION_VOXEL_COUNT; i++)
+    {
+        assert(Voxels[i] < VoxelDescCount);
+        TypeMask |= 1u << Voxels[i];
+    }
+
+    u8 PaletteIndexFromType[VoxelDescCount] = {};
+    u16 Palette[CHUNK_MAX_PALETTE_COUNT];
+    u32 PaletteCount = 0;
+    for (u32 Type = 0; Type < VoxelDescCount; Type++)
+    {
+        if (TypeMask & (1u << Type))
+        {
+            PaletteIndexFromType[Type] = (u8)PaletteCount;
+            Palette[PaletteCount++] = (u16)Type;
+        }
+    }
+
+    u32 BitsPerIndex = GetBitsPerIndex(PaletteCount);
+    if (BitsPerIndex == 0)
+    {
+        ResizeSectionIndices(Data, Section, 0, nullptr, Palette, PaletteCount);
+    }
+    else
+    {
+        u8 PaletteIndices[CHUNK_SECTION_VOXEL_COUNT];
+        for (s32 z = 0; z < CHUNK_SECTION_DIM; z++)
+        {
+            for (s32 y = 0; y < CHUNK_DIM_XY; y++)
+            {
+                for (s32 x = 0; x < CHUNK_DIM_XY; x += 4)
+                {
+                    const u16* Src = Voxels + (z * CHUNK_DIM_XY + y) * CHUNK_DIM_XY + x;
+                    u8* Dst = PaletteIndices + GetSectionVoxelIndex(Data->Layout, x, y, z);
+                    for (u32 i = 0; i < 4; i++)
+                    {
+                        Dst[i] = PaletteIndexFromType[Src[i]];
+                    }
+                }
+            }
+        }
+        ResizeSectionIndices(Data, Section, BitsPerIndex, PaletteIndices, Palette, PaletteCount);
+    }
+}
+
+static bool UnpackNonUniformChunkSection(const chunk_data* Data, u32 SectionIndex, u16* Voxels, u16* UniformType)
+{
+    assert(SectionIndex < CHUNK_SECTION_COUNT);
+    const chunk_section* Section = Data->Sections + SectionIndex;
+
+    // NOTE(boti): The mesher unpacks the chunks on the workers while the game might be editing them on the main thread,
+    //             so the width, the indices and the palette are all copied out under the lock before decoding
+    bool IsUniform = false;
+    u16 Palette[CHUNK_MAX_PALETTE_COUNT];
+    u8 PaletteIndices[CHUNK_SECTION_VOXEL_COUNT];
+    BeginTicketMutex(&Data->IndicesMutex);
+    if (IsUniformSection(Section))
+    {
+        // NOTE(boti): Empty palette (zero initialized) is air
+        IsUniform = true;
+        *UniformType = Section->PaletteCount ? Section->Palette[0] : VOXEL_AIR;
+    }
+    else
+    {
+        memcpy(Palette, Section->Palette, Section->PaletteCount * sizeof(u16));
+        UnpackSectionIndices(Section, PaletteIndices);
+    }
+    EndTicketMutex(&Data->IndicesMutex);
+
+    if (!IsUniform)
+    {
+        for (s32 z = 0; z < CHUNK_SECTION_DIM; z++)
+        {
+            for (s32 y = 0; y < CHUNK_DIM_XY; y++)
+            {
+                for (s32 x = 0; x < CHUNK_DIM_XY; x += 4)
+                {
+                    const u8* Src = PaletteIndices + GetSectionVoxelIndex(Data->Layout, x, y, z);
+                    u16* Dst = Voxels + (z * CHUNK_DIM_XY + y) * CHUNK_DIM_XY + x;
+                    for (u32 i = 0; i < 4; i++)
+                    {
+                        Dst[i] = Palette[Src[i]];
+                    }
+                }
+            }
+        }
+    }
+    return(!IsUniform);
+}
+
+static void UnpackChunkSection(const chunk_data* Data, u32 SectionIndex, u16* Voxels)
+{
+    u16 UniformType;
+    if (!UnpackNonUniformChunkSection(Data, SectionIndex, Voxels, &UniformType))
+    {
+        for (u32 i = 0; i < CHUNK_SECTION_VOXEL_COUNT; i++)
+        {
+            Voxels[i] = UniformType;
+        }
+    }
+}
+
+static void PackChunkData(chunk_data* Data, const chunk_voxels* Voxels)
+{
+    for (u32 SectionIndex = 0; SectionIndex < CHUNK_SECTION_COUNT; SectionIndex++)
+    {
+        PackChunkSection(Data, SectionIndex, &Voxels->Voxels[SectionIndex * CHUNK_SECTION_DIM][0][0]);
+    }
+}
+
+static void UnpackChunkData(const chunk_data* Data, chunk_voxels* Voxels)
+{
+    for (u32 SectionIndex = 0; SectionIndex < CHUNK_SECTION_COUNT; SectionIndex++)
+    {
+        UnpackChunkSection(Data, SectionIndex, &Voxels->Voxels[SectionIndex * CHUNK_SECTION_DIM][0][0]);
+    }
+}
+
+// Index width of the smallest block that fits RunCount runs, can be wider than the widest index if they don't fit in any block
+static u32 GetRunBlockBitsPerIndex(u32 RunCount)
+{
+    u32 Result = 1;
+    while ((Result <= CHUNK_MAX_BITS_PER_INDEX) && (GetSectionIndicesSize(Result) < RunCount * sizeof(u16)))
+    {
+        Result *= 2;
+    }
+    return(Result);
+}
+
+static void ResetChunkData(chunk_data* Data)
+{
+    for (u32 SectionIndex = 0; SectionIndex < CHUNK_SECTION_COUNT; SectionIndex++)
+    {
+        // NOTE(boti): The runs of compressed sections are freed here, the rest goes through the regular path
+        chunk_section* Section = Data->Sections + SectionIndex;
+        if (Section->RunCount)
+        {
+            FreeSectionIndices(Data->Pool, GetRunBlockBitsPerIndex(Section->RunCount), Section->Indices);
+            Section->BitsPerIndex = 0;
+            Section->Indices = nullptr;
+            Section->RunCount = 0;
+        }
+        SetUniformSection(Data, SectionIndex, VOXEL_AIR);
+    }
+}
+
+static u64 GetChunkDataSize(const chunk_data* Data)
+{
+    u64 Result = sizeof(chunk_data);
+    for (u32 SectionIndex = 0; SectionIndex < CHUNK_SECTION_COUNT; SectionIndex++)
+    {
+        const chunk_section* Section = Data->Sections + SectionIndex;
+        u32 BlockBitsPerIndex = Section->RunCount ? GetRunBlockBitsPerIndex(Section->RunCount) : Section->BitsPerIndex;
+        Result += GetSectionIndicesSize(BlockBitsPerIndex);
+    }
+    return(Result);
+}
+
+static u64 GetDenseChunkDataSize(const chunk_data* Data)
+{
+    u64 Result = sizeof(chunk_data);
+    for (u32 SectionIndex = 0; SectionIndex < CHUNK_SECTION_COUNT; SectionIndex++)
+    {
+        Result += GetSectionIndicesSize(Data->Sections[SectionIndex].BitsPerIndex);
+    }
+    return(Result);
+}
+
+static bool CompressChunkData(chunk_data* Data)
+{
+    bool Result = false;
+    for (u32 SectionIndex = 0; SectionIndex < CHUNK_SECTION_COUNT; SectionIndex++)
+    {
+        chunk_section* Section = Data->Sections + SectionIndex;
+        if (IsUniformSection(Section) || Section->RunCount)
+        {
+            continue;
+        }
+
+        u8 PaletteIndices[CHUNK_SECTION_VOXEL_COUNT];
+        UnpackSectionIndices(Section, PaletteIndices);
+
+        static_assert(CHUNK_MAX_BITS_PER_INDEX <= 4 && CHUNK_SECTION_VOXEL_COUNT <= (1u << 12));
+        u16 Runs[CHUNK_SECTION_VOXEL_COUNT];
+        u32 RunCount = 0;
+        for (u32 i = 0; i < CHUNK_SECTION_VOXEL_COUNT; )
+        {
+            u32 Begin = i;
+            u8 PaletteIndex = PaletteIndices[i];
+            while ((i < CHUNK_SECTION_VOXEL_COUNT) && (PaletteIndices[i] == PaletteIndex))
+            {
+                i++;
+            }
+            Runs[RunCount++] = (u16)((PaletteIndex << 12) | (i - Begin - 1));
+        }
+
+        u32 BlockBitsPerIndex = GetRunBlockBitsPerIndex(RunCount);
+        if (BlockBitsPerIndex < Section->BitsPerIndex)
+        {
+            u64* Block = AllocateSectionIndices(Data->Pool, BlockBitsPerIndex);
+            memcpy(Block, Runs, RunCount * sizeof(u16));
+            FreeSectionIndices(Data->Pool, Section->BitsPerIndex, Section->Indices);
+            Section->Indices = Block;
+            Section->RunCount = (u16)RunCount;
+            Result = true;
+        }
+    }
+    return(Result);
+}
+
+static void DecompressChunkData(chunk_data* Data)
+{
+    for (u32 SectionIndex = 0; SectionIndex < CHUNK_SECTION_COUNT; SectionIndex++)
+    {
+        chunk_section* Section = Data->Sections + SectionIndex;
+        if (!Section->RunCount)
+        {
+            continue;
+        }
+
+        u8 PaletteIndices[CHUNK_SECTION_VOXEL_COUNT];
+        const u16* Runs = (const u16*)Section->Indices;
+        u32 At = 0;
+        for (u32 RunIndex = 0; RunIndex < Section->RunCount; RunIndex++)
+        {
+            u32 PaletteIndex = Runs[RunIndex] >> 12;
+            u32 Length = (Runs[RunIndex] & 0xFFFu) + 1;
+            assert(At + Length <= CHUNK_SECTION_VOXEL_COUNT);
+            memset(PaletteIndices + At, (int)PaletteIndex, Length);
+            At += Length;
+        }
+        assert(At == CHUNK_SECTION_VOXEL_COUNT);
+
+        u64* Indices = AllocateSectionIndices(Data->Pool, Section->BitsPerIndex);
+        PackSectionIndices(Indices, Section->BitsPerIndex, PaletteIndices);
+        FreeSectionIndices(Data->Pool, GetRunBlockBitsPerIndex(Section->RunCount), Section->Indices);
+        Section->Indices = Indices;
+        Section->RunCount = 0;
+    }
+}
+
+static bool IsCompressedChunkData(const chunk_data* Data)
+{
+    bool Result = false;
+    for (u32 SectionIndex = 0; SectionIndex < CHUNK_SECTION_COUNT; SectionIndex++)
+    {
+        Result |= (Data->Sections[SectionIndex].RunCount != 0);
+    }
+    return(Result);
+}
+
+static bool InitializeChunkDataPool(chunk_data_pool* Pool, u32 Capacity, voxel_layout Layout,
+                                    chunk_section_pool* SectionPool, memory_arena* Arena)
+{
+    *Pool = {};
+    Pool->Data = PushArray<chunk_data>(Arena, Capacity);
+    Pool->Owners = PushArray<chunk*>(Arena, Capacity);
+    Pool->FreeIndices = PushArray<u32>(Arena, Capacity);
+    if (!Pool->Data || !Pool->Owners || !Pool->FreeIndices)
+    {
+        return false;
+    }
+
+    Pool->Capacity = Capacity;
+    Pool->FreeCount = Capacity;
+    for (u32 i = 0; i < Capacity; i++)
+    {
+        Pool->Data[i] = {};
+        Pool->Data[i].Pool = SectionPool;
+        Pool->Data[i].Layout = Layout;
+        Pool->Owners[i] = nullptr;
+        // NOTE(boti): Reversed, so that the allocations go from the front of the arrays
+        Pool->FreeIndices[i] = Capacity - 1 - i;
+    }
+    return true;
+}
+
+static chunk_data* AllocateChunkData(chunk_data_pool* Pool, chunk* Owner)
+{
+    assert(Owner);
+
+    chunk_data* Result = nullptr;
+    if (Pool->FreeCount)
+    {
+        u32 Index = Pool->FreeIndices[--Pool->FreeCount];
+        assert(!Pool->Owners[Index]);
+        Pool->Owners[Index] = Owner;
+        Result = Pool->Data + Index;
+    }
+    return(Result);
+}
+
+static void FreeChunkData(chunk_data_pool* Pool, chunk_data* Data)
+{
+    assert((Data >= Pool->Data) && (Data < Pool->Data + Pool->Capacity));
+    u32 Index = (u32)(Data - Pool->Data);
+    assert(Pool->Owners[Index]);
+    assert(Pool->FreeCount < Pool->Capacity);
+
+    ResetChunkData(Data);
+    Pool->Owners[Index] = nullptr;
+    Pool->FreeIndices[Pool->FreeCount++] = Index;
+}
+
+static bool InitializeChunkTable(chunk_table* Table, u32 Capacity, memory_arena* Arena)
+{
+    *Table = {};
+
+    u32 RoundedCapacity = CHUNK_TABLE_GROUP_SIZE;
+    while (RoundedCapacity < Capacity)
+    {
+        RoundedCapacity *= 2;
+    }
+
+    Table->Control = PushArray<u8>(Arena, RoundedCapacity);
+    Table->Slots = PushArray<chunk*>(Arena, RoundedCapacity);
+    Table->Scratch = PushArray<chunk*>(Arena, RoundedCapacity);
+    if (!Table->Control || !Table->Slots || !Table->Scratch)
+    {
+        return false;
+    }
+
+    Table->Capacity = RoundedCapacity;
+    Table->MaxUsedCount = RoundedCapacity - RoundedCapacity / 8;
+    memset(Table->Control, CHUNK_TABLE_EMPTY, RoundedCapacity);
+    return true;
+}
+
+// Only puts the chunk into a slot, without touching the neighbors
+static bool InsertChunkIntoSlot(chunk_table* Table, chunk* Chunk)
+{
+    assert(!FindChunk(Table, Chunk->P));
+
+    u32 Hash = HashChunkP(Chunk->P);
+    u32 Mask = Table->Capacity - 1;
+    u32 Group = (Hash >> 7) & Mask & ~(CHUNK_TABLE_GROUP_SIZE - 1);
+    u32 Index = 0;
+    for (;;)
+    {
+        // NOTE(boti): Empty and deleted are the only control bytes with the top bit set
+        __m128i Control = _mm_loadu_si128((const __m128i*)(Table->Control + Group));
+        u32 Available = (u32)_mm_movemask_epi8(Control);
+        if (BitScanForward(&Index, Available))
+        {
+            break;
+        }
+        Group = (Group + CHUNK_TABLE_GROUP_SIZE) & Mask;
+    }
+
+    u32 SlotIndex = Group + Index;
+    bool Result = true;
+    if (Table->Control[SlotIndex] == CHUNK_TABLE_DELETED)
+    {
+        Table->TombstoneCount--;
+    }
+    else if (Table->Count + Table->TombstoneCount >= Table->MaxUsedCount)
+    {
+        Result = false;
+    }
+
+    if (Result)
+    {
+        Table->Slots[SlotIndex] = Chunk;
+        Table->Control[SlotIndex] = (u8)(Hash & 0x7F);
+        Table->Count++;
+    }
+    return(Result);
+}
+
+static bool InsertChunk(chunk_table* Table, chunk* Chunk)
+{
+    bool Result = InsertChunkIntoSlot(Table, Chunk);
+    if (Result)
+    {
+        for (s32 z = -1; z <= 1; z++)
+        {
+            for (s32 y = -1; y <= 1; y++)
+            {
+                for (s32 x = -1; x <= 1; x++)
+                {
+                    chunk* Neighbor = Chunk;
+                    if (x || y || z)
+                    {
+                        Neighbor = FindChunk(Table, Chunk->P + vec3i{ x, y, z } * CHUNK_DIM);
+                    }
+                    Chunk->Neighbors[z + 1][y + 1][x + 1] = Neighbor;
+                    if (Neighbor)
+                    {
+                        Neighbor->Neighbors[1 - z][1 - y][1 - x] = Chunk;
+                    }
+                }
+            }
+        }
+    }
+    return(Result);
+}
+
+static void EraseChunk(chunk_table* Table, chunk* Chunk)
+{
+    for (s32 z = -1; z <= 1; z++)
+    {
+        for (s32 y = -1; y <= 1; y++)
+        {
+            for (s32 x = -1; x <= 1; x++)
+            {
+                chunk* Neighbor = Chunk->Neighbors[z + 1][y + 1][x + 1];
+                if (Neighbor)
+                {
+                    assert(Neighbor->Neighbors[1 - z][1 - y][1 - x] == Chunk);
+                    Neighbor->Neighbors[1 - z][1 - y][1 - x] = nullptr;
+                }
+                Chunk->Neighbors[z + 1][y + 1][x + 1] = nullptr;
+            }
+        }
+    }
+
+    u32 Hash = HashChunkP(Chunk->P);
+    u32 Mask = Table->Capacity - 1;
+    for (u32 Group = (Hash >> 7) & Mask & ~(CHUNK_TABLE_GROUP_SIZE - 1); ; Group = (Group + CHUNK_TABLE_GROUP_SIZE) & Mask)
+    {
+        __m128i Control = _mm_loadu_si128((const __m128i*)(Table->Control + Group));
+        u32 Matches = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(Control, _mm_set1_epi8((char)(Hash & 0x7F))));
+        u32 Index = 0;
+        while (BitScanForward(&Index, Matches))
+        {
+            if (Table->Slots[Group + Index] == Chunk)
+            {
+                bool HasEmpty = _mm_movemask_epi8(_mm_cmpeq_epi8(Control, _mm_set1_epi8((char)CHUNK_TABLE_EMPTY))) != 0;
+                Table->Control[Group + Index] = HasEmpty ? CHUNK_TABLE_EMPTY : CHUNK_TABLE_DELETED;
+                if (!HasEmpty)
+                {
+                    Table->TombstoneCount++;
+                }
+                Table->Count--;
+                return;
+            }
+            Matches &= Matches - 1;
+        }
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(Control, _mm_set1_epi8((char)CHUNK_TABLE_EMPTY))))
+        {
+            assert(!"Erasing a chunk that isn't in the table");
+            break;
+        }
+    }
+}
+
+static void RehashChunkTable(chunk_table* Table)
+{
+    u32 Count = 0;
+    for (u32 i = 0; i < Table->Capacity; i++)
+    {
+        if (!(Table->Control[i] & 0x80))
+        {
+            Table->Scratch[Count++] = Table->Slots[i];
+        }
+    }
+    assert(Count == Table->Count);
+
+    memset(Table->Control, CHUNK_TABLE_EMPTY, Table->Capacity);
+    Table->Count = 0;
+    Table->TombstoneCount = 0;
+    for (u32 i = 0; i < Count; i++)
+    {
+        if (!InsertChunkIntoSlot(Table, Table->Scratch[i]))
+        {
+            assert(!"Chunk table is over capacity");
+        }
+    }
+}
+
+static void UpdateColumnBounds(chunk* Chunk, s32 x, s32 y, s32 z, u16 Type)
+{
+    assert((0 <= x) && (x < CHUNK_DIM_XY) && (0 <= y) && (y < CHUNK_DIM_XY) && (0 <= z) && (z < CHUNK_DIM_Z));
+
+    s8* HighestNonAirZ = &Chunk->HighestNonAirZ[y][x];
+    s8* LowestAirZ = &Chunk->LowestAirZ[y][x];
+    if (Type == VOXEL_AIR)
+    {
+        *LowestAirZ = (s8)Min((s32)*LowestAirZ, z);
+        if (z == *HighestNonAirZ)
+        {
+            s32 NewZ = z - 1;
+            while ((NewZ >= 0) && (GetVoxel(Chunk->Data, x, y, NewZ) == VOXEL_AIR))
+            {
+                NewZ--;
+            }
+            *HighestNonAirZ = (s8)NewZ;
+        }
+    }
+    else
+    {
+        *HighestNonAirZ = (s8)Max((s32)*HighestNonAirZ, z);
+        if (z == *LowestAirZ)
+        {
+            s32 NewZ = z + 1;
+            while ((NewZ < CHUNK_DIM_Z) && (GetVoxel(Chunk->Data, x, y, NewZ) != VOXEL_AIR))
+            {
+                NewZ++;
+            }
+            *LowestAirZ = (s8)NewZ;
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Common.hpp>
+#include <Math.hpp>
+#include <Chunk.hpp>
+
+//
+// Chunk file
+//
+// NOTE(boti): Pregenerated square of chunk columns, as written by pregen.exe:
+//
+//             chunk_file_header
+//             chunk_file_record[ChunkCountX * ChunkCountY]
+//
+//             The records are fixed size and stored in rows (x first) starting at MinP, one chunk apart,
+//             so any column can be read directly without an index.
+//             A record holds the chunks of a column in [0, CHUNK_FILE_DIM_Z), every one of them fully generated (ChunkGen_LevelFinal).
+//
+
+constexpr u32 CHUNK_FILE_MAGIC = 'KNHC';
+constexpr u32 CHUNK_FILE_VERSION = 1;
+
+constexpr s32 CHUNK_FILE_DIM_Z = 256;
+constexpr u32 CHUNK_FILE_COLUMN_CHUNK_COUNT = CHUNK_FILE_DIM_Z / CHUNK_DIM_Z;
+static_assert((CHUNK_FILE_DIM_Z % CHUNK_DIM_Z) == 0);
+
+struct chunk_file_header
+{
+    u32 Magic;
+    u32 Version;
+    u32 HeaderSize;
+    u32 RecordSize;
+
+    u32 Seed;
+    vec2i MinP; // Position (in voxels, like chunk::P) of the first record
+    u32 ChunkCountX;
+    u32 ChunkCountY;
+};
+
+struct chunk_file_record
+{
+    vec2i P;
+    u32 GenerationLevel;
+    u32 Reserved;
+    s16 Heightmap[CHUNK_DIM_XY][CHUNK_DIM_XY];
+    u16 Voxels[CHUNK_FILE_DIM_Z][CHUNK_DIM_XY][CHUNK_DIM_XY];
+};
+
+inline u64 GetChunkFileRecordOffset(const chunk_file_header* Header, u32 ChunkX, u32 ChunkY)
+{
+    assert(ChunkX < Header->ChunkCountX && ChunkY < Header->ChunkCountY);
+    u64 Result = Header->HeaderSize + ((u64)ChunkX + (u64)ChunkY * Header->ChunkCountX) * Header->RecordSize;
+    return(Result);
+}
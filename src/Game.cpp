@@ -5,9 +5,13 @@
 
 #include "Common.cpp"
 #include "Random.cpp"
+#include "Kernels.cpp"
 #include "Audio.cpp"
 #include "Camera.cpp"
+#include "ChunkData.cpp"
 #include "Chunk.cpp"
+#include "NoiseGraph.cpp"
+#include "WorldGen.cpp"
 #include "Shapes.cpp"
 #include "Profiler.cpp"
 
@@ -169,6 +173,28 @@ static void DoDebugUI(game_state* Game, game_io* IO, render_frame* Frame)
                         Game->TransientArenaMaxUsed >> 20,
                         Game->TransientArena.Size >> 20,
                         100.0 * ((f64)Game->TransientArenaMaxUsed / (f64)Game->TransientArena.Size));
+            ImGui::Text("Chunk sections: %lluMB / %lluMB (%.1f%%)\n",
+                        GetChunkSectionPoolUsedSize(&Game->World->SectionPool) >> 20,
+                        Game->World->SectionPool.Arena.Size >> 20,
+                        100.0 * ((f64)GetChunkSectionPoolUsedSize(&Game->World->SectionPool) / (f64)Game->World->SectionPool.Arena.Size));
+            {
+                const chunk_data_pool* Pool = &Game->World->ChunkDataPool;
+                u32 LoadedCount = Pool->Capacity - Pool->FreeCount;
+                ImGui::Text("Loaded chunks: %u / %u (%.1f%%)\n",
+                            LoadedCount, Pool->Capacity, 100.0 * ((f64)LoadedCount / (f64)Pool->Capacity));
+
+                const chunk_table* Table = &Game->World->ChunkTable;
+                ImGui::Text("Chunk table: %u / %u, %u tombstones\n", Table->Count, Table->Capacity, Table->TombstoneCount);
+
+                const auto* Cold = &Game->World->ColdChunks;
+                ImGui::Text("Compressed chunks: %u, %lluKB -> %lluKB (%.2fx)\n",
+                            Cold->ChunkCount, Cold->DenseSize >> 10, Cold->CompressedSize >> 10,
+                            Cold->CompressedSize ? (f64)Cold->DenseSize / (f64)Cold->CompressedSize : 0.0);
+                ImGui::Text("Decompress: %u, avg %.2fus, max %.2fus\n",
+                            Cold->DecompressCount,
+                            Cold->DecompressCount ? 1e6 * Cold->TotalDecompressTime / Cold->DecompressCount : 0.0,
+                            1e6 * Cold->MaxDecompressTime);
+            }
 #if 0
             ImGui::Text("RenderTarget: %lluMB / %lluMB (%.1f%%)\n",
                         Game->Renderer->RTHeap.HeapOffset >> 20,
@@ -382,6 +408,9 @@ static bool InitializeTextures(memory_arena* Arena, renderer_init_info* Renderer
         "texture/trunk_side.bmp",
         "texture/trunk_top.bmp",
         "texture/leaves_side.bmp",
+        "texture/sand_side.bmp",
+        "texture/snow_side.bmp",
+        "texture/snow_top.bmp",
     };
     constexpr u32 TextureCount = CountOf(TexturePaths);
 
@@ -7,6 +7,7 @@
 #include <Shapes.hpp>
 
 #include <Platform.hpp>
+#include <Kernels.hpp>
 #include <Renderer/RenderAPI.hpp>
 #include <Audio.hpp>
 #include <World.hpp>
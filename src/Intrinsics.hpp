@@ -16,6 +16,21 @@
 
 #include <Common.hpp>
 
+// NOTE(boti): Functions that use instructions above the SSE2 baseline of x64 (which is what everything is built for),
+//             they must only be called after checking the CPU level (CPUFeatures.hpp).
+//             MSVC lets any intrinsic through regardless of -arch, clang needs to be told per function.
+#if COMPILER_MSVC
+#define TARGET_XSAVE
+#define TARGET_SSE41
+#define TARGET_AVX2
+#define TARGET_AVX512
+#elif COMPILER_CLANG
+#define TARGET_XSAVE __attribute__((target("xsave")))
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl")))
+#endif
+
 //
 // Common
 //
@@ -0,0 +1,888 @@
+#include "Kernels.hpp"
+
+// NOTE(boti): Must match the domain transform in SampleOctave
+constexpr f32 OctaveRotationC = 84.0f / 85.0f;
+constexpr f32 OctaveRotationS = 13.0f / 85.0f;
+
+//
+// Scalar
+//
+
+template<typename noise_t>
+static void SampleOctave2_Scalar(const noise_t* Noise, u32 Count, const f32* X, const f32* Y,
+                                 u32 OctaveCount, f32 Persistence, f32 Lacunarity, f32* Out)
+{
+    for (u32 i = 0; i < Count; i++)
+    {
+        Out[i] = SampleOctave(Noise, vec2{ X[i], Y[i] }, OctaveCount, Persistence, Lacunarity);
+    }
+}
+
+static void FindBuriedVoxels_Layer(u32 LayerCount, const u16* Opaque, u16* Buried, u32 Layer)
+{
+    const u16* Below = (Layer > 0) ? Opaque + (Layer - 1) * 16 : nullptr;
+    const u16* Above = (Layer + 1 < LayerCount) ? Opaque + (Layer + 1) * 16 : nullptr;
+    const u16* Rows = Opaque + Layer * 16;
+    for (u32 y = 0; y < 16; y++)
+    {
+        u32 Row = Rows[y];
+        u32 Result = Row & (Row << 1) & (Row >> 1);
+        Result &= (y > 0) ? Rows[y - 1] : 0u;
+        Result &= (y < 15) ? Rows[y + 1] : 0u;
+        Result &= Below ? Below[y] : 0u;
+        Result &= Above ? Above[y] : 0u;
+        Buried[Layer * 16 + y] = (u16)Result;
+    }
+}
+
+static void FindBuriedVoxels_Scalar(u32 LayerCount, const u16* Opaque, u16* Buried)
+{
+    for (u32 Layer = 0; Layer < LayerCount; Layer++)
+    {
+        FindBuriedVoxels_Layer(LayerCount, Opaque, Buried, Layer);
+    }
+}
+
+// NOTE(boti): Same math as IntersectFrustumAABB, the effective radii only depend on the extent so they're computed once
+struct frustum_radii
+{
+    f32 R[6];
+};
+
+static frustum_radii GetFrustumRadii(const frustum* Frustum, vec3 HalfExtent)
+{
+    frustum_radii Result;
+    for (u32 i = 0; i < 6; i++)
+    {
+        Result.R[i] =
+            Abs(Frustum->Planes[i].x * HalfExtent.x) +
+            Abs(Frustum->Planes[i].y * HalfExtent.y) +
+            Abs(Frustum->Planes[i].z * HalfExtent.z);
+    }
+    return(Result);
+}
+
+static u8 CullBox_Scalar(const frustum* Frustum, const frustum_radii* Radii, vec4 CenterP)
+{
+    u8 Result = 1;
+    for (u32 i = 0; i < 6; i++)
+    {
+        if (Dot(CenterP, Frustum->Planes[i]) < -Radii->R[i])
+        {
+            Result = 0;
+            break;
+        }
+    }
+    return(Result);
+}
+
+static void CullBoxes_Scalar(const frustum* Frustum, vec3 HalfExtent, u32 Count,
+                             const f32* CenterX, const f32* CenterY, const f32* CenterZ, u8* Visible)
+{
+    frustum_radii Radii = GetFrustumRadii(Frustum, HalfExtent);
+    for (u32 i = 0; i < Count; i++)
+    {
+        Visible[i] = CullBox_Scalar(Frustum, &Radii, vec4{ CenterX[i], CenterY[i], CenterZ[i], 1.0f });
+    }
+}
+
+static void MixMono_Scalar(audio_sample* Dst, const s16* Src, u32 Count, f32 Volume)
+{
+    for (u32 i = 0; i < Count; i++)
+    {
+        f32 Sample = Src[i] / 32768.0f;
+        Dst[i].Left += Volume * Sample;
+        Dst[i].Right += Volume * Sample;
+    }
+}
+
+//
+// SSE4.1
+//
+// NOTE(boti): There are no gathers below AVX2, the permutation table lookups are done one lane at a time.
+//
+
+TARGET_SSE41 static inline __m128 Lerp4(__m128 a, __m128 b, __m128 t)
+{
+    __m128 Result = _mm_add_ps(
+        _mm_mul_ps(a, _mm_sub_ps(_mm_set1_ps(1.0f), t)),
+        _mm_mul_ps(b, t));
+    return Result;
+}
+
+TARGET_SSE41 static inline __m128 Fade5_4(__m128 t)
+{
+    __m128 Result = _mm_mul_ps(_mm_set1_ps(6.0f), t);
+    Result = _mm_sub_ps(Result, _mm_set1_ps(15.0f));
+    Result = _mm_mul_ps(Result, t);
+    Result = _mm_add_ps(Result, _mm_set1_ps(10.0f));
+    Result = _mm_mul_ps(Result, t);
+    Result = _mm_mul_ps(Result, t);
+    Result = _mm_mul_ps(Result, t);
+    return Result;
+}
+
+TARGET_SSE41 static inline __m128 HashBitToSign4(__m128i Hash, int Bit)
+{
+    __m128 Result = _mm_castsi128_ps(_mm_slli_epi32(Hash, 31 - Bit));
+    return Result;
+}
+
+TARGET_SSE41 static inline __m128 SignMask4(__m128i Hash, int Bit)
+{
+    __m128 Result = _mm_and_ps(HashBitToSign4(Hash, Bit), _mm_castsi128_ps(_mm_set1_epi32((s32)0x80000000u)));
+    return Result;
+}
+
+TARGET_SSE41 static inline __m128 Gradient2_4(__m128i Hash, __m128 X, __m128 Y)
+{
+    __m128 Sum = _mm_add_ps(
+        _mm_xor_ps(X, SignMask4(Hash, 0)),
+        _mm_xor_ps(Y, SignMask4(Hash, 1)));
+
+    __m128 Single = _mm_blendv_ps(Y, X, HashBitToSign4(Hash, 1));
+    Single = _mm_xor_ps(Single, SignMask4(Hash, 0));
+
+    __m128 Result = _mm_blendv_ps(Sum, Single, HashBitToSign4(Hash, 2));
+    return Result;
+}
+
+TARGET_SSE41 static inline __m128i Gather4(const u32* Table, __m128i Index)
+{
+    __m128i Result = _mm_setr_epi32(
+        (s32)Table[_mm_extract_epi32(Index, 0)],
+        (s32)Table[_mm_extract_epi32(Index, 1)],
+        (s32)Table[_mm_extract_epi32(Index, 2)],
+        (s32)Table[_mm_extract_epi32(Index, 3)]);
+    return Result;
+}
+
+TARGET_SSE41 static __m128 SampleNoise4(const perlin2* Perlin, __m128 X, __m128 Y)
+{
+    __m128 LatticeX = _mm_floor_ps(X);
+    __m128 LatticeY = _mm_floor_ps(Y);
+    __m128 X0 = _mm_sub_ps(X, LatticeX);
+    __m128 Y0 = _mm_sub_ps(Y, LatticeY);
+    __m128 X1 = _mm_sub_ps(X0, _mm_set1_ps(1.0f));
+    __m128 Y1 = _mm_sub_ps(Y0, _mm_set1_ps(1.0f));
+    __m128i Xi = _mm_cvttps_epi32(LatticeX);
+    __m128i Yi = _mm_cvttps_epi32(LatticeY);
+
+    const __m128i One = _mm_set1_epi32(1);
+    const __m128i Mask = _mm_set1_epi32(perlin2::TableCount - 1);
+    const u32* Table = Perlin->Permutation;
+
+    __m128i IndexX0 = _mm_and_si128(Xi, Mask);
+    __m128i IndexX1 = _mm_and_si128(_mm_add_epi32(Xi, One), Mask);
+    __m128i IndexY0 = Gather4(Table, _mm_and_si128(Yi, Mask));
+    __m128i IndexY1 = Gather4(Table, _mm_and_si128(_mm_add_epi32(Yi, One), Mask));
+
+    __m128i Hash00 = Gather4(Table, _mm_and_si128(_mm_add_epi32(IndexX0, IndexY0), Mask));
+    __m128i Hash10 = Gather4(Table, _mm_and_si128(_mm_add_epi32(IndexX1, IndexY0), Mask));
+    __m128i Hash01 = Gather4(Table, _mm_and_si128(_mm_add_epi32(IndexX0, IndexY1), Mask));
+    __m128i Hash11 = Gather4(Table, _mm_and_si128(_mm_add_epi32(IndexX1, IndexY1), Mask));
+
+    __m128 GdotV00 = Gradient2_4(Hash00, X0, Y0);
+    __m128 GdotV10 = Gradient2_4(Hash10, X1, Y0);
+    __m128 GdotV01 = Gradient2_4(Hash01, X0, Y1);
+    __m128 GdotV11 = Gradient2_4(Hash11, X1, Y1);
+
+    __m128 FactorX = Fade5_4(X0);
+    __m128 FactorY = Fade5_4(Y0);
+
+    __m128 Result = Lerp4(
+        Lerp4(GdotV00, GdotV10, FactorX),
+        Lerp4(GdotV01, GdotV11, FactorX),
+        FactorY);
+    return Result;
+}
+
+TARGET_SSE41 static inline __m128i HashNoise_Finalize4(__m128i Hash)
+{
+    Hash = _mm_xor_si128(Hash, _mm_srli_epi32(Hash, 16));
+    Hash = _mm_mullo_epi32(Hash, _mm_set1_epi32((s32)0x7FEB352Du));
+    Hash = _mm_xor_si128(Hash, _mm_srli_epi32(Hash, 15));
+    Hash = _mm_mullo_epi32(Hash, _mm_set1_epi32((s32)0x846CA68Bu));
+    Hash = _mm_xor_si128(Hash, _mm_srli_epi32(Hash, 16));
+    return Hash;
+}
+
+TARGET_SSE41 static __m128 SampleNoise4(const hash_noise* Noise, __m128 X, __m128 Y)
+{
+    __m128 LatticeX = _mm_floor_ps(X);
+    __m128 LatticeY = _mm_floor_ps(Y);
+
+    __m128 Vx[2], Vy[2];
+    Vx[0] = _mm_sub_ps(X, LatticeX);
+    Vy[0] = _mm_sub_ps(Y, LatticeY);
+    Vx[1] = _mm_sub_ps(Vx[0], _mm_set1_ps(1.0f));
+    Vy[1] = _mm_sub_ps(Vy[0], _mm_set1_ps(1.0f));
+
+    const __m128i PrimeX = _mm_set1_epi32((s32)HashNoise_PrimeX);
+    const __m128i PrimeY = _mm_set1_epi32((s32)HashNoise_PrimeY);
+    __m128i PrimedX[2], PrimedY[2];
+    PrimedX[0] = _mm_mullo_epi32(_mm_cvttps_epi32(LatticeX), PrimeX);
+    PrimedY[0] = _mm_mullo_epi32(_mm_cvttps_epi32(LatticeY), PrimeY);
+    PrimedX[1] = _mm_add_epi32(PrimedX[0], PrimeX);
+    PrimedY[1] = _mm_add_epi32(PrimedY[0], PrimeY);
+    PrimedX[0] = _mm_xor_si128(PrimedX[0], _mm_set1_epi32((s32)Noise->Seed));
+    PrimedX[1] = _mm_xor_si128(PrimedX[1], _mm_set1_epi32((s32)Noise->Seed));
+
+    __m128 GdotV[2][2];
+    for (u32 y = 0; y < 2; y++)
+    {
+        for (u32 x = 0; x < 2; x++)
+        {
+            __m128i Hash = HashNoise_Finalize4(_mm_xor_si128(PrimedX[x], PrimedY[y]));
+            GdotV[x][y] = Gradient2_4(Hash, Vx[x], Vy[y]);
+        }
+    }
+
+    __m128 FactorX = Fade5_4(Vx[0]);
+    __m128 FactorY = Fade5_4(Vy[0]);
+
+    __m128 Result = Lerp4(
+        Lerp4(GdotV[0][0], GdotV[1][0], FactorX),
+        Lerp4(GdotV[0][1], GdotV[1][1], FactorX),
+        FactorY);
+    return Result;
+}
+
+template<typename noise_t>
+TARGET_SSE41 static void SampleOctave2_SSE41(const noise_t* Noise, u32 Count, const f32* X, const f32* Y,
+                                             u32 OctaveCount, f32 Persistence, f32 Lacunarity, f32* Out)
+{
+    const __m128 C4 = _mm_set1_ps(OctaveRotationC);
+    const __m128 S4 = _mm_set1_ps(OctaveRotationS);
+    const __m128 NegS4 = _mm_set1_ps(-OctaveRotationS);
+
+    u32 i = 0;
+    for (; i + 4 <= Count; i += 4)
+    {
+        __m128 X4 = _mm_loadu_ps(X + i);
+        __m128 Y4 = _mm_loadu_ps(Y + i);
+
+        __m128 Result = _mm_setzero_ps();
+        f32 Amplitude = 1.0f;
+        f32 Frequency = 1.0f;
+        for (u32 Octave = 0; Octave < OctaveCount; Octave++)
+        {
+            __m128 Frequency4 = _mm_set1_ps(Frequency);
+            __m128 Sample = SampleNoise4(Noise, _mm_mul_ps(Frequency4, X4), _mm_mul_ps(Frequency4, Y4));
+            Result = _mm_add_ps(Result, _mm_mul_ps(_mm_set1_ps(Amplitude), Sample));
+
+            Frequency *= Lacunarity;
+            Amplitude *= Persistence;
+
+            __m128 NewX = _mm_add_ps(_mm_mul_ps(C4, X4), _mm_mul_ps(S4, Y4));
+            __m128 NewY = _mm_add_ps(_mm_mul_ps(NegS4, X4), _mm_mul_ps(C4, Y4));
+            X4 = NewX;
+            Y4 = NewY;
+        }
+        _mm_storeu_ps(Out + i, Result);
+    }
+    SampleOctave2_Scalar(Noise, Count - i, X + i, Y + i, OctaveCount, Persistence, Lacunarity, Out + i);
+}
+
+TARGET_SSE41 static void FindBuriedVoxels_SSE41(u32 LayerCount, const u16* Opaque, u16* Buried)
+{
+    const __m128i Zero = _mm_setzero_si128();
+    for (u32 Layer = 0; Layer < LayerCount; Layer++)
+    {
+        const __m128i* Rows = (const __m128i*)(Opaque + Layer * 16);
+        __m128i Lo = _mm_loadu_si128(Rows + 0); // y = [0, 7]
+        __m128i Hi = _mm_loadu_si128(Rows + 1); // y = [8, 15]
+
+        __m128i ResultLo = _mm_and_si128(Lo, _mm_and_si128(_mm_slli_epi16(Lo, 1), _mm_srli_epi16(Lo, 1)));
+        __m128i ResultHi = _mm_and_si128(Hi, _mm_and_si128(_mm_slli_epi16(Hi, 1), _mm_srli_epi16(Hi, 1)));
+
+        // y - 1
+        ResultLo = _mm_and_si128(ResultLo, _mm_slli_si128(Lo, 2));
+        ResultHi = _mm_and_si128(ResultHi, _mm_alignr_epi8(Hi, Lo, 14));
+        // y + 1
+        ResultLo = _mm_and_si128(ResultLo, _mm_alignr_epi8(Hi, Lo, 2));
+        ResultHi = _mm_and_si128(ResultHi, _mm_srli_si128(Hi, 2));
+
+        // z - 1, z + 1
+        const __m128i* Below = Rows - 2;
+        const __m128i* Above = Rows + 2;
+        ResultLo = _mm_and_si128(ResultLo, (Layer > 0) ? _mm_loadu_si128(Below + 0) : Zero);
+        ResultHi = _mm_and_si128(ResultHi, (Layer > 0) ? _mm_loadu_si128(Below + 1) : Zero);
+        ResultLo = _mm_and_si128(ResultLo, (Layer + 1 < LayerCount) ? _mm_loadu_si128(Above + 0) : Zero);
+        ResultHi = _mm_and_si128(ResultHi, (Layer + 1 < LayerCount) ? _mm_loadu_si128(Above + 1) : Zero);
+
+        _mm_storeu_si128((__m128i*)(Buried + Layer * 16) + 0, ResultLo);
+        _mm_storeu_si128((__m128i*)(Buried + Layer * 16) + 1, ResultHi);
+    }
+}
+
+TARGET_SSE41 static void CullBoxes_SSE41(const frustum* Frustum, vec3 HalfExtent, u32 Count,
+                                         const f32* CenterX, const f32* CenterY, const f32* CenterZ, u8* Visible)
+{
+    frustum_radii Radii = GetFrustumRadii(Frustum, HalfExtent);
+
+    u32 i = 0;
+    for (; i + 4 <= Count; i += 4)
+    {
+        __m128 X = _mm_loadu_ps(CenterX + i);
+        __m128 Y = _mm_loadu_ps(CenterY + i);
+        __m128 Z = _mm_loadu_ps(CenterZ + i);
+
+        __m128 Outside = _mm_setzero_ps();
+        for (u32 Plane = 0; Plane < 6; Plane++)
+        {
+            vec4 P = Frustum->Planes[Plane];
+            __m128 Distance = _mm_add_ps(_mm_mul_ps(X, _mm_set1_ps(P.x)), _mm_mul_ps(Y, _mm_set1_ps(P.y)));
+            Distance = _mm_add_ps(Distance, _mm_mul_ps(Z, _mm_set1_ps(P.z)));
+            Distance = _mm_add_ps(Distance, _mm_set1_ps(P.w));
+            Outside = _mm_or_ps(Outside, _mm_cmplt_ps(Distance, _mm_set1_ps(-Radii.R[Plane])));
+        }
+
+        u32 OutsideMask = (u32)_mm_movemask_ps(Outside);
+        for (u32 Lane = 0; Lane < 4; Lane++)
+        {
+            Visible[i + Lane] = (OutsideMask & (1u << Lane)) ? 0 : 1;
+        }
+    }
+    for (; i < Count; i++)
+    {
+        Visible[i] = CullBox_Scalar(Frustum, &Radii, vec4{ CenterX[i], CenterY[i], CenterZ[i], 1.0f });
+    }
+}
+
+// NOTE(boti): Multiplying by 1/32768 instead of dividing gives the same bits, the scale is a power of 2
+TARGET_SSE41 static void MixMono_SSE41(audio_sample* Dst, const s16* Src, u32 Count, f32 Volume)
+{
+    const __m128 Scale = _mm_set1_ps(1.0f / 32768.0f);
+    const __m128 Volume4 = _mm_set1_ps(Volume);
+
+    u32 i = 0;
+    for (; i + 4 <= Count; i += 4)
+    {
+        __m128i Samples16 = _mm_loadl_epi64((const __m128i*)(Src + i));
+        __m128 Sample = _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepi16_epi32(Samples16)), Scale);
+        Sample = _mm_mul_ps(Volume4, Sample);
+
+        f32* Out = (f32*)(Dst + i);
+        _mm_storeu_ps(Out + 0, _mm_add_ps(_mm_loadu_ps(Out + 0), _mm_unpacklo_ps(Sample, Sample)));
+        _mm_storeu_ps(Out + 4, _mm_add_ps(_mm_loadu_ps(Out + 4), _mm_unpackhi_ps(Sample, Sample)));
+    }
+    MixMono_Scalar(Dst + i, Src + i, Count - i, Volume);
+}
+
+//
+// AVX2
+//
+// NOTE(boti): The noise uses the 8-wide functions from Random.cpp
+//
+
+template<u32 OctaveCount, typename noise_t>
+TARGET_AVX2 static void SampleOctave2_AVX2(const noise_t* Noise, u32 Count, const f32* X, const f32* Y, f32* Out)
+{
+    u32 i = 0;
+    for (; i + 8 <= Count; i += 8)
+    {
+        __m256 Result = SampleOctave8<OctaveCount>(Noise, _mm256_loadu_ps(X + i), _mm256_loadu_ps(Y + i));
+        _mm256_storeu_ps(Out + i, Result);
+    }
+    for (; i < Count; i++)
+    {
+        Out[i] = SampleOctave<OctaveCount>(Noise, vec2{ X[i], Y[i] });
+    }
+}
+
+template<typename noise_t>
+TARGET_AVX2 static void SampleOctave2_AVX2(const noise_t* Noise, u32 Count, const f32* X, const f32* Y,
+                                           u32 OctaveCount, f32 Persistence, f32 Lacunarity, f32* Out)
+{
+    // NOTE(boti): Same dispatch as the noise ops in WorldGen
+    switch (GetSpecializedOctaveCount(OctaveCount, Persistence, Lacunarity))
+    {
+        case 1: SampleOctave2_AVX2<1>(Noise, Count, X, Y, Out); return;
+        case 2: SampleOctave2_AVX2<2>(Noise, Count, X, Y, Out); return;
+        case 3: SampleOctave2_AVX2<3>(Noise, Count, X, Y, Out); return;
+        case 4: SampleOctave2_AVX2<4>(Noise, Count, X, Y, Out); return;
+        case 5: SampleOctave2_AVX2<5>(Noise, Count, X, Y, Out); return;
+        case 6: SampleOctave2_AVX2<6>(Noise, Count, X, Y, Out); return;
+        case 7: SampleOctave2_AVX2<7>(Noise, Count, X, Y, Out); return;
+        case 8: SampleOctave2_AVX2<8>(Noise, Count, X, Y, Out); return;
+    }
+
+    u32 i = 0;
+    for (; i + 8 <= Count; i += 8)
+    {
+        __m256 Result = SampleOctave8(Noise, _mm256_loadu_ps(X + i), _mm256_loadu_ps(Y + i), OctaveCount, Persistence, Lacunarity);
+        _mm256_storeu_ps(Out + i, Result);
+    }
+    SampleOctave2_Scalar(Noise, Count - i, X + i, Y + i, OctaveCount, Persistence, Lacunarity, Out + i);
+}
+
+TARGET_AVX2 static void FindBuriedVoxels_AVX2(u32 LayerCount, const u16* Opaque, u16* Buried)
+{
+    const __m256i Zero = _mm256_setzero_si256();
+    for (u32 Layer = 0; Layer < LayerCount; Layer++)
+    {
+        const __m256i* Rows = (const __m256i*)(Opaque + Layer * 16);
+        __m256i Center = _mm256_loadu_si256(Rows);
+
+        __m256i Result = _mm256_and_si256(Center, _mm256_and_si256(_mm256_slli_epi16(Center, 1), _mm256_srli_epi16(Center, 1)));
+
+        // NOTE(boti): Shifting by a whole row crosses the 128-bit lanes, alignr with the other lane (or zero) does that
+        __m256i LoToHi = _mm256_permute2x128_si256(Center, Center, 0x08); // { 0, Lo }
+        __m256i HiToLo = _mm256_permute2x128_si256(Center, Center, 0x81); // { Hi, 0 }
+        Result = _mm256_and_si256(Result, _mm256_alignr_epi8(Center, LoToHi, 14)); // y - 1
+        Result = _mm256_and_si256(Result, _mm256_alignr_epi8(HiToLo, Center, 2));  // y + 1
+
+        Result = _mm256_and_si256(Result, (Layer > 0) ? _mm256_loadu_si256(Rows - 1) : Zero);
+        Result = _mm256_and_si256(Result, (Layer + 1 < LayerCount) ? _mm256_loadu_si256(Rows + 1) : Zero);
+
+        _mm256_storeu_si256((__m256i*)(Buried + Layer * 16), Result);
+    }
+}
+
+TARGET_AVX2 static void CullBoxes_AVX2(const frustum* Frustum, vec3 HalfExtent, u32 Count,
+                                       const f32* CenterX, const f32* CenterY, const f32* CenterZ, u8* Visible)
+{
+    frustum_radii Radii = GetFrustumRadii(Frustum, HalfExtent);
+
+    u32 i = 0;
+    for (; i + 8 <= Count; i += 8)
+    {
+        __m256 X = _mm256_loadu_ps(CenterX + i);
+        __m256 Y = _mm256_loadu_ps(CenterY + i);
+        __m256 Z = _mm256_loadu_ps(CenterZ + i);
+
+        __m256 Outside = _mm256_setzero_ps();
+        for (u32 Plane = 0; Plane < 6; Plane++)
+        {
+            vec4 P = Frustum->Planes[Plane];
+            __m256 Distance = _mm256_add_ps(_mm256_mul_ps(X, _mm256_set1_ps(P.x)), _mm256_mul_ps(Y, _mm256_set1_ps(P.y)));
+            Distance = _mm256_add_ps(Distance, _mm256_mul_ps(Z, _mm256_set1_ps(P.z)));
+            Distance = _mm256_add_ps(Distance, _mm256_set1_ps(P.w));
+            Outside = _mm256_or_ps(Outside, _mm256_cmp_ps(Distance, _mm256_set1_ps(-Radii.R[Plane]), _CMP_LT_OQ));
+        }
+
+        u32 OutsideMask = (u32)_mm256_movemask_ps(Outside);
+        for (u32 Lane = 0; Lane < 8; Lane++)
+        {
+            Visible[i + Lane] = (OutsideMask & (1u << Lane)) ? 0 : 1;
+        }
+    }
+    for (; i < Count; i++)
+    {
+        Visible[i] = CullBox_Scalar(Frustum, &Radii, vec4{ CenterX[i], CenterY[i], CenterZ[i], 1.0f });
+    }
+}
+
+TARGET_AVX2 static void MixMono_AVX2(audio_sample* Dst, const s16* Src, u32 Count, f32 Volume)
+{
+    const __m256 Scale = _mm256_set1_ps(1.0f / 32768.0f);
+    const __m256 Volume8 = _mm256_set1_ps(Volume);
+
+    u32 i = 0;
+    for (; i + 8 <= Count; i += 8)
+    {
+        __m128i Samples16 = _mm_loadu_si128((const __m128i*)(Src + i));
+        __m256 Sample = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(Samples16)), Scale);
+        Sample = _mm256_mul_ps(Volume8, Sample);
+
+        // NOTE(boti): unpack works within the 128-bit lanes: Lo = { 0 0 1 1 | 4 4 5 5 }, Hi = { 2 2 3 3 | 6 6 7 7 }
+        __m256 Lo = _mm256_unpacklo_ps(Sample, Sample);
+        __m256 Hi = _mm256_unpackhi_ps(Sample, Sample);
+
+        f32* Out = (f32*)(Dst + i);
+        _mm256_storeu_ps(Out + 0, _mm256_add_ps(_mm256_loadu_ps(Out + 0), _mm256_permute2f128_ps(Lo, Hi, 0x20)));
+        _mm256_storeu_ps(Out + 8, _mm256_add_ps(_mm256_loadu_ps(Out + 8), _mm256_permute2f128_ps(Lo, Hi, 0x31)));
+    }
+    MixMono_Scalar(Dst + i, Src + i, Count - i, Volume);
+}
+
+//
+// AVX-512
+//
+
+TARGET_AVX512 static inline __m512 Lerp16(__m512 a, __m512 b, __m512 t)
+{
+    __m512 Result = _mm512_add_ps(
+        _mm512_mul_ps(a, _mm512_sub_ps(_mm512_set1_ps(1.0f), t)),
+        _mm512_mul_ps(b, t));
+    return Result;
+}
+
+TARGET_AVX512 static inline __m512 Fade5_16(__m512 t)
+{
+    __m512 Result = _mm512_mul_ps(_mm512_set1_ps(6.0f), t);
+    Result = _mm512_sub_ps(Result, _mm512_set1_ps(15.0f));
+    Result = _mm512_mul_ps(Result, t);
+    Result = _mm512_add_ps(Result, _mm512_set1_ps(10.0f));
+    Result = _mm512_mul_ps(Result, t);
+    Result = _mm512_mul_ps(Result, t);
+    Result = _mm512_mul_ps(Result, t);
+    return Result;
+}
+
+TARGET_AVX512 static inline __m512 Floor16(__m512 x)
+{
+    __m512 Result = _mm512_roundscale_ps(x, _MM_FROUND_TO_NEG_INF|_MM_FROUND_NO_EXC);
+    return Result;
+}
+
+// NOTE(boti): Bit "Bit" of each lane moved into the sign bit, for flipping the sign of the gradient components
+TARGET_AVX512 static inline __m512i SignMask16(__m512i Hash, int Bit)
+{
+    __m512i Result = _mm512_and_si512(_mm512_slli_epi32(Hash, 31 - Bit), _mm512_set1_epi32((s32)0x80000000u));
+    return Result;
+}
+
+TARGET_AVX512 static inline __mmask16 HashBit16(__m512i Hash, int Bit)
+{
+    __mmask16 Result = _mm512_test_epi32_mask(Hash, _mm512_set1_epi32(1 << Bit));
+    return Result;
+}
+
+TARGET_AVX512 static inline __m512 FlipSign16(__m512 x, __m512i SignMask)
+{
+    __m512 Result = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(x), SignMask));
+    return Result;
+}
+
+TARGET_AVX512 static inline __m512 Gradient2_16(__m512i Hash, __m512 X, __m512 Y)
+{
+    __m512 Sum = _mm512_add_ps(FlipSign16(X, SignMask16(Hash, 0)), FlipSign16(Y, SignMask16(Hash, 1)));
+
+    __m512 Single = _mm512_mask_blend_ps(HashBit16(Hash, 1), Y, X);
+    Single = FlipSign16(Single, SignMask16(Hash, 0));
+
+    __m512 Result = _mm512_mask_blend_ps(HashBit16(Hash, 2), Sum, Single);
+    return Result;
+}
+
+TARGET_AVX512 static __m512 SampleNoise16(const perlin2* Perlin, __m512 X, __m512 Y)
+{
+    __m512 LatticeX = Floor16(X);
+    __m512 LatticeY = Floor16(Y);
+    __m512 X0 = _mm512_sub_ps(X, LatticeX);
+    __m512 Y0 = _mm512_sub_ps(Y, LatticeY);
+    __m512 X1 = _mm512_sub_ps(X0, _mm512_set1_ps(1.0f));
+    __m512 Y1 = _mm512_sub_ps(Y0, _mm512_set1_ps(1.0f));
+    __m512i Xi = _mm512_cvttps_epi32(LatticeX);
+    __m512i Yi = _mm512_cvttps_epi32(LatticeY);
+
+    const __m512i One = _mm512_set1_epi32(1);
+    const __m512i Mask = _mm512_set1_epi32(perlin2::TableCount - 1);
+    const int* Table = (const int*)Perlin->Permutation;
+
+    __m512i IndexX0 = _mm512_and_si512(Xi, Mask);
+    __m512i IndexX1 = _mm512_and_si512(_mm512_add_epi32(Xi, One), Mask);
+    __m512i IndexY0 = _mm512_i32gather_epi32(_mm512_and_si512(Yi, Mask), Table, 4);
+    __m512i IndexY1 = _mm512_i32gather_epi32(_mm512_and_si512(_mm512_add_epi32(Yi, One), Mask), Table, 4);
+
+    __m512i Hash00 = _mm512_i32gather_epi32(_mm512_and_si512(_mm512_add_epi32(IndexX0, IndexY0), Mask), Table, 4);
+    __m512i Hash10 = _mm512_i32gather_epi32(_mm512_and_si512(_mm512_add_epi32(IndexX1, IndexY0), Mask), Table, 4);
+    __m512i Hash01 = _mm512_i32gather_epi32(_mm512_and_si512(_mm512_add_epi32(IndexX0, IndexY1), Mask), Table, 4);
+    __m512i Hash11 = _mm512_i32gather_epi32(_mm512_and_si512(_mm512_add_epi32(IndexX1, IndexY1), Mask), Table, 4);
+
+    __m512 GdotV00 = Gradient2_16(Hash00, X0, Y0);
+    __m512 GdotV10 = Gradient2_16(Hash10, X1, Y0);
+    __m512 GdotV01 = Gradient2_16(Hash01, X0, Y1);
+    __m512 GdotV11 = Gradient2_16(Hash11, X1, Y1);
+
+    __m512 FactorX = Fade5_16(X0);
+    __m512 FactorY = Fade5_16(Y0);
+
+    __m512 Result = Lerp16(
+        Lerp16(GdotV00, GdotV10, FactorX),
+        Lerp16(GdotV01, GdotV11, FactorX),
+        FactorY);
+    return Result;
+}
+
+TARGET_AVX512 static inline __m512i HashNoise_Finalize16(__m512i Hash)
+{
+    Hash = _mm512_xor_si512(Hash, _mm512_srli_epi32(Hash, 16));
+    Hash = _mm512_mullo_epi32(Hash, _mm512_set1_epi32((s32)0x7FEB352Du));
+    Hash = _mm512_xor_si512(Hash, _mm512_srli_epi32(Hash, 15));
+    Hash = _mm512_mullo_epi32(Hash, _mm512_set1_epi32((s32)0x846CA68Bu));
+    Hash = _mm512_xor_si512(Hash, _mm512_srli_epi32(Hash, 16));
+    return Hash;
+}
+
+TARGET_AVX512 static __m512 SampleNoise16(const hash_noise* Noise, __m512 X, __m512 Y)
+{
+    __m512 LatticeX = Floor16(X);
+    __m512 LatticeY = Floor16(Y);
+
+    __m512 Vx[2], Vy[2];
+    Vx[0] = _mm512_sub_ps(X, LatticeX);
+    Vy[0] = _mm512_sub_ps(Y, LatticeY);
+    Vx[1] = _mm512_sub_ps(Vx[0], _mm512_set1_ps(1.0f));
+    Vy[1] = _mm512_sub_ps(Vy[0], _mm512_set1_ps(1.0f));
+
+    const __m512i PrimeX = _mm512_set1_epi32((s32)HashNoise_PrimeX);
+    const __m512i PrimeY = _mm512_set1_epi32((s32)HashNoise_PrimeY);
+    __m512i PrimedX[2], PrimedY[2];
+    PrimedX[0] = _mm512_mullo_epi32(_mm512_cvttps_epi32(LatticeX), PrimeX);
+    PrimedY[0] = _mm512_mullo_epi32(_mm512_cvttps_epi32(LatticeY), PrimeY);
+    PrimedX[1] = _mm512_add_epi32(PrimedX[0], PrimeX);
+    PrimedY[1] = _mm512_add_epi32(PrimedY[0], PrimeY);
+    PrimedX[0] = _mm512_xor_si512(PrimedX[0], _mm512_set1_epi32((s32)Noise->Seed));
+    PrimedX[1] = _mm512_xor_si512(PrimedX[1], _mm512_set1_epi32((s32)Noise->Seed));
+
+    __m512 GdotV[2][2];
+    for (u32 y = 0; y < 2; y++)
+    {
+        for (u32 x = 0; x < 2; x++)
+        {
+            __m512i Hash = HashNoise_Finalize16(_mm512_xor_si512(PrimedX[x], PrimedY[y]));
+            GdotV[x][y] = Gradient2_16(Hash, Vx[x], Vy[y]);
+        }
+    }
+
+    __m512 FactorX = Fade5_16(Vx[0]);
+    __m512 FactorY = Fade5_16(Vy[0]);
+
+    __m512 Result = Lerp16(
+        Lerp16(GdotV[0][0], GdotV[1][0], FactorX),
+        Lerp16(GdotV[0][1], GdotV[1][1], FactorX),
+        FactorY);
+    return Result;
+}
+
+// NOTE(boti): Same as SampleOctave8<OctaveCount>, the octaves are independent and only summed at the end
+template<u32 OctaveCount, typename noise_t>
+TARGET_AVX512 static void SampleOctave2_AVX512(const noise_t* Noise, u32 Count, const f32* X, const f32* Y, f32* Out)
+{
+    static constexpr octave_table<OctaveCount> Table;
+
+    const __m512 C16 = _mm512_set1_ps(OctaveRotationC);
+    const __m512 S16 = _mm512_set1_ps(OctaveRotationS);
+    const __m512 NegS16 = _mm512_set1_ps(-OctaveRotationS);
+
+    u32 i = 0;
+    for (; i + 16 <= Count; i += 16)
+    {
+        __m512 X16 = _mm512_loadu_ps(X + i);
+        __m512 Y16 = _mm512_loadu_ps(Y + i);
+
+        __m512 Samples[OctaveCount];
+        for (u32 Octave = 0; Octave < OctaveCount; Octave++)
+        {
+            __m512 Frequency16 = _mm512_set1_ps(Table.Frequencies[Octave]);
+            Samples[Octave] = SampleNoise16(Noise, _mm512_mul_ps(Frequency16, X16), _mm512_mul_ps(Frequency16, Y16));
+
+            __m512 NewX = _mm512_add_ps(_mm512_mul_ps(C16, X16), _mm512_mul_ps(S16, Y16));
+            __m512 NewY = _mm512_add_ps(_mm512_mul_ps(NegS16, X16), _mm512_mul_ps(C16, Y16));
+            X16 = NewX;
+            Y16 = NewY;
+        }
+
+        __m512 Result = _mm512_setzero_ps();
+        for (u32 Octave = 0; Octave < OctaveCount; Octave++)
+        {
+            Result = _mm512_add_ps(Result, _mm512_mul_ps(_mm512_set1_ps(Table.Amplitudes[Octave]), Samples[Octave]));
+        }
+        _mm512_storeu_ps(Out + i, Result);
+    }
+    SampleOctave2_AVX2<OctaveCount>(Noise, Count - i, X + i, Y + i, Out + i);
+}
+
+template<typename noise_t>
+TARGET_AVX512 static void SampleOctave2_AVX512(const noise_t* Noise, u32 Count, const f32* X, const f32* Y,
+                                               u32 OctaveCount, f32 Persistence, f32 Lacunarity, f32* Out)
+{
+    switch (GetSpecializedOctaveCount(OctaveCount, Persistence, Lacunarity))
+    {
+        case 1: SampleOctave2_AVX512<1>(Noise, Count, X, Y, Out); return;
+        case 2: SampleOctave2_AVX512<2>(Noise, Count, X, Y, Out); return;
+        case 3: SampleOctave2_AVX512<3>(Noise, Count, X, Y, Out); return;
+        case 4: SampleOctave2_AVX512<4>(Noise, Count, X, Y, Out); return;
+        case 5: SampleOctave2_AVX512<5>(Noise, Count, X, Y, Out); return;
+        case 6: SampleOctave2_AVX512<6>(Noise, Count, X, Y, Out); return;
+        case 7: SampleOctave2_AVX512<7>(Noise, Count, X, Y, Out); return;
+        case 8: SampleOctave2_AVX512<8>(Noise, Count, X, Y, Out); return;
+    }
+
+    const __m512 C16 = _mm512_set1_ps(OctaveRotationC);
+    const __m512 S16 = _mm512_set1_ps(OctaveRotationS);
+    const __m512 NegS16 = _mm512_set1_ps(-OctaveRotationS);
+
+    u32 i = 0;
+    for (; i + 16 <= Count; i += 16)
+    {
+        __m512 X16 = _mm512_loadu_ps(X + i);
+        __m512 Y16 = _mm512_loadu_ps(Y + i);
+
+        __m512 Result = _mm512_setzero_ps();
+        f32 Amplitude = 1.0f;
+        f32 Frequency = 1.0f;
+        for (u32 Octave = 0; Octave < OctaveCount; Octave++)
+        {
+            __m512 Frequency16 = _mm512_set1_ps(Frequency);
+            __m512 Sample = SampleNoise16(Noise, _mm512_mul_ps(Frequency16, X16), _mm512_mul_ps(Frequency16, Y16));
+            Result = _mm512_add_ps(Result, _mm512_mul_ps(_mm512_set1_ps(Amplitude), Sample));
+
+            Frequency *= Lacunarity;
+            Amplitude *= Persistence;
+
+            __m512 NewX = _mm512_add_ps(_mm512_mul_ps(C16, X16), _mm512_mul_ps(S16, Y16));
+            __m512 NewY = _mm512_add_ps(_mm512_mul_ps(NegS16, X16), _mm512_mul_ps(C16, Y16));
+            X16 = NewX;
+            Y16 = NewY;
+        }
+        _mm512_storeu_ps(Out + i, Result);
+    }
+    // NOTE(boti): The rest is less than 16 wide, the 8-wide version still applies
+    SampleOctave2_AVX2(Noise, Count - i, X + i, Y + i, OctaveCount, Persistence, Lacunarity, Out + i);
+}
+
+// NOTE(boti): Two layers per register, the row shifts are permutes within each 256-bit half
+TARGET_AVX512 static void FindBuriedVoxels_AVX512(u32 LayerCount, const u16* Opaque, u16* Buried)
+{
+    alignas(64) static const u16 PrevRowIndices[32] =
+    {
+        0,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14,
+        16, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30,
+    };
+    alignas(64) static const u16 NextRowIndices[32] =
+    {
+        1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15, 15,
+        17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 31,
+    };
+    const __m512i PrevRow = _mm512_load_si512(PrevRowIndices);
+    const __m512i NextRow = _mm512_load_si512(NextRowIndices);
+    const __mmask32 PrevRowMask = ~((1u << 0) | (1u << 16));
+    const __mmask32 NextRowMask = ~((1u << 15) | (1u << 31));
+
+    const __m256i Zero = _mm256_setzero_si256();
+
+    u32 Layer = 0;
+    for (; Layer + 2 <= LayerCount; Layer += 2)
+    {
+        const __m256i* Rows = (const __m256i*)(Opaque + Layer * 16);
+        __m256i Layer0 = _mm256_loadu_si256(Rows + 0);
+        __m256i Layer1 = _mm256_loadu_si256(Rows + 1);
+        __m256i Below = (Layer > 0) ? _mm256_loadu_si256(Rows - 1) : Zero;
+        __m256i Above = (Layer + 2 < LayerCount) ? _mm256_loadu_si256(Rows + 2) : Zero;
+
+        __m512i Center = _mm512_inserti64x4(_mm512_castsi256_si512(Layer0), Layer1, 1);
+        __m512i Result = _mm512_and_si512(Center, _mm512_and_si512(_mm512_slli_epi16(Center, 1), _mm512_srli_epi16(Center, 1)));
+        Result = _mm512_and_si512(Result, _mm512_maskz_permutexvar_epi16(PrevRowMask, PrevRow, Center));
+        Result = _mm512_and_si512(Result, _mm512_maskz_permutexvar_epi16(NextRowMask, NextRow, Center));
+        Result = _mm512_and_si512(Result, _mm512_inserti64x4(_mm512_castsi256_si512(Below), Layer0, 1));
+        Result = _mm512_and_si512(Result, _mm512_inserti64x4(_mm512_castsi256_si512(Layer1), Above, 1));
+
+        _mm512_storeu_si512(Buried + Layer * 16, Result);
+    }
+    for (; Layer < LayerCount; Layer++)
+    {
+        FindBuriedVoxels_Layer(LayerCount, Opaque, Buried, Layer);
+    }
+}
+
+TARGET_AVX512 static void CullBoxes_AVX512(const frustum* Frustum, vec3 HalfExtent, u32 Count,
+                                           const f32* CenterX, const f32* CenterY, const f32* CenterZ, u8* Visible)
+{
+    frustum_radii Radii = GetFrustumRadii(Frustum, HalfExtent);
+
+    u32 i = 0;
+    for (; i + 16 <= Count; i += 16)
+    {
+        __m512 X = _mm512_loadu_ps(CenterX + i);
+        __m512 Y = _mm512_loadu_ps(CenterY + i);
+        __m512 Z = _mm512_loadu_ps(CenterZ + i);
+
+        __mmask16 Outside = 0;
+        for (u32 Plane = 0; Plane < 6; Plane++)
+        {
+            vec4 P = Frustum->Planes[Plane];
+            __m512 Distance = _mm512_add_ps(_mm512_mul_ps(X, _mm512_set1_ps(P.x)), _mm512_mul_ps(Y, _mm512_set1_ps(P.y)));
+            Distance = _mm512_add_ps(Distance, _mm512_mul_ps(Z, _mm512_set1_ps(P.z)));
+            Distance = _mm512_add_ps(Distance, _mm512_set1_ps(P.w));
+            Outside |= _mm512_cmp_ps_mask(Distance, _mm512_set1_ps(-Radii.R[Plane]), _CMP_LT_OQ);
+        }
+
+        __m128i Result = _mm_maskz_mov_epi8((__mmask16)~Outside, _mm_set1_epi8(1));
+        _mm_storeu_si128((__m128i*)(Visible + i), Result);
+    }
+    for (; i < Count; i++)
+    {
+        Visible[i] = CullBox_Scalar(Frustum, &Radii, vec4{ CenterX[i], CenterY[i], CenterZ[i], 1.0f });
+    }
+}
+
+TARGET_AVX512 static void MixMono_AVX512(audio_sample* Dst, const s16* Src, u32 Count, f32 Volume)
+{
+    const __m512 Scale = _mm512_set1_ps(1.0f / 32768.0f);
+    const __m512 Volume16 = _mm512_set1_ps(Volume);
+    const __m512i LoIndices = _mm512_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7);
+    const __m512i HiIndices = _mm512_setr_epi32(8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13, 14, 14, 15, 15);
+
+    u32 i = 0;
+    for (; i + 16 <= Count; i += 16)
+    {
+        __m256i Samples16 = _mm256_loadu_si256((const __m256i*)(Src + i));
+        __m512 Sample = _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(Samples16)), Scale);
+        Sample = _mm512_mul_ps(Volume16, Sample);
+
+        f32* Out = (f32*)(Dst + i);
+        _mm512_storeu_ps(Out + 0, _mm512_add_ps(_mm512_loadu_ps(Out + 0), _mm512_permutexvar_ps(LoIndices, Sample)));
+        _mm512_storeu_ps(Out + 16, _mm512_add_ps(_mm512_loadu_ps(Out + 16), _mm512_permutexvar_ps(HiIndices, Sample)));
+    }
+    MixMono_AVX2(Dst + i, Src + i, Count - i, Volume);
+}
+
+//
+// Dispatch
+//
+
+static const simd_kernels KernelTable[CPULevel_Count] =
+{
+    {
+        .Level = CPULevel_Scalar,
+        .SampleOctavePerlin2 = &SampleOctave2_Scalar<perlin2>,
+        .SampleOctaveHash2 = &SampleOctave2_Scalar<hash_noise>,
+        .FindBuriedVoxels = &FindBuriedVoxels_Scalar,
+        .CullBoxes = &CullBoxes_Scalar,
+        .MixMono = &MixMono_Scalar,
+    },
+    {
+        .Level = CPULevel_SSE41,
+        .SampleOctavePerlin2 = &SampleOctave2_SSE41<perlin2>,
+        .SampleOctaveHash2 = &SampleOctave2_SSE41<hash_noise>,
+        .FindBuriedVoxels = &FindBuriedVoxels_SSE41,
+        .CullBoxes = &CullBoxes_SSE41,
+        .MixMono = &MixMono_SSE41,
+    },
+    {
+        .Level = CPULevel_AVX2,
+        .SampleOctavePerlin2 = &SampleOctave2_AVX2<perlin2>,
+        .SampleOctaveHash2 = &SampleOctave2_AVX2<hash_noise>,
+        .FindBuriedVoxels = &FindBuriedVoxels_AVX2,
+        .CullBoxes = &CullBoxes_AVX2,
+        .MixMono = &MixMono_AVX2,
+    },
+    {
+        .Level = CPULevel_AVX512,
+        .SampleOctavePerlin2 = &SampleOctave2_AVX512<perlin2>,
+        .SampleOctaveHash2 = &SampleOctave2_AVX512<hash_noise>,
+        .FindBuriedVoxels = &FindBuriedVoxels_AVX512,
+        .CullBoxes = &CullBoxes_AVX512,
+        .MixMono = &MixMono_AVX512,
+    },
+};
+
+const simd_kernels* GetSIMDKernels(cpu_level Level)
+{
+    assert(Level < CPULevel_Count);
+    const simd_kernels* Result = KernelTable + Level;
+    return(Result);
+}
+
+static const simd_kernels* SelectSIMDKernels()
+{
+    cpu_features Features = DetectCPUFeatures();
+    const simd_kernels* Result = GetSIMDKernels(GetCPULevel(&Features));
+    return(Result);
+}
+
+const simd_kernels* Kernels = SelectSIMDKernels();
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Common.hpp>
+#include <Intrinsics.hpp>
+#include <CPUFeatures.hpp>
+#include <Math.hpp>
+#include <Random.hpp>
+#include <Shapes.hpp>
+#include <Platform.hpp>
+
+//
+// SIMD kernels
+//
+// NOTE(boti): The hot loops that have a separate implementation for each cpu_level, picked at runtime.
+//             Every variant produces the exact same bits as the scalar one (no FMA, same operation order),
+//             so the level only ever changes the speed, never the generated world or the audio mix.
+//             The rest of the 8-wide code (the 3D density fields, the worms and the voxel rows in WorldGen)
+//             is TARGET_AVX2 and checks Kernels->Level itself, below AVX2 it goes through the scalar code.
+//
+//             None of the kernels have alignment or count requirements, the remainder goes through the scalar code.
+//
+
+// Octave noise at Count independent points, Out[i] = SampleOctave(Noise, { X[i], Y[i] }, ...)
+typedef void (sample_octave_perlin2_kernel)(const perlin2* Noise, u32 Count, const f32* X, const f32* Y,
+                                           u32 OctaveCount, f32 Persistence, f32 Lacunarity, f32* Out);
+typedef void (sample_octave_hash2_kernel)(const hash_noise* Noise, u32 Count, const f32* X, const f32* Y,
+                                         u32 OctaveCount, f32 Persistence, f32 Lacunarity, f32* Out);
+
+// Opaque and Buried are [LayerCount][16] rows of voxels, 1 bit per voxel (bit x of row y).
+// A voxel is buried if it and all 6 of its neighbors are opaque,
+// the neighbors outside of the layers count as not opaque.
+typedef void (find_buried_voxels_kernel)(u32 LayerCount, const u16* Opaque, u16* Buried);
+
+// Visible[i] = IntersectFrustumAABB(Frustum, box at Center[i] with HalfExtent)
+typedef void (cull_boxes_kernel)(const frustum* Frustum, vec3 HalfExtent, u32 Count,
+                                 const f32* CenterX, const f32* CenterY, const f32* CenterZ, u8* Visible);
+
+// Mixes mono 16-bit samples into both channels of Dst: Dst[i] += Volume * (Src[i] / 32768)
+typedef void (mix_mono_kernel)(audio_sample* Dst, const s16* Src, u32 Count, f32 Volume);
+
+struct simd_kernels
+{
+    cpu_level Level;
+
+    sample_octave_perlin2_kernel* SampleOctavePerlin2;
+    sample_octave_hash2_kernel* SampleOctaveHash2;
+    find_buried_voxels_kernel* FindBuriedVoxels;
+    cull_boxes_kernel* CullBoxes;
+    mix_mono_kernel* MixMono;
+};
+
+const simd_kernels* GetSIMDKernels(cpu_level Level);
+
+// NOTE(boti): Picked for the detected CPU level when the module gets loaded (including the hot reloads of the game),
+//             before any of the threads can call into it, and never written after that by the game.
+//             The tools can switch it between runs while none of their own workers are running.
+extern const simd_kernels* Kernels;
+
+inline void SampleOctave(const perlin2* Noise, u32 Count, const f32* X, const f32* Y,
+                         u32 OctaveCount, f32 Persistence, f32 Lacunarity, f32* Out)
+{
+    Kernels->SampleOctavePerlin2(Noise, Count, X, Y, OctaveCount, Persistence, Lacunarity, Out);
+}
+
+inline void SampleOctave(const hash_noise* Noise, u32 Count, const f32* X, const f32* Y,
+                         u32 OctaveCount, f32 Persistence, f32 Lacunarity, f32* Out)
+{
+    Kernels->SampleOctaveHash2(Noise, Count, X, Y, OctaveCount, Persistence, Lacunarity, Out);
+}
@@ -0,0 +1,486 @@
+#include "NoiseGraph.hpp"
+
+static const char DefaultNoiseGraphSource[] = R"(
+# Column height
+height noise frequency=0.015625 octaves=8 persistence=0.5 lacunarity=2
+height add 1
+height mul 0.5
+height square
+height fade3
+height mul 32
+height round
+height add 80
+
+layer ground 3
+layer stone
+
+field ore noise frequency=0.125 octaves=3 persistence=0.5 lacunarity=2
+field cave noise frequency=0.0625 octaves=1 persistence=0.5 lacunarity=2
+
+rule stone coal ore > 0.75
+rule stone iron ore < -0.75
+rule solid air cave < -0.5 ceiling=112
+)";
+
+// NOTE(boti): Indexed by voxel type
+static const char* NoiseGraph_VoxelTypeNames[] =
+{
+    "air",
+    "ground",
+    "stone",
+    "coal",
+    "iron",
+    "trunk",
+    "leaves",
+    "sand",
+    "snow",
+};
+static_assert(CountOf(NoiseGraph_VoxelTypeNames) == VoxelDescCount);
+
+struct noise_graph_token
+{
+    const char* At;
+    u32 Length;
+};
+
+static bool TokenEquals(noise_graph_token Token, const char* String)
+{
+    bool Result = (strlen(String) == Token.Length) && (strncmp(Token.At, String, Token.Length) == 0);
+    return(Result);
+}
+
+static bool ParseF32(noise_graph_token Token, f32* Value)
+{
+    bool Result = false;
+
+    char Buffer[32];
+    if (Token.Length > 0 && Token.Length < sizeof(Buffer))
+    {
+        memcpy(Buffer, Token.At, Token.Length);
+        Buffer[Token.Length] = 0;
+
+        char* End = nullptr;
+        *Value = strtof(Buffer, &End);
+        Result = (End == Buffer + Token.Length);
+    }
+    return(Result);
+}
+
+static bool ParseS32(noise_graph_token Token, s32* Value)
+{
+    bool Result = false;
+
+    char Buffer[32];
+    if (Token.Length > 0 && Token.Length < sizeof(Buffer))
+    {
+        memcpy(Buffer, Token.At, Token.Length);
+        Buffer[Token.Length] = 0;
+
+        char* End = nullptr;
+        *Value = (s32)strtol(Buffer, &End, 10);
+        Result = (End == Buffer + Token.Length);
+    }
+    return(Result);
+}
+
+// Splits "key=value" tokens, returns false if there's no '='
+static bool SplitOption(noise_graph_token Token, noise_graph_token* Key, noise_graph_token* Value)
+{
+    bool Result = false;
+    for (u32 i = 0; i < Token.Length; i++)
+    {
+        if (Token.At[i] == '=')
+        {
+            *Key = { Token.At, i };
+            *Value = { Token.At + i + 1, Token.Length - i - 1 };
+            Result = true;
+            break;
+        }
+    }
+    return(Result);
+}
+
+static bool ParseVoxelType(noise_graph_token Token, u16* Type)
+{
+    bool Result = false;
+    for (u16 i = 0; i < CountOf(NoiseGraph_VoxelTypeNames); i++)
+    {
+        if (TokenEquals(Token, NoiseGraph_VoxelTypeNames[i]))
+        {
+            *Type = i;
+            Result = true;
+            break;
+        }
+    }
+    return(Result);
+}
+
+// Parses an op (and its arguments) into Program
+static bool ParseNoiseOp(noise_program* Program, const noise_graph_token* Tokens, u32 TokenCount, bool AllowBiomeOp)
+{
+    if (TokenCount == 0 || Program->OpCount >= Program->MaxOpCount)
+    {
+        return(false);
+    }
+
+    noise_op Op = {};
+    bool Result = true;
+    if (TokenEquals(Tokens[0], "noise"))
+    {
+        Op.Type = NoiseOp_Noise;
+        Op.Value = 1.0f;
+        Op.OctaveCount = 1;
+        Op.Persistence = 0.5f;
+        Op.Lacunarity = 2.0f;
+        for (u32 i = 1; i < TokenCount && Result; i++)
+        {
+            noise_graph_token Key, Value;
+            s32 OctaveCount = 0;
+            Result = SplitOption(Tokens[i], &Key, &Value);
+            if (!Result) break;
+
+            if      (TokenEquals(Key, "frequency"))     Result = ParseF32(Value, &Op.Value);
+            else if (TokenEquals(Key, "persistence"))   Result = ParseF32(Value, &Op.Persistence);
+            else if (TokenEquals(Key, "lacunarity"))    Result = ParseF32(Value, &Op.Lacunarity);
+            else if (TokenEquals(Key, "octaves"))
+            {
+                Result = ParseS32(Value, &OctaveCount) && (OctaveCount > 0);
+                Op.OctaveCount = (u32)OctaveCount;
+            }
+            else Result = false;
+        }
+    }
+    else if (TokenEquals(Tokens[0], "add") || TokenEquals(Tokens[0], "mul"))
+    {
+        Op.Type = TokenEquals(Tokens[0], "add") ? NoiseOp_Add : NoiseOp_Mul;
+        Result = (TokenCount == 2) && ParseF32(Tokens[1], &Op.Value);
+    }
+    else if (TokenCount == 1 && TokenEquals(Tokens[0], "square"))   Op.Type = NoiseOp_Square;
+    else if (TokenCount == 1 && TokenEquals(Tokens[0], "fade3"))    Op.Type = NoiseOp_Fade3;
+    else if (TokenCount == 1 && TokenEquals(Tokens[0], "round"))    Op.Type = NoiseOp_Round;
+    else if (TokenCount == 1 && TokenEquals(Tokens[0], "biome") && AllowBiomeOp) Op.Type = NoiseOp_Biome;
+    else Result = false;
+
+    if (Result)
+    {
+        Program->Ops[Program->OpCount++] = Op;
+    }
+    return(Result);
+}
+
+static bool CompileNoiseGraph(noise_graph* Graph, buffer Source, u32* ErrorLine /*= nullptr*/)
+{
+    *Graph = {};
+
+    bool Result = true;
+    bool HasLastLayer = false;
+
+    u32 LineNumber = 0;
+    const char* At = (const char*)Source.Data;
+    const char* End = At + Source.Size;
+    while (Result && At < End)
+    {
+        LineNumber++;
+
+        // Tokenize the line
+        constexpr u32 MaxTokenCount = 16;
+        noise_graph_token Tokens[MaxTokenCount];
+        u32 TokenCount = 0;
+        bool IsComment = false;
+        while (At < End && *At != '\n')
+        {
+            char C = *At;
+            if (C == '#')
+            {
+                IsComment = true;
+            }
+
+            if (IsComment || C == ' ' || C == '\t' || C == '\r')
+            {
+                At++;
+            }
+            else
+            {
+                noise_graph_token Token = { At, 0 };
+                while (At < End && *At != ' ' && *At != '\t' && *At != '\r' && *At != '\n' && *At != '#')
+                {
+                    At++;
+                    Token.Length++;
+                }
+
+                if (TokenCount < MaxTokenCount)
+                {
+                    Tokens[TokenCount++] = Token;
+                }
+                else
+                {
+                    Result = false;
+                }
+            }
+        }
+        At++; // Skip '\n'
+
+        if (!Result || TokenCount == 0)
+        {
+            continue;
+        }
+
+        if (TokenEquals(Tokens[0], "height"))
+        {
+            Result = ParseNoiseOp(&Graph->Height, Tokens + 1, TokenCount - 1, true);
+        }
+        else if (TokenEquals(Tokens[0], "temperature"))
+        {
+            Result = ParseNoiseOp(&Graph->Temperature, Tokens + 1, TokenCount - 1, false);
+        }
+        else if (TokenEquals(Tokens[0], "humidity"))
+        {
+            Result = ParseNoiseOp(&Graph->Humidity, Tokens + 1, TokenCount - 1, false);
+        }
+        else if (TokenEquals(Tokens[0], "field"))
+        {
+            Result = (TokenCount >= 3) && (Tokens[1].Length < noise_graph::MaxFieldNameLength);
+            if (Result)
+            {
+                u32 FieldIndex = 0;
+                for (; FieldIndex < Graph->FieldCount; FieldIndex++)
+                {
+                    if (TokenEquals(Tokens[1], Graph->FieldNames[FieldIndex]))
+                    {
+                        break;
+                    }
+                }
+
+                if (FieldIndex == Graph->FieldCount)
+                {
+                    if (Graph->FieldCount < Graph->MaxFieldCount)
+                    {
+                        memcpy(Graph->FieldNames[FieldIndex], Tokens[1].At, Tokens[1].Length);
+                        Graph->FieldNames[FieldIndex][Tokens[1].Length] = 0;
+                        Graph->FieldCount++;
+                    }
+                    else
+                    {
+                        Result = false;
+                    }
+                }
+
+                Result = Result && ParseNoiseOp(Graph->Fields + FieldIndex, Tokens + 2, TokenCount - 2, false);
+            }
+        }
+        else if (TokenEquals(Tokens[0], "layer"))
+        {
+            // NOTE(boti): Only the last layer is allowed to go on forever
+            Result = !HasLastLayer && (Graph->LayerCount < Graph->MaxLayerCount) && (TokenCount == 2 || TokenCount == 3);
+            if (Result)
+            {
+                u32 LayerIndex = Graph->LayerCount++;
+                Result = ParseVoxelType(Tokens[1], Graph->LayerTypes + LayerIndex) && (Graph->LayerTypes[LayerIndex] != VOXEL_AIR);
+                if (TokenCount == 3)
+                {
+                    s32 Depth = 0;
+                    s32 PrevEndDepth = (LayerIndex > 0) ? Graph->LayerEndDepths[LayerIndex - 1] : 0;
+                    Result = Result && ParseS32(Tokens[2], &Depth) && (Depth > 0);
+                    Graph->LayerEndDepths[LayerIndex] = PrevEndDepth + Depth;
+                }
+                else
+                {
+                    HasLastLayer = true;
+                }
+            }
+        }
+        else if (TokenEquals(Tokens[0], "rule"))
+        {
+            Result = (Graph->RuleCount < Graph->MaxRuleCount) && (TokenCount == 6 || TokenCount == 7);
+            if (Result)
+            {
+                noise_rule* Rule = Graph->Rules + Graph->RuleCount++;
+                Rule->Ceiling = noise_graph::DefaultRuleCeiling;
+
+                // NOTE(boti): Rules never touch air, this is what allows the generator to skip everything above the terrain
+                constexpr u32 SolidTypeMask = ((1u << VoxelDescCount) - 1) & ~(1u << VOXEL_AIR);
+                u16 FromType = 0;
+                if (TokenEquals(Tokens[1], "solid"))
+                {
+                    Rule->FromTypeMask = SolidTypeMask;
+                }
+                else if (ParseVoxelType(Tokens[1], &FromType) && (FromType != VOXEL_AIR))
+                {
+                    Rule->FromTypeMask = 1u << FromType;
+                }
+                else
+                {
+                    Result = false;
+                }
+
+                Result = Result && ParseVoxelType(Tokens[2], &Rule->ToType);
+
+                Rule->FieldIndex = Graph->FieldCount;
+                for (u32 FieldIndex = 0; FieldIndex < Graph->FieldCount; FieldIndex++)
+                {
+                    if (TokenEquals(Tokens[3], Graph->FieldNames[FieldIndex]))
+                    {
+                        Rule->FieldIndex = FieldIndex;
+                        break;
+                    }
+                }
+                Result = Result && (Rule->FieldIndex < Graph->FieldCount);
+
+                if      (TokenEquals(Tokens[4], "<")) Rule->Compare = NoiseCompare_Less;
+                else if (TokenEquals(Tokens[4], ">")) Rule->Compare = NoiseCompare_Greater;
+                else Result = false;
+
+                Result = Result && ParseF32(Tokens[5], &Rule->Threshold);
+
+                if (TokenCount == 7)
+                {
+                    noise_graph_token Key, Value;
+                    Result = Result && SplitOption(Tokens[6], &Key, &Value) && TokenEquals(Key, "ceiling") && ParseS32(Value, &Rule->Ceiling);
+                }
+            }
+        }
+        else if (TokenEquals(Tokens[0], "biome"))
+        {
+            Result = (Graph->BiomeCount < Graph->MaxBiomeCount) && (TokenCount >= 5 && TokenCount <= 7) &&
+                     (Tokens[1].Length < noise_graph::MaxBiomeNameLength);
+            for (u32 BiomeIndex = 0; Result && BiomeIndex < Graph->BiomeCount; BiomeIndex++)
+            {
+                Result = !TokenEquals(Tokens[1], Graph->BiomeNames[BiomeIndex]);
+            }
+
+            if (Result)
+            {
+                u32 BiomeIndex = Graph->BiomeCount++;
+                memcpy(Graph->BiomeNames[BiomeIndex], Tokens[1].At, Tokens[1].Length);
+                Graph->BiomeNames[BiomeIndex][Tokens[1].Length] = 0;
+
+                noise_biome* Biome = Graph->Biomes + BiomeIndex;
+                Biome->HeightScale = 1.0f;
+                Biome->HeightOffset = 0.0f;
+                Result = ParseVoxelType(Tokens[2], &Biome->SurfaceType) && (Biome->SurfaceType != VOXEL_AIR);
+
+                bool HasTemperature = false;
+                bool HasHumidity = false;
+                for (u32 i = 3; i < TokenCount && Result; i++)
+                {
+                    noise_graph_token Key, Value;
+                    Result = SplitOption(Tokens[i], &Key, &Value);
+                    if (!Result) break;
+
+                    if (TokenEquals(Key, "temperature"))
+                    {
+                        Result = ParseF32(Value, &Biome->Temperature);
+                        HasTemperature = true;
+                    }
+                    else if (TokenEquals(Key, "humidity"))
+                    {
+                        Result = ParseF32(Value, &Biome->Humidity);
+                        HasHumidity = true;
+                    }
+                    else if (TokenEquals(Key, "scale"))     Result = ParseF32(Value, &Biome->HeightScale);
+                    else if (TokenEquals(Key, "offset"))    Result = ParseF32(Value, &Biome->HeightOffset);
+                    else Result = false;
+                }
+                Result = Result && HasTemperature && HasHumidity;
+            }
+        }
+        else if (TokenEquals(Tokens[0], "ore"))
+        {
+            Result = (Graph->OreCount < Graph->MaxOreCount) && (TokenCount >= 3 && TokenCount <= 7);
+            if (Result)
+            {
+                noise_ore* Ore = Graph->Ores + Graph->OreCount++;
+                Ore->MinRadius = 1.0f;
+                Ore->MaxRadius = 2.0f;
+                Ore->MinZ = noise_graph::DefaultMinZ;
+                Ore->MaxZ = noise_graph::DefaultMaxZ;
+                Result = ParseVoxelType(Tokens[1], &Ore->Type) && (Ore->Type != VOXEL_AIR);
+
+                bool HasCount = false;
+                for (u32 i = 2; i < TokenCount && Result; i++)
+                {
+                    noise_graph_token Key, Value;
+                    Result = SplitOption(Tokens[i], &Key, &Value);
+                    if (!Result) break;
+
+                    if (TokenEquals(Key, "count"))
+                    {
+                        Result = ParseF32(Value, &Ore->CountPerChunk);
+                        HasCount = true;
+                    }
+                    else if (TokenEquals(Key, "min_radius"))    Result = ParseF32(Value, &Ore->MinRadius);
+                    else if (TokenEquals(Key, "max_radius"))    Result = ParseF32(Value, &Ore->MaxRadius);
+                    else if (TokenEquals(Key, "min_z"))         Result = ParseS32(Value, &Ore->MinZ);
+                    else if (TokenEquals(Key, "max_z"))         Result = ParseS32(Value, &Ore->MaxZ);
+                    else Result = false;
+                }
+
+                Result = Result && HasCount &&
+                    (Ore->CountPerChunk >= 0.0f) && (Ore->CountPerChunk <= noise_graph::MaxOreCountPerChunk) &&
+                    (Ore->MinRadius > 0.0f) && (Ore->MinRadius <= Ore->MaxRadius) && (Ore->MaxRadius <= noise_graph::MaxOreRadius) &&
+                    (Ore->MinZ <= Ore->MaxZ);
+            }
+        }
+        else if (TokenEquals(Tokens[0], "worms"))
+        {
+            noise_worms* Worms = &Graph->Worms;
+            Result = (Worms->CountPerRegion == 0) && (TokenCount >= 3 && TokenCount <= 7);
+            if (Result)
+            {
+                Worms->MinRadius = 1.5f;
+                Worms->MaxRadius = 3.0f;
+                Worms->MinZ = noise_graph::DefaultMinZ;
+                Worms->MaxZ = noise_graph::DefaultMaxZ;
+
+                s32 Count = 0;
+                s32 SegmentCount = 0;
+                for (u32 i = 1; i < TokenCount && Result; i++)
+                {
+                    noise_graph_token Key, Value;
+                    Result = SplitOption(Tokens[i], &Key, &Value);
+                    if (!Result) break;
+
+                    if      (TokenEquals(Key, "count"))         Result = ParseS32(Value, &Count);
+                    else if (TokenEquals(Key, "length"))        Result = ParseS32(Value, &SegmentCount);
+                    else if (TokenEquals(Key, "min_radius"))    Result = ParseF32(Value, &Worms->MinRadius);
+                    else if (TokenEquals(Key, "max_radius"))    Result = ParseF32(Value, &Worms->MaxRadius);
+                    else if (TokenEquals(Key, "min_z"))         Result = ParseS32(Value, &Worms->MinZ);
+                    else if (TokenEquals(Key, "max_z"))         Result = ParseS32(Value, &Worms->MaxZ);
+                    else Result = false;
+                }
+
+                Result = Result && (Count > 0) && (SegmentCount > 0) &&
+                    ((u32)Count * (u32)SegmentCount <= noise_graph::MaxWormSegmentCountPerRegion) &&
+                    ((f32)SegmentCount * noise_graph::WormStepLength + Worms->MaxRadius <= (f32)noise_graph::WormRegionDim) &&
+                    (Worms->MinRadius > 0.0f) && (Worms->MinRadius <= Worms->MaxRadius) &&
+                    (Worms->MinZ <= Worms->MaxZ);
+                Worms->CountPerRegion = Result ? (u32)Count : 0;
+                Worms->SegmentCount = Result ? (u32)SegmentCount : 0;
+            }
+        }
+        else
+        {
+            Result = false;
+        }
+    }
+
+    // NOTE(boti): Errors that aren't tied to a line are reported one past the last line
+    if (Result && ((Graph->Height.OpCount == 0) || !HasLastLayer))
+    {
+        Result = false;
+        LineNumber++;
+    }
+
+    if (ErrorLine)
+    {
+        *ErrorLine = Result ? 0 : LineNumber;
+    }
+    return(Result);
+}
+
+static void CompileDefaultNoiseGraph(noise_graph* Graph)
+{
+    buffer Source = { sizeof(DefaultNoiseGraphSource) - 1, (u8*)DefaultNoiseGraphSource };
+    bool IsValid = CompileNoiseGraph(Graph, Source);
+    assert(IsValid);
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <Common.hpp>
+#include <Chunk.hpp>
+
+//
+// Noise graph
+//
+// NOTE(boti): The shape of the terrain is described by a small line based text format,
+//             which gets compiled into flat lists of ops that the generator evaluates 8 columns/voxels at a time.
+//
+//             height <op>                      Appends an op to the column height program (2D)
+//             field <name> <op>                Appends an op to a 3D density field program, creates the field if needed
+//             layer <type> [depth]             Voxel layers below the surface, from the top. The last one has no depth and goes all the way down
+//             rule <from> <to> <field> <cmp> <threshold> [ceiling=<z>]
+//                                              Replaces <from> voxels (a type or "solid") with <to> where <field> <cmp> <threshold>,
+//                                              rules are applied in order. Above the ceiling the rule leaves the surface voxels alone.
+//             temperature <op>, humidity <op>  Appends an op to the climate programs (2D), these are only sampled on a coarse grid
+//             biome <name> <surface> temperature=<t> humidity=<h> [scale=<s>] [offset=<o>]
+//                                              A biome centered at (t, h) in climate space. Replaces the type of the top layer with <surface>
+//                                              and provides the height scale/offset for the biome op, blended with the nearby biomes.
+//             ore <type> count=<n> [min_radius=<r>] [max_radius=<r>] [min_z=<z>] [max_z=<z>]
+//                                              Places n (on average, can be fractional) spherical veins of <type> per column of chunks,
+//                                              centered between min_z and max_z. Veins only replace stone.
+//             worms count=<n> length=<l> [min_radius=<r>] [max_radius=<r>] [min_z=<z>] [max_z=<z>]
+//                                              Carves n tunnels per region of chunks (see WormRegionDim), each made of l segments.
+//                                              The tunnels start between min_z and max_z and never leave that range.
+//
+//             Without min_z/max_z the ores and worms stay in [0, 255], there's no default ceiling for the rules.
+//
+//             Ops:
+//             noise [frequency=f] [octaves=n] [persistence=p] [lacunarity=l]
+//                                              Adds octave noise sampled at the position (scaled by frequency)
+//             add <v>, mul <v>, square, fade3, round
+//             biome                            Height only: multiplies by the blended biome height scale and adds the offset,
+//                                              does nothing if there are no biomes
+//
+//             Everything after a '#' is a comment.
+
+enum noise_op_type : u32
+{
+    NoiseOp_Noise = 0,
+    NoiseOp_Add,
+    NoiseOp_Mul,
+    NoiseOp_Square,
+    NoiseOp_Fade3,
+    NoiseOp_Round,
+    NoiseOp_Biome,
+};
+
+struct noise_op
+{
+    noise_op_type Type;
+    f32 Value; // Add/Mul operand, noise frequency
+
+    // Noise only
+    u32 OctaveCount;
+    f32 Persistence;
+    f32 Lacunarity;
+};
+
+struct noise_program
+{
+    static constexpr u32 MaxOpCount = 16;
+    u32 OpCount;
+    noise_op Ops[MaxOpCount];
+};
+
+enum noise_compare : u32
+{
+    NoiseCompare_Less = 0,
+    NoiseCompare_Greater,
+};
+
+struct noise_rule
+{
+    u32 FromTypeMask; // Bit per voxel type, never includes air
+    u16 ToType;
+    u32 FieldIndex;
+    noise_compare Compare;
+    f32 Threshold;
+    s32 Ceiling;
+};
+
+struct noise_biome
+{
+    u16 SurfaceType;
+    f32 Temperature;
+    f32 Humidity;
+    f32 HeightScale;
+    f32 HeightOffset;
+};
+
+struct noise_ore
+{
+    u16 Type;
+    f32 CountPerChunk;
+    f32 MinRadius;
+    f32 MaxRadius;
+    s32 MinZ;
+    s32 MaxZ;
+};
+
+struct noise_worms
+{
+    u32 CountPerRegion; // 0 if there are no worm caves
+    u32 SegmentCount;   // Per worm
+    f32 MinRadius;
+    f32 MaxRadius;
+    s32 MinZ;
+    s32 MaxZ;
+};
+
+struct noise_graph
+{
+    noise_program Height;
+
+    static constexpr u32 MaxLayerCount = 8;
+    u32 LayerCount;
+    u16 LayerTypes[MaxLayerCount];
+    s32 LayerEndDepths[MaxLayerCount]; // Depth below the surface where each layer ends, ignored for the last one
+
+    static constexpr u32 MaxFieldCount = 8;
+    static constexpr u32 MaxFieldNameLength = 16;
+    u32 FieldCount;
+    char FieldNames[MaxFieldCount][MaxFieldNameLength];
+    noise_program Fields[MaxFieldCount];
+
+    static constexpr u32 MaxRuleCount = 16;
+    u32 RuleCount;
+    noise_rule Rules[MaxRuleCount];
+
+    noise_program Temperature;
+    noise_program Humidity;
+
+    // NOTE(boti): Biome indices are stored per column in chunk::Biomes
+    static constexpr u32 MaxBiomeCount = 8;
+    static constexpr u32 MaxBiomeNameLength = 16;
+    u32 BiomeCount;
+    char BiomeNames[MaxBiomeCount][MaxBiomeNameLength];
+    noise_biome Biomes[MaxBiomeCount];
+
+    // NOTE(boti): Veins can only reach into the immediate neighbors of the chunk they're placed in
+    static constexpr u32 MaxOreCount = 8;
+    static constexpr f32 MaxOreRadius = 8.0f;
+    static constexpr f32 MaxOreCountPerChunk = 16.0f;
+    u32 OreCount;
+    noise_ore Ores[MaxOreCount];
+
+    // NOTE(boti): Worms are limited so that they can only reach into the immediate neighbors of their region
+    static constexpr s32 WormRegionDim = 128;
+    static constexpr f32 WormStepLength = 2.0f;
+    static constexpr u32 MaxWormSegmentCountPerRegion = 1024;
+    noise_worms Worms;
+
+    static constexpr s32 DefaultRuleCeiling = 0x7FFFFFFF;
+    static constexpr s32 DefaultMinZ = 0;
+    static constexpr s32 DefaultMaxZ = 255;
+};
+
+// Returns false if the source is invalid, ErrorLine (if not null) is set to the line number (1-based) of the error
+static bool CompileNoiseGraph(noise_graph* Graph, buffer Source, u32* ErrorLine = nullptr);
+
+// The graph of the original hard-coded terrain
+static void CompileDefaultNoiseGraph(noise_graph* Graph);
@@ -3,6 +3,7 @@
 #include <Common.hpp>
 #include <Math.hpp>
 #include <Memory.hpp>
+#include <CPUFeatures.hpp>
 #include <imgui/imgui.h>
 
 typedef function<void(memory_arena*)> work_function;
@@ -240,4 +240,1002 @@ f32 OctaveNoise(const perlin3* Perlin, vec3 P0, u32 OctaveCount, f32 Persistence
     }
 
     return Result;
-}
\ No newline at end of file
+}
+
+//
+// Hash noise
+//
+
+// NOTE(boti): Multiplying by an odd constant is a bijection on u32 and so is the finalizer,
+//             so along any axis the hash can't repeat with a period shorter than 2^32.
+constexpr u32 HashNoise_PrimeX = 0x8DA6B343u;
+constexpr u32 HashNoise_PrimeY = 0xD8163841u;
+constexpr u32 HashNoise_PrimeZ = 0xCB1AB31Fu;
+
+static inline u32 HashNoise_Finalize(u32 Hash)
+{
+    Hash ^= Hash >> 16;
+    Hash *= 0x7FEB352Du;
+    Hash ^= Hash >> 15;
+    Hash *= 0x846CA68Bu;
+    Hash ^= Hash >> 16;
+    return Hash;
+}
+
+// Same gradients as perlin2
+static inline f32 HashNoise_Gradient2(u32 Hash, f32 x, f32 y)
+{
+    f32 Result = 0.0f;
+    switch (Hash & 7u)
+    {
+        case 0: Result = +x + y; break;
+        case 1: Result = -x + y; break;
+        case 2: Result = +x - y; break;
+        case 3: Result = -x - y; break;
+        case 4: Result = +y; break;
+        case 5: Result = -y; break;
+        case 6: Result = +x; break;
+        case 7: Result = -x; break;
+    }
+    return Result;
+}
+
+// Same gradients as perlin3
+static inline f32 HashNoise_Gradient3(u32 Hash, f32 x, f32 y, f32 z)
+{
+    f32 Result = 0.0f;
+    switch (Hash & 15u)
+    {
+        case 12:
+        case 0:  Result = +x + y; break;
+        case 13:
+        case 1:  Result = -x + y; break;
+        case 14:
+        case 2:  Result = +x - y; break;
+        case 15:
+        case 3:  Result = -x - y; break;
+        case 4:  Result = +x + z; break;
+        case 5:  Result = -x + z; break;
+        case 6:  Result = +x - z; break;
+        case 7:  Result = -x - z; break;
+        case 8:  Result = +y + z; break;
+        case 9:  Result = -y + z; break;
+        case 10: Result = +y - z; break;
+        case 11: Result = -y - z; break;
+    }
+    return Result;
+}
+
+void HashNoise_Init(hash_noise* Noise, u32 Seed)
+{
+    assert(Noise);
+    Noise->Seed = HashNoise_Finalize(Seed);
+}
+
+f32 SampleNoise(const hash_noise* Noise, vec2 P)
+{
+    vec2 LatticeP = Floor(P);
+    vec2 P0 = P - LatticeP;
+    vec2i Pi = { (s32)LatticeP.x, (s32)LatticeP.y };
+
+    u32 PrimedX[2] = { (u32)Pi.x * HashNoise_PrimeX, 0 };
+    u32 PrimedY[2] = { (u32)Pi.y * HashNoise_PrimeY, 0 };
+    PrimedX[1] = PrimedX[0] + HashNoise_PrimeX;
+    PrimedY[1] = PrimedY[0] + HashNoise_PrimeY;
+
+    f32 Vx[2] = { P0.x, P0.x - 1.0f };
+    f32 Vy[2] = { P0.y, P0.y - 1.0f };
+
+    f32 GdotV[2][2];
+    for (u32 x = 0; x < 2; x++)
+    {
+        for (u32 y = 0; y < 2; y++)
+        {
+            u32 Hash = HashNoise_Finalize(Noise->Seed ^ PrimedX[x] ^ PrimedY[y]);
+            GdotV[x][y] = HashNoise_Gradient2(Hash, Vx[x], Vy[y]);
+        }
+    }
+
+    vec2 Factor = { Fade5(P0.x), Fade5(P0.y), };
+
+    f32 Result = Blerp(
+        GdotV[0][0], GdotV[1][0],
+        GdotV[0][1], GdotV[1][1],
+        Factor);
+    return Result;
+}
+
+f32 SampleOctave(const hash_noise* Noise, vec2 P0, u32 OctaveCount, f32 Persistence, f32 Lacunarity)
+{
+    f32 Result = 0.0f;
+    f32 Amplitude = 1.0f;
+    f32 Frequency = 1.0f;
+
+    // NOTE(boti): Same domain transform as the perlin2 SampleOctave
+    constexpr f32 C = 84.0f / 85.0f;
+    constexpr f32 S = 13.0f / 85.0f;
+
+    mat2 DomainTransform = Mat2(
+        C, S,
+        -S, C
+    );
+    for (u32 i = 0; i < OctaveCount; i++)
+    {
+        vec2 P = Frequency * P0;
+        Result += Amplitude * SampleNoise(Noise, P);
+
+        Frequency *= Lacunarity;
+        Amplitude *= Persistence;
+
+        P0 = DomainTransform * P0;
+    }
+    return Result;
+}
+
+f32 SampleNoise(const hash_noise* Noise, vec3 P)
+{
+    vec3 LatticeP = Floor(P);
+    vec3 P0 = P - LatticeP;
+    vec3i Pi = (vec3i)LatticeP;
+
+    u32 PrimedX[2] = { (u32)Pi.x * HashNoise_PrimeX, 0 };
+    u32 PrimedY[2] = { (u32)Pi.y * HashNoise_PrimeY, 0 };
+    u32 PrimedZ[2] = { (u32)Pi.z * HashNoise_PrimeZ, 0 };
+    PrimedX[1] = PrimedX[0] + HashNoise_PrimeX;
+    PrimedY[1] = PrimedY[0] + HashNoise_PrimeY;
+    PrimedZ[1] = PrimedZ[0] + HashNoise_PrimeZ;
+
+    f32 Vx[2] = { P0.x, P0.x - 1.0f };
+    f32 Vy[2] = { P0.y, P0.y - 1.0f };
+    f32 Vz[2] = { P0.z, P0.z - 1.0f };
+
+    f32 GdotV[2][2][2];
+    for (u32 x = 0; x < 2; x++)
+    {
+        for (u32 y = 0; y < 2; y++)
+        {
+            for (u32 z = 0; z < 2; z++)
+            {
+                u32 Hash = HashNoise_Finalize(Noise->Seed ^ PrimedX[x] ^ PrimedY[y] ^ PrimedZ[z]);
+                GdotV[x][y][z] = HashNoise_Gradient3(Hash, Vx[x], Vy[y], Vz[z]);
+            }
+        }
+    }
+
+    vec3 Factor = { Fade5(P0.x), Fade5(P0.y), Fade5(P0.z) };
+
+    f32 Result = Trilerp(
+        GdotV[0][0][0], GdotV[1][0][0], GdotV[0][1][0], GdotV[1][1][0],
+        GdotV[0][0][1], GdotV[1][0][1], GdotV[0][1][1], GdotV[1][1][1],
+        Factor);
+    return Result;
+}
+
+f32 OctaveNoise(const hash_noise* Noise, vec3 P0, u32 OctaveCount, f32 Persistence, f32 Lacunarity)
+{
+    f32 Result = 0.0f;
+
+    f32 Amplitude = 1.0f;
+    f32 Frequency = 1.0f;
+    for (u32 i = 0; i < OctaveCount; i++)
+    {
+        vec3 P = Frequency * P0;
+        Result += Amplitude * SampleNoise(Noise, P);
+
+        Frequency *= Lacunarity;
+        Amplitude *= Persistence;
+    }
+
+    return Result;
+}
+
+//
+// Simplex noise
+//
+
+// NOTE(boti): Skewing factors between the cubic and the simplex (tetrahedral) lattice in 3D
+constexpr f32 Simplex3_F3 = 1.0f / 3.0f;
+constexpr f32 Simplex3_G3 = 1.0f / 6.0f;
+// Scales the sum of the corner contributions to roughly [-1, 1]
+constexpr f32 Simplex3_Scale = 32.0f;
+
+void Simplex3_Init(simplex3* Simplex, u32 Seed)
+{
+    assert(Simplex);
+    // NOTE(boti): Different from the hash noise seed so that the two backends don't produce correlated lattices
+    Simplex->Seed = HashNoise_Finalize(Seed ^ 0x5BD1E995u);
+}
+
+// Contribution of a single simplex corner, (x, y, z) is the position relative to the corner
+static inline f32 Simplex3_Contribution(u32 Hash, f32 x, f32 y, f32 z)
+{
+    f32 t = 0.6f - x*x - y*y - z*z;
+    t = (t > 0.0f) ? t : 0.0f;
+    t = t * t;
+    f32 Result = t * t * HashNoise_Gradient3(Hash, x, y, z);
+    return Result;
+}
+
+f32 SampleNoise(const simplex3* Simplex, vec3 P)
+{
+    // Skew the position into the lattice of cubes made up of 6 tetrahedra each
+    f32 Skew = (P.x + P.y + P.z) * Simplex3_F3;
+    f32 i = Floor(P.x + Skew);
+    f32 j = Floor(P.y + Skew);
+    f32 k = Floor(P.z + Skew);
+    f32 Unskew = (i + j + k) * Simplex3_G3;
+
+    // Position relative to the origin corner
+    f32 x0 = P.x - (i - Unskew);
+    f32 y0 = P.y - (j - Unskew);
+    f32 z0 = P.z - (k - Unskew);
+
+    // Find the tetrahedron we're in from the order of the relative coordinates,
+    // the 2nd and 3rd corners are offset by (i1, j1, k1) and (i2, j2, k2)
+    bool XY = x0 >= y0;
+    bool XZ = x0 >= z0;
+    bool YZ = y0 >= z0;
+    u32 i1 = XY && XZ;
+    u32 j1 = !XY && YZ;
+    u32 k1 = !XZ && !YZ;
+    u32 i2 = XY || XZ;
+    u32 j2 = !XY || YZ;
+    u32 k2 = !(XZ && YZ);
+
+    f32 x1 = x0 - (f32)i1 + Simplex3_G3;
+    f32 y1 = y0 - (f32)j1 + Simplex3_G3;
+    f32 z1 = z0 - (f32)k1 + Simplex3_G3;
+    f32 x2 = x0 - (f32)i2 + 2.0f * Simplex3_G3;
+    f32 y2 = y0 - (f32)j2 + 2.0f * Simplex3_G3;
+    f32 z2 = z0 - (f32)k2 + 2.0f * Simplex3_G3;
+    f32 x3 = x0 - 1.0f + 3.0f * Simplex3_G3;
+    f32 y3 = y0 - 1.0f + 3.0f * Simplex3_G3;
+    f32 z3 = z0 - 1.0f + 3.0f * Simplex3_G3;
+
+    u32 PrimedX = (u32)(s32)i * HashNoise_PrimeX;
+    u32 PrimedY = (u32)(s32)j * HashNoise_PrimeY;
+    u32 PrimedZ = (u32)(s32)k * HashNoise_PrimeZ;
+
+    // NOTE(boti): The seed has to be applied after the corner offsets, otherwise neighboring simplices wouldn't agree on the shared corners
+    u32 Hash0 = HashNoise_Finalize(Simplex->Seed ^ PrimedX ^ PrimedY ^ PrimedZ);
+    u32 Hash1 = HashNoise_Finalize(Simplex->Seed ^ (PrimedX + i1 * HashNoise_PrimeX) ^ (PrimedY + j1 * HashNoise_PrimeY) ^ (PrimedZ + k1 * HashNoise_PrimeZ));
+    u32 Hash2 = HashNoise_Finalize(Simplex->Seed ^ (PrimedX + i2 * HashNoise_PrimeX) ^ (PrimedY + j2 * HashNoise_PrimeY) ^ (PrimedZ + k2 * HashNoise_PrimeZ));
+    u32 Hash3 = HashNoise_Finalize(Simplex->Seed ^ (PrimedX + HashNoise_PrimeX) ^ (PrimedY + HashNoise_PrimeY) ^ (PrimedZ + HashNoise_PrimeZ));
+
+    f32 Result = 
+        Simplex3_Contribution(Hash0, x0, y0, z0) +
+        Simplex3_Contribution(Hash1, x1, y1, z1) +
+        Simplex3_Contribution(Hash2, x2, y2, z2) +
+        Simplex3_Contribution(Hash3, x3, y3, z3);
+    Result = Simplex3_Scale * Result;
+    return Result;
+}
+
+f32 OctaveNoise(const simplex3* Simplex, vec3 P0, u32 OctaveCount, f32 Persistence, f32 Lacunarity)
+{
+    f32 Result = 0.0f;
+
+    f32 Amplitude = 1.0f;
+    f32 Frequency = 1.0f;
+    for (u32 i = 0; i < OctaveCount; i++)
+    {
+        vec3 P = Frequency * P0;
+        Result += Amplitude * SampleNoise(Simplex, P);
+
+        Frequency *= Lacunarity;
+        Amplitude *= Persistence;
+    }
+
+    return Result;
+}
+
+//
+// Counter-based random numbers
+//
+
+// NOTE(boti): Multipliers and key increments (Weyl sequence) from the Philox paper
+static constexpr u32 Philox_M0 = 0xD2511F53u;
+static constexpr u32 Philox_M1 = 0xCD9E8D57u;
+static constexpr u32 Philox_W0 = 0x9E3779B9u;
+static constexpr u32 Philox_W1 = 0xBB67AE85u;
+static constexpr u32 Philox_RoundCount = 10;
+
+static inline u32 Philox_MulHiLo(u32 a, u32 b, u32* Hi)
+{
+    u64 Product = (u64)a * (u64)b;
+    *Hi = (u32)(Product >> 32);
+    return (u32)Product;
+}
+
+void Philox4x32(const u32 Counter[4], const u32 Key[2], u32 Out[4])
+{
+    u32 c0 = Counter[0], c1 = Counter[1], c2 = Counter[2], c3 = Counter[3];
+    u32 k0 = Key[0], k1 = Key[1];
+    for (u32 Round = 0; Round < Philox_RoundCount; Round++)
+    {
+        if (Round > 0)
+        {
+            k0 += Philox_W0;
+            k1 += Philox_W1;
+        }
+
+        u32 Hi0, Hi1;
+        u32 Lo0 = Philox_MulHiLo(Philox_M0, c0, &Hi0);
+        u32 Lo1 = Philox_MulHiLo(Philox_M1, c2, &Hi1);
+        c0 = Hi1 ^ c1 ^ k0;
+        c1 = Lo1;
+        c2 = Hi0 ^ c3 ^ k1;
+        c3 = Lo0;
+    }
+    Out[0] = c0;
+    Out[1] = c1;
+    Out[2] = c2;
+    Out[3] = c3;
+}
+
+u32 RandomU32(const random_stream* Stream, u32 Index)
+{
+    u32 Counter[4] = { Index, (u32)Stream->P.x, (u32)Stream->P.y, Stream->Purpose };
+    u32 Key[2] = { Stream->Seed, 0 };
+    u32 Out[4];
+    Philox4x32(Counter, Key, Out);
+    return Out[0];
+}
+
+f32 RandomUnilateral(const random_stream* Stream, u32 Index)
+{
+    f32 Result = (f32)(RandomU32(Stream, Index) >> 8) * (1.0f / 16777216.0f);
+    return Result;
+}
+
+//
+// 8-wide
+//
+
+// NOTE(boti): The helpers below intentionally mirror the operation order of the scalar code
+//             (Lerp, Fade5 and the gradient switches) and don't use FMA,
+//             so that the batched noise is bit-exact with the scalar one under -fp:strict.
+TARGET_AVX2 static inline __m256 Lerp8(__m256 a, __m256 b, __m256 t)
+{
+    __m256 Result = _mm256_add_ps(
+        _mm256_mul_ps(a, _mm256_sub_ps(_mm256_set1_ps(1.0f), t)),
+        _mm256_mul_ps(b, t));
+    return Result;
+}
+
+TARGET_AVX2 static inline __m256 Fade5_8(__m256 t)
+{
+    __m256 Result = _mm256_mul_ps(_mm256_set1_ps(6.0f), t);
+    Result = _mm256_sub_ps(Result, _mm256_set1_ps(15.0f));
+    Result = _mm256_mul_ps(Result, t);
+    Result = _mm256_add_ps(Result, _mm256_set1_ps(10.0f));
+    Result = _mm256_mul_ps(Result, t);
+    Result = _mm256_mul_ps(Result, t);
+    Result = _mm256_mul_ps(Result, t);
+    return Result;
+}
+
+// Moves bit "Bit" of each lane into the sign bit, which is what blendv and the sign flips below look at
+TARGET_AVX2 static inline __m256 HashBitToSign8(__m256i Hash, int Bit)
+{
+    __m256 Result = _mm256_castsi256_ps(_mm256_slli_epi32(Hash, 31 - Bit));
+    return Result;
+}
+
+TARGET_AVX2 static inline __m256 SignMask8(__m256i Hash, int Bit)
+{
+    __m256 Result = _mm256_and_ps(HashBitToSign8(Hash, Bit), _mm256_castsi256_ps(_mm256_set1_epi32((s32)0x80000000u)));
+    return Result;
+}
+
+TARGET_AVX2 static inline __m256 Gradient2_8(__m256i Hash, __m256 X, __m256 Y)
+{
+    // Hash & 3 in [0, 3]: (+-x) + (+-y)
+    __m256 Sum = _mm256_add_ps(
+        _mm256_xor_ps(X, SignMask8(Hash, 0)),
+        _mm256_xor_ps(Y, SignMask8(Hash, 1)));
+
+    // Hash & 7 in [4, 7]: +-y, +-y, +-x, +-x
+    __m256 Single = _mm256_blendv_ps(Y, X, HashBitToSign8(Hash, 1));
+    Single = _mm256_xor_ps(Single, SignMask8(Hash, 0));
+
+    __m256 Result = _mm256_blendv_ps(Sum, Single, HashBitToSign8(Hash, 2));
+    return Result;
+}
+
+TARGET_AVX2 static inline __m256 Gradient3_8(__m256i Hash, __m256 X, __m256 Y, __m256 Z)
+{
+    // Hash & 15: [0, 3] and [12, 15] -> (x, y), [4, 7] -> (x, z), [8, 11] -> (y, z)
+    __m256 Bit2 = HashBitToSign8(Hash, 2);
+    __m256 Bit3 = HashBitToSign8(Hash, 3);
+    __m256 U = _mm256_blendv_ps(X, Y, _mm256_andnot_ps(Bit2, Bit3));
+    __m256 V = _mm256_blendv_ps(Y, Z, _mm256_xor_ps(Bit2, Bit3));
+
+    __m256 Result = _mm256_add_ps(
+        _mm256_xor_ps(U, SignMask8(Hash, 0)),
+        _mm256_xor_ps(V, SignMask8(Hash, 1)));
+    return Result;
+}
+
+TARGET_AVX2 __m256 SampleNoise8(const perlin2* Perlin, __m256 X, __m256 Y)
+{
+    __m256 LatticeX = _mm256_floor_ps(X);
+    __m256 LatticeY = _mm256_floor_ps(Y);
+    __m256 X0 = _mm256_sub_ps(X, LatticeX);
+    __m256 Y0 = _mm256_sub_ps(Y, LatticeY);
+    __m256 X1 = _mm256_sub_ps(X0, _mm256_set1_ps(1.0f));
+    __m256 Y1 = _mm256_sub_ps(Y0, _mm256_set1_ps(1.0f));
+    __m256i Xi = _mm256_cvttps_epi32(LatticeX);
+    __m256i Yi = _mm256_cvttps_epi32(LatticeY);
+
+    const __m256i One = _mm256_set1_epi32(1);
+    const __m256i Mask = _mm256_set1_epi32(perlin2::TableCount - 1);
+    const int* Table = (const int*)Perlin->Permutation;
+
+    __m256i IndexX0 = _mm256_and_si256(Xi, Mask);
+    __m256i IndexX1 = _mm256_and_si256(_mm256_add_epi32(Xi, One), Mask);
+    __m256i IndexY0 = _mm256_i32gather_epi32(Table, _mm256_and_si256(Yi, Mask), 4);
+    __m256i IndexY1 = _mm256_i32gather_epi32(Table, _mm256_and_si256(_mm256_add_epi32(Yi, One), Mask), 4);
+
+    __m256i Hash00 = _mm256_i32gather_epi32(Table, _mm256_and_si256(_mm256_add_epi32(IndexX0, IndexY0), Mask), 4);
+    __m256i Hash10 = _mm256_i32gather_epi32(Table, _mm256_and_si256(_mm256_add_epi32(IndexX1, IndexY0), Mask), 4);
+    __m256i Hash01 = _mm256_i32gather_epi32(Table, _mm256_and_si256(_mm256_add_epi32(IndexX0, IndexY1), Mask), 4);
+    __m256i Hash11 = _mm256_i32gather_epi32(Table, _mm256_and_si256(_mm256_add_epi32(IndexX1, IndexY1), Mask), 4);
+
+    __m256 GdotV00 = Gradient2_8(Hash00, X0, Y0);
+    __m256 GdotV10 = Gradient2_8(Hash10, X1, Y0);
+    __m256 GdotV01 = Gradient2_8(Hash01, X0, Y1);
+    __m256 GdotV11 = Gradient2_8(Hash11, X1, Y1);
+
+    __m256 FactorX = Fade5_8(X0);
+    __m256 FactorY = Fade5_8(Y0);
+
+    __m256 Result = Lerp8(
+        Lerp8(GdotV00, GdotV10, FactorX),
+        Lerp8(GdotV01, GdotV11, FactorX),
+        FactorY);
+    return Result;
+}
+
+TARGET_AVX2 __m256 SampleOctave8(const perlin2* Perlin, __m256 X, __m256 Y, u32 OctaveCount, f32 Persistence, f32 Lacunarity)
+{
+    __m256 Result = _mm256_setzero_ps();
+    f32 Amplitude = 1.0f;
+    f32 Frequency = 1.0f;
+
+    // NOTE(boti): Must match the domain transform in the scalar SampleOctave
+    constexpr f32 C = 84.0f / 85.0f;
+    constexpr f32 S = 13.0f / 85.0f;
+    const __m256 C8 = _mm256_set1_ps(C);
+    const __m256 S8 = _mm256_set1_ps(S);
+    const __m256 NegS8 = _mm256_set1_ps(-S);
+
+    for (u32 i = 0; i < OctaveCount; i++)
+    {
+        __m256 Frequency8 = _mm256_set1_ps(Frequency);
+        __m256 Sample = SampleNoise8(Perlin, _mm256_mul_ps(Frequency8, X), _mm256_mul_ps(Frequency8, Y));
+        Result = _mm256_add_ps(Result, _mm256_mul_ps(_mm256_set1_ps(Amplitude), Sample));
+
+        Frequency *= Lacunarity;
+        Amplitude *= Persistence;
+
+        __m256 NewX = _mm256_add_ps(_mm256_mul_ps(C8, X), _mm256_mul_ps(S8, Y));
+        __m256 NewY = _mm256_add_ps(_mm256_mul_ps(NegS8, X), _mm256_mul_ps(C8, Y));
+        X = NewX;
+        Y = NewY;
+    }
+    return Result;
+}
+
+TARGET_AVX2 __m256 SampleNoise8(const perlin3* Perlin, __m256 X, __m256 Y, __m256 Z)
+{
+    __m256 LatticeX = _mm256_floor_ps(X);
+    __m256 LatticeY = _mm256_floor_ps(Y);
+    __m256 LatticeZ = _mm256_floor_ps(Z);
+
+    // Relative position to each corner, [0] = P0, [1] = P0 - 1
+    __m256 Vx[2], Vy[2], Vz[2];
+    Vx[0] = _mm256_sub_ps(X, LatticeX);
+    Vy[0] = _mm256_sub_ps(Y, LatticeY);
+    Vz[0] = _mm256_sub_ps(Z, LatticeZ);
+    Vx[1] = _mm256_sub_ps(Vx[0], _mm256_set1_ps(1.0f));
+    Vy[1] = _mm256_sub_ps(Vy[0], _mm256_set1_ps(1.0f));
+    Vz[1] = _mm256_sub_ps(Vz[0], _mm256_set1_ps(1.0f));
+
+    __m256i Xi = _mm256_cvttps_epi32(LatticeX);
+    __m256i Yi = _mm256_cvttps_epi32(LatticeY);
+    __m256i Zi = _mm256_cvttps_epi32(LatticeZ);
+
+    constexpr u32 Mask = perlin3::TableCount - 1;
+    const __m256i Mask8 = _mm256_set1_epi32(Mask);
+    const int* Table = (const int*)Perlin->Permutation;
+
+    __m256 GdotV[2][2][2];
+    for (u32 z = 0; z < 2; z++)
+    {
+        __m256i IndexZ = _mm256_i32gather_epi32(Table, _mm256_and_si256(_mm256_add_epi32(Zi, _mm256_set1_epi32(z)), Mask8), 4);
+        for (u32 y = 0; y < 2; y++)
+        {
+            __m256i IndexY = _mm256_add_epi32(_mm256_add_epi32(Yi, _mm256_set1_epi32(y)), IndexZ);
+            IndexY = _mm256_i32gather_epi32(Table, _mm256_and_si256(IndexY, Mask8), 4);
+            for (u32 x = 0; x < 2; x++)
+            {
+                __m256i IndexX = _mm256_add_epi32(_mm256_add_epi32(Xi, _mm256_set1_epi32(x)), IndexY);
+                __m256i Hash = _mm256_i32gather_epi32(Table, _mm256_and_si256(IndexX, Mask8), 4);
+                GdotV[x][y][z] = Gradient3_8(Hash, Vx[x], Vy[y], Vz[z]);
+            }
+        }
+    }
+
+    __m256 FactorX = Fade5_8(Vx[0]);
+    __m256 FactorY = Fade5_8(Vy[0]);
+    __m256 FactorZ = Fade5_8(Vz[0]);
+
+    __m256 Z0 = Lerp8(
+        Lerp8(GdotV[0][0][0], GdotV[1][0][0], FactorX),
+        Lerp8(GdotV[0][1][0], GdotV[1][1][0], FactorX),
+        FactorY);
+    __m256 Z1 = Lerp8(
+        Lerp8(GdotV[0][0][1], GdotV[1][0][1], FactorX),
+        Lerp8(GdotV[0][1][1], GdotV[1][1][1], FactorX),
+        FactorY);
+    __m256 Result = Lerp8(Z0, Z1, FactorZ);
+    return Result;
+}
+
+TARGET_AVX2 __m256 OctaveNoise8(const perlin3* Perlin, __m256 X, __m256 Y, __m256 Z, u32 OctaveCount, f32 Persistence, f32 Lacunarity)
+{
+    __m256 Result = _mm256_setzero_ps();
+
+    f32 Amplitude = 1.0f;
+    f32 Frequency = 1.0f;
+    for (u32 i = 0; i < OctaveCount; i++)
+    {
+        __m256 Frequency8 = _mm256_set1_ps(Frequency);
+        __m256 Sample = SampleNoise8(Perlin, 
+                                     _mm256_mul_ps(Frequency8, X),
+                                     _mm256_mul_ps(Frequency8, Y),
+                                     _mm256_mul_ps(Frequency8, Z));
+        Result = _mm256_add_ps(Result, _mm256_mul_ps(_mm256_set1_ps(Amplitude), Sample));
+
+        Frequency *= Lacunarity;
+        Amplitude *= Persistence;
+    }
+
+    return Result;
+}
+
+TARGET_AVX2 static inline __m256i HashNoise_Finalize8(__m256i Hash)
+{
+    Hash = _mm256_xor_si256(Hash, _mm256_srli_epi32(Hash, 16));
+    Hash = _mm256_mullo_epi32(Hash, _mm256_set1_epi32((s32)0x7FEB352Du));
+    Hash = _mm256_xor_si256(Hash, _mm256_srli_epi32(Hash, 15));
+    Hash = _mm256_mullo_epi32(Hash, _mm256_set1_epi32((s32)0x846CA68Bu));
+    Hash = _mm256_xor_si256(Hash, _mm256_srli_epi32(Hash, 16));
+    return Hash;
+}
+
+TARGET_AVX2 __m256 SampleNoise8(const hash_noise* Noise, __m256 X, __m256 Y)
+{
+    __m256 LatticeX = _mm256_floor_ps(X);
+    __m256 LatticeY = _mm256_floor_ps(Y);
+
+    __m256 Vx[2], Vy[2];
+    Vx[0] = _mm256_sub_ps(X, LatticeX);
+    Vy[0] = _mm256_sub_ps(Y, LatticeY);
+    Vx[1] = _mm256_sub_ps(Vx[0], _mm256_set1_ps(1.0f));
+    Vy[1] = _mm256_sub_ps(Vy[0], _mm256_set1_ps(1.0f));
+
+    const __m256i PrimeX = _mm256_set1_epi32((s32)HashNoise_PrimeX);
+    const __m256i PrimeY = _mm256_set1_epi32((s32)HashNoise_PrimeY);
+    __m256i PrimedX[2], PrimedY[2];
+    PrimedX[0] = _mm256_mullo_epi32(_mm256_cvttps_epi32(LatticeX), PrimeX);
+    PrimedY[0] = _mm256_mullo_epi32(_mm256_cvttps_epi32(LatticeY), PrimeY);
+    PrimedX[1] = _mm256_add_epi32(PrimedX[0], PrimeX);
+    PrimedY[1] = _mm256_add_epi32(PrimedY[0], PrimeY);
+    PrimedX[0] = _mm256_xor_si256(PrimedX[0], _mm256_set1_epi32((s32)Noise->Seed));
+    PrimedX[1] = _mm256_xor_si256(PrimedX[1], _mm256_set1_epi32((s32)Noise->Seed));
+
+    __m256 GdotV[2][2];
+    for (u32 y = 0; y < 2; y++)
+    {
+        for (u32 x = 0; x < 2; x++)
+        {
+            __m256i Hash = HashNoise_Finalize8(_mm256_xor_si256(PrimedX[x], PrimedY[y]));
+            GdotV[x][y] = Gradient2_8(Hash, Vx[x], Vy[y]);
+        }
+    }
+
+    __m256 FactorX = Fade5_8(Vx[0]);
+    __m256 FactorY = Fade5_8(Vy[0]);
+
+    __m256 Result = Lerp8(
+        Lerp8(GdotV[0][0], GdotV[1][0], FactorX),
+        Lerp8(GdotV[0][1], GdotV[1][1], FactorX),
+        FactorY);
+    return Result;
+}
+
+TARGET_AVX2 __m256 SampleOctave8(const hash_noise* Noise, __m256 X, __m256 Y, u32 OctaveCount, f32 Persistence, f32 Lacunarity)
+{
+    __m256 Result = _mm256_setzero_ps();
+    f32 Amplitude = 1.0f;
+    f32 Frequency = 1.0f;
+
+    // NOTE(boti): Must match the domain transform in the scalar SampleOctave
+    constexpr f32 C = 84.0f / 85.0f;
+    constexpr f32 S = 13.0f / 85.0f;
+    const __m256 C8 = _mm256_set1_ps(C);
+    const __m256 S8 = _mm256_set1_ps(S);
+    const __m256 NegS8 = _mm256_set1_ps(-S);
+
+    for (u32 i = 0; i < OctaveCount; i++)
+    {
+        __m256 Frequency8 = _mm256_set1_ps(Frequency);
+        __m256 Sample = SampleNoise8(Noise, _mm256_mul_ps(Frequency8, X), _mm256_mul_ps(Frequency8, Y));
+        Result = _mm256_add_ps(Result, _mm256_mul_ps(_mm256_set1_ps(Amplitude), Sample));
+
+        Frequency *= Lacunarity;
+        Amplitude *= Persistence;
+
+        __m256 NewX = _mm256_add_ps(_mm256_mul_ps(C8, X), _mm256_mul_ps(S8, Y));
+        __m256 NewY = _mm256_add_ps(_mm256_mul_ps(NegS8, X), _mm256_mul_ps(C8, Y));
+        X = NewX;
+        Y = NewY;
+    }
+    return Result;
+}
+
+TARGET_AVX2 __m256 SampleNoise8(const hash_noise* Noise, __m256 X, __m256 Y, __m256 Z)
+{
+    __m256 LatticeX = _mm256_floor_ps(X);
+    __m256 LatticeY = _mm256_floor_ps(Y);
+    __m256 LatticeZ = _mm256_floor_ps(Z);
+
+    __m256 Vx[2], Vy[2], Vz[2];
+    Vx[0] = _mm256_sub_ps(X, LatticeX);
+    Vy[0] = _mm256_sub_ps(Y, LatticeY);
+    Vz[0] = _mm256_sub_ps(Z, LatticeZ);
+    Vx[1] = _mm256_sub_ps(Vx[0], _mm256_set1_ps(1.0f));
+    Vy[1] = _mm256_sub_ps(Vy[0], _mm256_set1_ps(1.0f));
+    Vz[1] = _mm256_sub_ps(Vz[0], _mm256_set1_ps(1.0f));
+
+    const __m256i PrimeX = _mm256_set1_epi32((s32)HashNoise_PrimeX);
+    const __m256i PrimeY = _mm256_set1_epi32((s32)HashNoise_PrimeY);
+    const __m256i PrimeZ = _mm256_set1_epi32((s32)HashNoise_PrimeZ);
+    __m256i PrimedX[2], PrimedY[2], PrimedZ[2];
+    PrimedX[0] = _mm256_mullo_epi32(_mm256_cvttps_epi32(LatticeX), PrimeX);
+    PrimedY[0] = _mm256_mullo_epi32(_mm256_cvttps_epi32(LatticeY), PrimeY);
+    PrimedZ[0] = _mm256_mullo_epi32(_mm256_cvttps_epi32(LatticeZ), PrimeZ);
+    PrimedX[1] = _mm256_add_epi32(PrimedX[0], PrimeX);
+    PrimedY[1] = _mm256_add_epi32(PrimedY[0], PrimeY);
+    PrimedZ[1] = _mm256_add_epi32(PrimedZ[0], PrimeZ);
+    PrimedZ[0] = _mm256_xor_si256(PrimedZ[0], _mm256_set1_epi32((s32)Noise->Seed));
+    PrimedZ[1] = _mm256_xor_si256(PrimedZ[1], _mm256_set1_epi32((s32)Noise->Seed));
+
+    __m256 GdotV[2][2][2];
+    for (u32 z = 0; z < 2; z++)
+    {
+        for (u32 y = 0; y < 2; y++)
+        {
+            __m256i HashYZ = _mm256_xor_si256(PrimedY[y], PrimedZ[z]);
+            for (u32 x = 0; x < 2; x++)
+            {
+                __m256i Hash = HashNoise_Finalize8(_mm256_xor_si256(PrimedX[x], HashYZ));
+                GdotV[x][y][z] = Gradient3_8(Hash, Vx[x], Vy[y], Vz[z]);
+            }
+        }
+    }
+
+    __m256 FactorX = Fade5_8(Vx[0]);
+    __m256 FactorY = Fade5_8(Vy[0]);
+    __m256 FactorZ = Fade5_8(Vz[0]);
+
+    __m256 Z0 = Lerp8(
+        Lerp8(GdotV[0][0][0], GdotV[1][0][0], FactorX),
+        Lerp8(GdotV[0][1][0], GdotV[1][1][0], FactorX),
+        FactorY);
+    __m256 Z1 = Lerp8(
+        Lerp8(GdotV[0][0][1], GdotV[1][0][1], FactorX),
+        Lerp8(GdotV[0][1][1], GdotV[1][1][1], FactorX),
+        FactorY);
+    __m256 Result = Lerp8(Z0, Z1, FactorZ);
+    return Result;
+}
+
+TARGET_AVX2 __m256 OctaveNoise8(const hash_noise* Noise, __m256 X, __m256 Y, __m256 Z, u32 OctaveCount, f32 Persistence, f32 Lacunarity)
+{
+    __m256 Result = _mm256_setzero_ps();
+
+    f32 Amplitude = 1.0f;
+    f32 Frequency = 1.0f;
+    for (u32 i = 0; i < OctaveCount; i++)
+    {
+        __m256 Frequency8 = _mm256_set1_ps(Frequency);
+        __m256 Sample = SampleNoise8(Noise, 
+                                     _mm256_mul_ps(Frequency8, X),
+                                     _mm256_mul_ps(Frequency8, Y),
+                                     _mm256_mul_ps(Frequency8, Z));
+        Result = _mm256_add_ps(Result, _mm256_mul_ps(_mm256_set1_ps(Amplitude), Sample));
+
+        Frequency *= Lacunarity;
+        Amplitude *= Persistence;
+    }
+
+    return Result;
+}
+
+TARGET_AVX2 static inline __m256 Simplex3_Contribution8(__m256i Hash, __m256 X, __m256 Y, __m256 Z)
+{
+    __m256 t = _mm256_sub_ps(_mm256_set1_ps(0.6f), _mm256_mul_ps(X, X));
+    t = _mm256_sub_ps(t, _mm256_mul_ps(Y, Y));
+    t = _mm256_sub_ps(t, _mm256_mul_ps(Z, Z));
+    t = _mm256_and_ps(t, _mm256_cmp_ps(t, _mm256_setzero_ps(), _CMP_GT_OQ));
+    t = _mm256_mul_ps(t, t);
+    __m256 Result = _mm256_mul_ps(_mm256_mul_ps(t, t), Gradient3_8(Hash, X, Y, Z));
+    return Result;
+}
+
+TARGET_AVX2 __m256 SampleNoise8(const simplex3* Simplex, __m256 X, __m256 Y, __m256 Z)
+{
+    __m256 Skew = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(X, Y), Z), _mm256_set1_ps(Simplex3_F3));
+    __m256 i = _mm256_floor_ps(_mm256_add_ps(X, Skew));
+    __m256 j = _mm256_floor_ps(_mm256_add_ps(Y, Skew));
+    __m256 k = _mm256_floor_ps(_mm256_add_ps(Z, Skew));
+    __m256 Unskew = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(i, j), k), _mm256_set1_ps(Simplex3_G3));
+
+    __m256 X0 = _mm256_sub_ps(X, _mm256_sub_ps(i, Unskew));
+    __m256 Y0 = _mm256_sub_ps(Y, _mm256_sub_ps(j, Unskew));
+    __m256 Z0 = _mm256_sub_ps(Z, _mm256_sub_ps(k, Unskew));
+
+    // NOTE(boti): All-ones lane masks, same logic as the scalar version
+    __m256i XY = _mm256_castps_si256(_mm256_cmp_ps(X0, Y0, _CMP_GE_OQ));
+    __m256i XZ = _mm256_castps_si256(_mm256_cmp_ps(X0, Z0, _CMP_GE_OQ));
+    __m256i YZ = _mm256_castps_si256(_mm256_cmp_ps(Y0, Z0, _CMP_GE_OQ));
+    __m256i I1 = _mm256_and_si256(XY, XZ);
+    __m256i J1 = _mm256_andnot_si256(XY, YZ);
+    __m256i K1 = _mm256_andnot_si256(_mm256_or_si256(XZ, YZ), _mm256_set1_epi32(-1));
+    __m256i I2 = _mm256_or_si256(XY, XZ);
+    __m256i J2 = _mm256_or_si256(_mm256_xor_si256(XY, _mm256_set1_epi32(-1)), YZ);
+    __m256i K2 = _mm256_xor_si256(_mm256_and_si256(XZ, YZ), _mm256_set1_epi32(-1));
+
+    const __m256 One = _mm256_set1_ps(1.0f);
+    const __m256 G3 = _mm256_set1_ps(Simplex3_G3);
+    const __m256 G3x2 = _mm256_set1_ps(2.0f * Simplex3_G3);
+    const __m256 G3x3 = _mm256_set1_ps(3.0f * Simplex3_G3);
+    __m256 X1 = _mm256_add_ps(_mm256_sub_ps(X0, _mm256_and_ps(_mm256_castsi256_ps(I1), One)), G3);
+    __m256 Y1 = _mm256_add_ps(_mm256_sub_ps(Y0, _mm256_and_ps(_mm256_castsi256_ps(J1), One)), G3);
+    __m256 Z1 = _mm256_add_ps(_mm256_sub_ps(Z0, _mm256_and_ps(_mm256_castsi256_ps(K1), One)), G3);
+    __m256 X2 = _mm256_add_ps(_mm256_sub_ps(X0, _mm256_and_ps(_mm256_castsi256_ps(I2), One)), G3x2);
+    __m256 Y2 = _mm256_add_ps(_mm256_sub_ps(Y0, _mm256_and_ps(_mm256_castsi256_ps(J2), One)), G3x2);
+    __m256 Z2 = _mm256_add_ps(_mm256_sub_ps(Z0, _mm256_and_ps(_mm256_castsi256_ps(K2), One)), G3x2);
+    __m256 X3 = _mm256_add_ps(_mm256_sub_ps(X0, One), G3x3);
+    __m256 Y3 = _mm256_add_ps(_mm256_sub_ps(Y0, One), G3x3);
+    __m256 Z3 = _mm256_add_ps(_mm256_sub_ps(Z0, One), G3x3);
+
+    const __m256i PrimeX = _mm256_set1_epi32((s32)HashNoise_PrimeX);
+    const __m256i PrimeY = _mm256_set1_epi32((s32)HashNoise_PrimeY);
+    const __m256i PrimeZ = _mm256_set1_epi32((s32)HashNoise_PrimeZ);
+    __m256i PrimedX = _mm256_mullo_epi32(_mm256_cvttps_epi32(i), PrimeX);
+    __m256i PrimedY = _mm256_mullo_epi32(_mm256_cvttps_epi32(j), PrimeY);
+    __m256i PrimedZ = _mm256_mullo_epi32(_mm256_cvttps_epi32(k), PrimeZ);
+    const __m256i Seed = _mm256_set1_epi32((s32)Simplex->Seed);
+
+    __m256i Hash0 = HashNoise_Finalize8(_mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(Seed, PrimedX), PrimedY), PrimedZ));
+    __m256i Hash1 = HashNoise_Finalize8(_mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(Seed,
+        _mm256_add_epi32(PrimedX, _mm256_and_si256(I1, PrimeX))),
+        _mm256_add_epi32(PrimedY, _mm256_and_si256(J1, PrimeY))),
+        _mm256_add_epi32(PrimedZ, _mm256_and_si256(K1, PrimeZ))));
+    __m256i Hash2 = HashNoise_Finalize8(_mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(Seed,
+        _mm256_add_epi32(PrimedX, _mm256_and_si256(I2, PrimeX))),
+        _mm256_add_epi32(PrimedY, _mm256_and_si256(J2, PrimeY))),
+        _mm256_add_epi32(PrimedZ, _mm256_and_si256(K2, PrimeZ))));
+    __m256i Hash3 = HashNoise_Finalize8(_mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(Seed,
+        _mm256_add_epi32(PrimedX, PrimeX)),
+        _mm256_add_epi32(PrimedY, PrimeY)),
+        _mm256_add_epi32(PrimedZ, PrimeZ)));
+
+    __m256 Result = _mm256_add_ps(
+        _mm256_add_ps(
+            _mm256_add_ps(Simplex3_Contribution8(Hash0, X0, Y0, Z0), Simplex3_Contribution8(Hash1, X1, Y1, Z1)),
+            Simplex3_Contribution8(Hash2, X2, Y2, Z2)),
+        Simplex3_Contribution8(Hash3, X3, Y3, Z3));
+    Result = _mm256_mul_ps(_mm256_set1_ps(Simplex3_Scale), Result);
+    return Result;
+}
+
+TARGET_AVX2 __m256 OctaveNoise8(const simplex3* Simplex, __m256 X, __m256 Y, __m256 Z, u32 OctaveCount, f32 Persistence, f32 Lacunarity)
+{
+    __m256 Result = _mm256_setzero_ps();
+
+    f32 Amplitude = 1.0f;
+    f32 Frequency = 1.0f;
+    for (u32 i = 0; i < OctaveCount; i++)
+    {
+        __m256 Frequency8 = _mm256_set1_ps(Frequency);
+        __m256 Sample = SampleNoise8(Simplex, 
+                                     _mm256_mul_ps(Frequency8, X),
+                                     _mm256_mul_ps(Frequency8, Y),
+                                     _mm256_mul_ps(Frequency8, Z));
+        Result = _mm256_add_ps(Result, _mm256_mul_ps(_mm256_set1_ps(Amplitude), Sample));
+
+        Frequency *= Lacunarity;
+        Amplitude *= Persistence;
+    }
+
+    return Result;
+}
+
+// NOTE(boti): _mm256_mul_epu32 only multiplies the even lanes, so the odd lanes get shifted down for a second multiply
+TARGET_AVX2 static inline __m256i Philox_MulHiLo8(u32 a, __m256i b, __m256i* Hi)
+{
+    __m256i A = _mm256_set1_epi32((s32)a);
+    __m256i EvenProduct = _mm256_mul_epu32(A, b);
+    __m256i OddProduct = _mm256_mul_epu32(A, _mm256_srli_epi64(b, 32));
+    *Hi = _mm256_blend_epi32(_mm256_srli_epi64(EvenProduct, 32), OddProduct, 0xAA);
+    __m256i Lo = _mm256_blend_epi32(EvenProduct, _mm256_slli_epi64(OddProduct, 32), 0xAA);
+    return Lo;
+}
+
+TARGET_AVX2 void Philox4x32_8(const __m256i Counter[4], const u32 Key[2], __m256i Out[4])
+{
+    __m256i c0 = Counter[0], c1 = Counter[1], c2 = Counter[2], c3 = Counter[3];
+    u32 k0 = Key[0], k1 = Key[1];
+    for (u32 Round = 0; Round < Philox_RoundCount; Round++)
+    {
+        if (Round > 0)
+        {
+            k0 += Philox_W0;
+            k1 += Philox_W1;
+        }
+
+        __m256i Hi0, Hi1;
+        __m256i Lo0 = Philox_MulHiLo8(Philox_M0, c0, &Hi0);
+        __m256i Lo1 = Philox_MulHiLo8(Philox_M1, c2, &Hi1);
+        c0 = _mm256_xor_si256(_mm256_xor_si256(Hi1, c1), _mm256_set1_epi32((s32)k0));
+        c1 = Lo1;
+        c2 = _mm256_xor_si256(_mm256_xor_si256(Hi0, c3), _mm256_set1_epi32((s32)k1));
+        c3 = Lo0;
+    }
+    Out[0] = c0;
+    Out[1] = c1;
+    Out[2] = c2;
+    Out[3] = c3;
+}
+
+TARGET_AVX2 __m256i RandomU32_8(const random_stream* Stream, __m256i Index)
+{
+    __m256i Counter[4] = 
+    {
+        Index,
+        _mm256_set1_epi32(Stream->P.x),
+        _mm256_set1_epi32(Stream->P.y),
+        _mm256_set1_epi32((s32)Stream->Purpose),
+    };
+    u32 Key[2] = { Stream->Seed, 0 };
+    __m256i Out[4];
+    Philox4x32_8(Counter, Key, Out);
+    return Out[0];
+}
+
+TARGET_AVX2 __m256 RandomUnilateral8(const random_stream* Stream, __m256i Index)
+{
+    // NOTE(boti): The top 24 bits convert to float exactly, same as the scalar path
+    __m256i Bits = _mm256_srli_epi32(RandomU32_8(Stream, Index), 8);
+    __m256 Result = _mm256_mul_ps(_mm256_cvtepi32_ps(Bits), _mm256_set1_ps(1.0f / 16777216.0f));
+    return Result;
+}
+
+//
+// Compile-time specialized octave noise
+//
+
+u32 GetSpecializedOctaveCount(u32 OctaveCount, f32 Persistence, f32 Lacunarity)
+{
+    u32 Result = 0;
+#if BLOKKER_SPECIALIZED_OCTAVES
+    if ((Persistence == 0.5f) && (Lacunarity == 2.0f) && (OctaveCount <= MaxSpecializedOctaveCount))
+    {
+        Result = OctaveCount;
+    }
+#endif
+    return(Result);
+}
+
+template<u32 OctaveCount, f32 Persistence, f32 Lacunarity, typename noise_t>
+f32 SampleOctave(const noise_t* Noise, vec2 P0)
+{
+    static constexpr octave_table<OctaveCount, Persistence, Lacunarity> Table;
+
+    // NOTE(boti): Same domain transform as the runtime version.
+    //             The rotation is applied iteratively (instead of using precomputed powers of it) to get the exact same bits,
+    //             it's a short dependency chain compared to the noise samples anyway.
+    constexpr f32 C = 84.0f / 85.0f;
+    constexpr f32 S = 13.0f / 85.0f;
+    const mat2 DomainTransform = Mat2(
+        C, S,
+        -S, C
+    );
+
+    vec2 Ps[OctaveCount];
+    for (u32 i = 0; i < OctaveCount; i++)
+    {
+        Ps[i] = Table.Frequencies[i] * P0;
+        P0 = DomainTransform * P0;
+    }
+
+    f32 Result = 0.0f;
+    for (u32 i = 0; i < OctaveCount; i++)
+    {
+        Result += Table.Amplitudes[i] * SampleNoise(Noise, Ps[i]);
+    }
+    return Result;
+}
+
+template<u32 OctaveCount, f32 Persistence, f32 Lacunarity, typename noise_t>
+f32 OctaveNoise(const noise_t* Noise, vec3 P0)
+{
+    static constexpr octave_table<OctaveCount, Persistence, Lacunarity> Table;
+
+    f32 Result = 0.0f;
+    for (u32 i = 0; i < OctaveCount; i++)
+    {
+        Result += Table.Amplitudes[i] * SampleNoise(Noise, Table.Frequencies[i] * P0);
+    }
+    return Result;
+}
+
+template<u32 OctaveCount, f32 Persistence, f32 Lacunarity, typename noise_t>
+TARGET_AVX2 __m256 SampleOctave8(const noise_t* Noise, __m256 X, __m256 Y)
+{
+    static constexpr octave_table<OctaveCount, Persistence, Lacunarity> Table;
+
+    constexpr f32 C = 84.0f / 85.0f;
+    constexpr f32 S = 13.0f / 85.0f;
+    const __m256 C8 = _mm256_set1_ps(C);
+    const __m256 S8 = _mm256_set1_ps(S);
+    const __m256 NegS8 = _mm256_set1_ps(-S);
+
+    __m256 Samples[OctaveCount];
+    for (u32 i = 0; i < OctaveCount; i++)
+    {
+        __m256 Frequency8 = _mm256_set1_ps(Table.Frequencies[i]);
+        Samples[i] = SampleNoise8(Noise, _mm256_mul_ps(Frequency8, X), _mm256_mul_ps(Frequency8, Y));
+
+        __m256 NewX = _mm256_add_ps(_mm256_mul_ps(C8, X), _mm256_mul_ps(S8, Y));
+        __m256 NewY = _mm256_add_ps(_mm256_mul_ps(NegS8, X), _mm256_mul_ps(C8, Y));
+        X = NewX;
+        Y = NewY;
+    }
+
+    __m256 Result = _mm256_setzero_ps();
+    for (u32 i = 0; i < OctaveCount; i++)
+    {
+        Result = _mm256_add_ps(Result, _mm256_mul_ps(_mm256_set1_ps(Table.Amplitudes[i]), Samples[i]));
+    }
+    return Result;
+}
+
+template<u32 OctaveCount, f32 Persistence, f32 Lacunarity, typename noise_t>
+TARGET_AVX2 __m256 OctaveNoise8(const noise_t* Noise, __m256 X, __m256 Y, __m256 Z)
+{
+    static constexpr octave_table<OctaveCount, Persistence, Lacunarity> Table;
+
+    // NOTE(boti): The octaves are independent of each other, they're only summed at the end (in the same order as the runtime loop)
+    __m256 Samples[OctaveCount];
+    for (u32 i = 0; i < OctaveCount; i++)
+    {
+        __m256 Frequency8 = _mm256_set1_ps(Table.Frequencies[i]);
+        Samples[i] = SampleNoise8(Noise, 
+                                  _mm256_mul_ps(Frequency8, X),
+                                  _mm256_mul_ps(Frequency8, Y),
+                                  _mm256_mul_ps(Frequency8, Z));
+    }
+
+    __m256 Result = _mm256_setzero_ps();
+    for (u32 i = 0; i < OctaveCount; i++)
+    {
+        Result = _mm256_add_ps(Result, _mm256_mul_ps(_mm256_set1_ps(Table.Amplitudes[i]), Samples[i]));
+    }
+    return Result;
+}
@@ -24,6 +24,12 @@ f32 SampleNoise(const perlin2* Perlin, vec2 P);
 f32 SampleOctave(const perlin2* Perlin, vec2 P, u32 OctaveCount, f32 Persistence, f32 Lacunarity);
 f32 SampleNoise01(const perlin2* Perlin, vec2 P);
 
+// NOTE(boti): The 8-wide versions sample 8 independent points per call
+//             and produce the exact same bits as their scalar counterparts.
+//             Like everything else that takes or returns __m256, they're TARGET_AVX2 (see CPUFeatures.hpp).
+TARGET_AVX2 __m256 SampleNoise8(const perlin2* Perlin, __m256 X, __m256 Y);
+TARGET_AVX2 __m256 SampleOctave8(const perlin2* Perlin, __m256 X, __m256 Y, u32 OctaveCount, f32 Persistence, f32 Lacunarity);
+
 struct perlin3
 {
     static constexpr u32 TableCount = 256;
@@ -32,4 +38,133 @@ struct perlin3
 
 void Perlin3_Init(perlin3* Perlin, u32 Seed);
 f32 SampleNoise(const perlin3* Perlin, vec3 P);
-f32 OctaveNoise(const perlin3* Perlin, vec3 P, u32 OctaveCount, f32 Persistence, f32 Lacunarity);
\ No newline at end of file
+f32 OctaveNoise(const perlin3* Perlin, vec3 P, u32 OctaveCount, f32 Persistence, f32 Lacunarity);
+
+TARGET_AVX2 __m256 SampleNoise8(const perlin3* Perlin, __m256 X, __m256 Y, __m256 Z);
+TARGET_AVX2 __m256 OctaveNoise8(const perlin3* Perlin, __m256 X, __m256 Y, __m256 Z, u32 OctaveCount, f32 Persistence, f32 Lacunarity);
+
+// NOTE(boti): Gradient noise that hashes the lattice coordinates (and the seed) instead of looking them up
+//             in a permutation table. This means it doesn't repeat every 256 lattice cells like perlin2/3,
+//             and it doesn't need any gathers when vectorized.
+//             The gradient sets are the same as perlin2/3.
+struct hash_noise
+{
+    u32 Seed;
+};
+
+void HashNoise_Init(hash_noise* Noise, u32 Seed);
+f32 SampleNoise(const hash_noise* Noise, vec2 P);
+f32 SampleOctave(const hash_noise* Noise, vec2 P, u32 OctaveCount, f32 Persistence, f32 Lacunarity);
+f32 SampleNoise(const hash_noise* Noise, vec3 P);
+f32 OctaveNoise(const hash_noise* Noise, vec3 P, u32 OctaveCount, f32 Persistence, f32 Lacunarity);
+
+TARGET_AVX2 __m256 SampleNoise8(const hash_noise* Noise, __m256 X, __m256 Y);
+TARGET_AVX2 __m256 SampleOctave8(const hash_noise* Noise, __m256 X, __m256 Y, u32 OctaveCount, f32 Persistence, f32 Lacunarity);
+TARGET_AVX2 __m256 SampleNoise8(const hash_noise* Noise, __m256 X, __m256 Y, __m256 Z);
+TARGET_AVX2 __m256 OctaveNoise8(const hash_noise* Noise, __m256 X, __m256 Y, __m256 Z, u32 OctaveCount, f32 Persistence, f32 Lacunarity);
+
+// NOTE(boti): 3D simplex noise, hashed the same way as hash_noise.
+//             Each sample only blends the 4 corners of the tetrahedron it's in (instead of the 8 corners of a cube),
+//             and there's no trilinear interpolation. It looks different from perlin3, features aren't aligned to the axes.
+struct simplex3
+{
+    u32 Seed;
+};
+
+void Simplex3_Init(simplex3* Simplex, u32 Seed);
+f32 SampleNoise(const simplex3* Simplex, vec3 P);
+f32 OctaveNoise(const simplex3* Simplex, vec3 P, u32 OctaveCount, f32 Persistence, f32 Lacunarity);
+
+TARGET_AVX2 __m256 SampleNoise8(const simplex3* Simplex, __m256 X, __m256 Y, __m256 Z);
+TARGET_AVX2 __m256 OctaveNoise8(const simplex3* Simplex, __m256 X, __m256 Y, __m256 Z, u32 OctaveCount, f32 Persistence, f32 Lacunarity);
+
+//
+// Counter-based random numbers
+//
+// NOTE(boti): Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+//             Every number is a pure function of its stream and index, there's no state that advances,
+//             so worker threads can draw the same numbers in any order and any grouping.
+//             Draws that need to stay stable when other draws are added should get their own range of indices.
+//
+enum random_purpose : u32
+{
+    RandomPurpose_Trees = 1,
+    RandomPurpose_OreVeins,
+    RandomPurpose_WormCaves,
+};
+
+struct random_stream
+{
+    u32 Seed;
+    vec2i P; // Position of whatever the numbers are for, e.g. a chunk or a region
+    u32 Purpose;
+};
+
+inline random_stream RandomStream(u32 Seed, vec2i P, u32 Purpose)
+{
+    random_stream Result = { Seed, P, Purpose };
+    return(Result);
+}
+
+// The full Philox block, Out gets 4 independent 32-bit numbers
+void Philox4x32(const u32 Counter[4], const u32 Key[2], u32 Out[4]);
+
+u32 RandomU32(const random_stream* Stream, u32 Index);
+// Uniform in [0, 1)
+f32 RandomUnilateral(const random_stream* Stream, u32 Index);
+
+// NOTE(boti): 8 lanes of independent counters/indices, same bits as the scalar versions
+TARGET_AVX2 void Philox4x32_8(const __m256i Counter[4], const u32 Key[2], __m256i Out[4]);
+TARGET_AVX2 __m256i RandomU32_8(const random_stream* Stream, __m256i Index);
+TARGET_AVX2 __m256 RandomUnilateral8(const random_stream* Stream, __m256i Index);
+
+//
+// Compile-time specialized octave noise
+//
+// NOTE(boti): Same results as the runtime SampleOctave/OctaveNoise(8) with the same parameters,
+//             but the octave count is known, so the loop gets fully unrolled and the octaves can be interleaved,
+//             and the amplitudes/frequencies are constants.
+//             Works with any of the noise types above that have the matching SampleNoise(8).
+//
+
+// NOTE(boti): Evaluate the octave noise with the versions specialized on the octave count when possible
+//             (the noise ops in WorldGen and the 2D noise kernels)
+#ifndef BLOKKER_SPECIALIZED_OCTAVES
+#define BLOKKER_SPECIALIZED_OCTAVES 1
+#endif
+constexpr u32 MaxSpecializedOctaveCount = 8;
+
+// Returns the octave count to specialize on, 0 if the parameters can only go through the runtime loops
+u32 GetSpecializedOctaveCount(u32 OctaveCount, f32 Persistence, f32 Lacunarity);
+
+template<u32 OctaveCount, f32 Persistence = 0.5f, f32 Lacunarity = 2.0f>
+struct octave_table
+{
+    static_assert(OctaveCount > 0);
+    f32 Amplitudes[OctaveCount];
+    f32 Frequencies[OctaveCount];
+
+    constexpr octave_table() : Amplitudes(), Frequencies()
+    {
+        // NOTE(boti): Must be accumulated the same way as in the runtime loops
+        f32 Amplitude = 1.0f;
+        f32 Frequency = 1.0f;
+        for (u32 i = 0; i < OctaveCount; i++)
+        {
+            Amplitudes[i] = Amplitude;
+            Frequencies[i] = Frequency;
+            Frequency *= Lacunarity;
+            Amplitude *= Persistence;
+        }
+    }
+};
+
+template<u32 OctaveCount, f32 Persistence = 0.5f, f32 Lacunarity = 2.0f, typename noise_t>
+f32 SampleOctave(const noise_t* Noise, vec2 P);
+template<u32 OctaveCount, f32 Persistence = 0.5f, f32 Lacunarity = 2.0f, typename noise_t>
+f32 OctaveNoise(const noise_t* Noise, vec3 P);
+
+template<u32 OctaveCount, f32 Persistence = 0.5f, f32 Lacunarity = 2.0f, typename noise_t>
+TARGET_AVX2 __m256 SampleOctave8(const noise_t* Noise, __m256 X, __m256 Y);
+template<u32 OctaveCount, f32 Persistence = 0.5f, f32 Lacunarity = 2.0f, typename noise_t>
+TARGET_AVX2 __m256 OctaveNoise8(const noise_t* Noise, __m256 X, __m256 Y, __m256 Z);
@@ -67,7 +67,7 @@ struct render_frame
     u32 MaxDrawCount;
     u32 DrawCount;
     draw_cmd* DrawList;
-    vec2* DrawPositions;
+    vec3* DrawPositions;
 };
 
 struct renderer_init_info
@@ -93,7 +93,7 @@ vertex_buffer_block* AllocateAndUploadVertexBlock(render_frame* Frame, u64 HeadS
 bool UploadVertexBlock(render_frame* Frame, vertex_buffer_block* Block, u64 HeadSize, const void* Head, u64 TailSize, const void* Tail);
 void FreeVertexBlock(render_frame* Frame, vertex_buffer_block* Block);
 
-void RenderVertexBlock(render_frame* Frame, vertex_buffer_block* Block, vec2 P);
+void RenderVertexBlock(render_frame* Frame, vertex_buffer_block* Block, vec3 P);
 void RenderImGui(render_frame* Frame, const ImDrawData* DrawData);
 
 enum class outline_type : u32
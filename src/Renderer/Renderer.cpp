@@ -64,7 +64,7 @@ render_frame* BeginRenderFrame(renderer* Renderer, bool DoResize)
 
     Frame->DrawCount = 0;
     Frame->DrawList = (draw_cmd*)Frame->DrawMapping;
-    Frame->DrawPositions = (vec2*)Frame->PositionMapping;
+    Frame->DrawPositions = (vec3*)Frame->PositionMapping;
     Frame->VertexOffset = 0;
 
     {
@@ -500,7 +500,7 @@ vertex_buffer_block* AllocateAndUploadVertexBlock(render_frame* Frame,
     return(Block);
 }
 
-void RenderVertexBlock(render_frame* Frame, vertex_buffer_block* VertexBlock, vec2 P)
+void RenderVertexBlock(render_frame* Frame, vertex_buffer_block* VertexBlock, vec3 P)
 {
     if (Frame->DrawCount < Frame->MaxDrawCount)
     {
@@ -1423,7 +1423,7 @@ renderer* CreateRenderer(memory_arena* Arena, memory_arena* TransientArena,
             // (instanced) chunk positions
             {
                 .binding = 1,
-                .stride = sizeof(vec2),
+                .stride = sizeof(vec3),
                 .inputRate = VK_VERTEX_INPUT_RATE_INSTANCE,
             },
         };
@@ -1449,7 +1449,7 @@ renderer* CreateRenderer(memory_arena* Arena, memory_arena* TransientArena,
             {
                 .location = ATTRIB_CHUNK_P,
                 .binding = 1,
-                .format = VK_FORMAT_R32G32_SFLOAT,
+                .format = VK_FORMAT_R32G32B32_SFLOAT,
                 .offset = 0,
             },
 
@@ -2867,7 +2867,7 @@ static bool Renderer_InitializeFrameParams(renderer* Renderer)
 
         // Create per frame instance data
         {
-            u64 InstanceDataMemorySize = DrawCountPerFrame * sizeof(vec2);
+            u64 InstanceDataMemorySize = DrawCountPerFrame * sizeof(vec3);
             VkBufferCreateInfo BufferInfo = 
             {
                 .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
@@ -0,0 +1,2263 @@
+//
+// Headless benchmarks
+//
+// Usage: bench.exe [ChunkCountSqrt] [Seed] [SliceBitmapPath]
+//
+// If SliceBitmapPath is given, a z-slice of each 3D noise backend is written there (side by side)
+// as a 24-bit BMP for visual comparison.
+//
+
+#include <Common.hpp>
+#include <Intrinsics.hpp>
+#include <Math.hpp>
+#include <Float.hpp>
+#include <Memory.hpp>
+#include <Random.hpp>
+#include <Shapes.hpp>
+#include <Profiler.hpp>
+
+#include <imgui/imgui.h>
+#include <Renderer/RenderAPI.hpp>
+
+#include <Chunk.hpp>
+#include <WorldGen.hpp>
+
+#include <Windows.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "Random.cpp"
+#include "Kernels.cpp"
+#include "ChunkData.cpp"
+#include "Shapes.cpp"
+#include "NoiseGraph.cpp"
+#include "WorldGen.cpp"
+
+static s64 Bench_PerformanceFrequency;
+static chunk_section_pool Bench_SectionPool;
+
+// NOTE(boti): The benches work on columns of chunks covering world z [0, 256) (same as the chunk files),
+//             so the numbers stay comparable with the ones from before the chunks were cubes.
+constexpr s32 BENCH_COLUMN_CHUNK_COUNT = 16;
+
+// Zero initialized chunk data that allocates its sections from the bench pool
+static chunk_data* Bench_PushChunkData(memory_arena* Arena, u32 Count)
+{
+    chunk_data* Result = PushArray<chunk_data>(Arena, Count);
+    if (Result)
+    {
+        for (u32 i = 0; i < Count; i++)
+        {
+            Result[i] = {};
+            Result[i].Pool = &Bench_SectionPool;
+        }
+    }
+    return(Result);
+}
+
+static s64 Bench_GetCounter()
+{
+    LARGE_INTEGER Counter;
+    QueryPerformanceCounter(&Counter);
+    return Counter.QuadPart;
+}
+
+static f64 Bench_GetElapsedTime(s64 Start, s64 End)
+{
+    f64 Result = (f64)(End - Start) / (f64)Bench_PerformanceFrequency;
+    return Result;
+}
+
+// FNV-1a of the unpacked voxels, so the hashes don't depend on how the chunk data is stored.
+// Hash is the running hash to continue from, so that a whole column can be hashed chunk by chunk.
+static u64 HashChunkData(const chunk_data* Data, memory_arena* Arena, u64 Hash = 0xCBF29CE484222325llu)
+{
+    memory_arena_checkpoint Checkpoint = ArenaCheckpoint(Arena);
+    chunk_voxels* Voxels = PushStruct<chunk_voxels>(Arena);
+    UnpackChunkData(Data, Voxels);
+
+    u64 Result = Hash;
+    const u8* At = (const u8*)Voxels;
+    for (u64 i = 0; i < sizeof(chunk_voxels); i++)
+    {
+        Result ^= At[i];
+        Result *= 0x100000001B3llu;
+    }
+
+    RestoreArena(Arena, Checkpoint);
+    return Result;
+}
+
+// Number of columns where the chunk's highest non-air/lowest air voxels don't match its data
+static u32 CountColumnBoundsMismatches(const chunk* Chunk, memory_arena* Arena)
+{
+    memory_arena_checkpoint Checkpoint = ArenaCheckpoint(Arena);
+    chunk_voxels* Voxels = PushStruct<chunk_voxels>(Arena);
+    UnpackChunkData(Chunk->Data, Voxels);
+
+    u32 Result = 0;
+    for (s32 y = 0; y < CHUNK_DIM_XY; y++)
+    {
+        for (s32 x = 0; x < CHUNK_DIM_XY; x++)
+        {
+            s32 HighestNonAirZ = -1;
+            s32 LowestAirZ = CHUNK_DIM_Z;
+            for (s32 z = CHUNK_DIM_Z - 1; z >= 0; z--)
+            {
+                if (Voxels->Voxels[z][y][x] == VOXEL_AIR)
+                {
+                    LowestAirZ = z;
+                }
+                else
+                {
+                    HighestNonAirZ = Max(HighestNonAirZ, z);
+                }
+            }
+            if ((HighestNonAirZ != Chunk->HighestNonAirZ[y][x]) || (LowestAirZ != Chunk->LowestAirZ[y][x]))
+            {
+                Result++;
+            }
+        }
+    }
+
+    RestoreArena(Arena, Checkpoint);
+    return(Result);
+}
+
+// Number of (y, z) rows where the chunk's opaque/solid masks don't match its data
+static u32 CountVoxelMaskMismatches(const chunk* Chunk, memory_arena* Arena)
+{
+    memory_arena_checkpoint Checkpoint = ArenaCheckpoint(Arena);
+    chunk_voxels* Voxels = PushStruct<chunk_voxels>(Arena);
+    UnpackChunkData(Chunk->Data, Voxels);
+
+    u32 Result = 0;
+    for (s32 z = 0; z < CHUNK_DIM_Z; z++)
+    {
+        for (s32 y = 0; y < CHUNK_DIM_XY; y++)
+        {
+            u32 OpaqueRow = 0;
+            u32 SolidRow = 0;
+            for (s32 x = 0; x < CHUNK_DIM_XY; x++)
+            {
+                OpaqueRow |= (IsOpaqueVoxel(Voxels->Voxels[z][y][x]) ? 1u : 0u) << x;
+                SolidRow |= (IsSolidVoxel(Voxels->Voxels[z][y][x]) ? 1u : 0u) << x;
+            }
+            if ((OpaqueRow != Chunk->OpaqueMask[z][y]) || (SolidRow != Chunk->SolidMask[z][y]))
+            {
+                Result++;
+            }
+        }
+    }
+
+    RestoreArena(Arena, Checkpoint);
+    return(Result);
+}
+
+// NOTE(boti): This is the scalar, per-voxel generator from before the 8-wide port.
+//             It's kept here as the baseline that the real Generate is timed and validated against.
+static void Generate_Reference(chunk* Chunk, const world_generator* Gen, memory_arena* Arena)
+{
+    memory_arena_checkpoint Checkpoint = ArenaCheckpoint(Arena);
+    chunk_voxels* Voxels = PushStruct<chunk_voxels>(Arena);
+
+    vec2 ChunkP = { (f32)Chunk->P.x, (f32)Chunk->P.y };
+    for (u32 y = 0; y < CHUNK_DIM_XY; y++)
+    {
+        for (u32 x = 0; x < CHUNK_DIM_XY; x++)
+        {
+            constexpr f32 TerrainBaseFrequency = 1.0f / 64.0f;
+            constexpr f32 TerrainBaseScale = 32.0f;
+            constexpr u32 TerrainBaseHeight = 80;
+
+            vec2 TerrainP = TerrainBaseFrequency * (vec2{ (f32)x, (f32)y } + ChunkP);
+
+            f32 TerrainSample = SampleOctave(&Gen->Perlin2, TerrainP, 8, 0.5f, 2.0f);
+            TerrainSample = 0.5f * (TerrainSample + 1.0f);
+            TerrainSample = Fade3(TerrainSample*TerrainSample);
+            s32 Height = (s32)Round(TerrainBaseScale * TerrainSample) + TerrainBaseHeight;
+
+            for (u32 z = 0; z < CHUNK_DIM_Z; z++)
+            {
+                s32 WorldZ = Chunk->P.z + (s32)z;
+                if (WorldZ > Height)
+                {
+                    Voxels->Voxels[z][y][x] = VOXEL_AIR;
+                }
+                else if (WorldZ > Height - 3)
+                {
+                    Voxels->Voxels[z][y][x] = VOXEL_GROUND;
+                }
+                else
+                {
+                    Voxels->Voxels[z][y][x] = VOXEL_STONE;
+                }
+
+                vec3 P = vec3{ x + ChunkP.x, y + ChunkP.y, (f32)WorldZ };
+
+                constexpr f32 OreScale = 1.0f / 8.0f;
+                f32 OreSample = OctaveNoise(&Gen->Perlin3, OreScale*P, 3, 0.5f, 2.0f);
+                if (Voxels->Voxels[z][y][x] == VOXEL_STONE)
+                {
+                    if (OreSample > 0.75f)
+                    {
+                        Voxels->Voxels[z][y][x] = VOXEL_COAL;
+                    }
+                    else if (OreSample < -0.75f)
+                    {
+                        Voxels->Voxels[z][y][x] = VOXEL_IRON;
+                    }
+                }
+
+                constexpr f32 CaveScale = 1.0f / 16.0f;
+                f32 CaveSample = OctaveNoise(&Gen->Perlin3, CaveScale*P, 1, 0.5f, 2.0f);
+                if (CaveSample < -0.5f && ((WorldZ < (s32)(TerrainBaseHeight + (u32)TerrainBaseScale)) || (WorldZ < Height)))
+                {
+                    Voxels->Voxels[z][y][x] = VOXEL_AIR;
+                }
+            }
+        }
+    }
+
+    PackChunkData(Chunk->Data, Voxels);
+    RestoreArena(Arena, Checkpoint);
+}
+
+typedef void (generate_func)(chunk* Chunk, const world_generator* Generator, memory_arena* Arena);
+
+// Generates a square of chunk columns centered on the origin, returns the time spent generating in seconds
+static f64 BenchGenerate(const world_generator* Generator, generate_func* Func, 
+                         s32 ChunkCountSqrt, chunk_data* Data, u64* Hashes, memory_arena* Arena)
+{
+    f64 Result = 0.0;
+
+    chunk Chunk = {};
+    Chunk.Data = Data;
+    for (s32 y = 0; y < ChunkCountSqrt; y++)
+    {
+        for (s32 x = 0; x < ChunkCountSqrt; x++)
+        {
+            u64 Hash = 0xCBF29CE484222325llu;
+            for (s32 z = 0; z < BENCH_COLUMN_CHUNK_COUNT; z++)
+            {
+                Chunk.P = vec3i{ x - ChunkCountSqrt / 2, y - ChunkCountSqrt / 2, z } * CHUNK_DIM_XY;
+
+                s64 StartCounter = Bench_GetCounter();
+                Func(&Chunk, Generator, Arena);
+                s64 EndCounter = Bench_GetCounter();
+                Result += Bench_GetElapsedTime(StartCounter, EndCounter);
+
+                Hash = HashChunkData(Data, Arena, Hash);
+            }
+            Hashes[x + y * ChunkCountSqrt] = Hash;
+        }
+    }
+
+    return Result;
+}
+
+// Generates every chunk both at full rate and with the density lattice,
+// and reports how much the voxel classification differs between the two
+static void BenchDensityLattice(world_generator* Generator, u32 Spacing, s32 ChunkCountSqrt,
+                                chunk_data* ReferenceData, chunk_data* Data, memory_arena* Arena)
+{
+    u64 VoxelCount = 0;
+    u64 MismatchCount = 0;
+    u64 SolidMismatchCount = 0;
+    u64 OreMismatchCount = 0;
+    f64 Time = 0.0;
+
+    chunk_voxels* ReferenceVoxels = PushStruct<chunk_voxels>(Arena);
+    chunk_voxels* Voxels = PushStruct<chunk_voxels>(Arena);
+
+    chunk ReferenceChunk = {};
+    chunk Chunk = {};
+    ReferenceChunk.Data = ReferenceData;
+    Chunk.Data = Data;
+    for (s32 y = 0; y < ChunkCountSqrt; y++)
+    {
+        for (s32 x = 0; x < ChunkCountSqrt; x++)
+        {
+            for (s32 z = 0; z < BENCH_COLUMN_CHUNK_COUNT; z++)
+            {
+                vec3i P = vec3i{ x - ChunkCountSqrt / 2, y - ChunkCountSqrt / 2, z } * CHUNK_DIM_XY;
+                ReferenceChunk.P = P;
+                Chunk.P = P;
+
+                Generator->DensityLatticeSpacing = 1;
+                Generate(&ReferenceChunk, Generator, Arena);
+
+                Generator->DensityLatticeSpacing = Spacing;
+                s64 StartCounter = Bench_GetCounter();
+                Generate(&Chunk, Generator, Arena);
+                s64 EndCounter = Bench_GetCounter();
+                Time += Bench_GetElapsedTime(StartCounter, EndCounter);
+
+                UnpackChunkData(ReferenceData, ReferenceVoxels);
+                UnpackChunkData(Data, Voxels);
+                for (u32 i = 0; i < CHUNK_DIM_Z * CHUNK_DIM_XY * CHUNK_DIM_XY; i++)
+                {
+                    u16 ReferenceType = (&ReferenceVoxels->Voxels[0][0][0])[i];
+                    u16 Type = (&Voxels->Voxels[0][0][0])[i];
+                    if (ReferenceType != Type)
+                    {
+                        MismatchCount++;
+                        if ((ReferenceType == VOXEL_AIR) != (Type == VOXEL_AIR))
+                        {
+                            SolidMismatchCount++;
+                        }
+                        else
+                        {
+                            OreMismatchCount++;
+                        }
+                    }
+                }
+                VoxelCount += CHUNK_DIM_Z * CHUNK_DIM_XY * CHUNK_DIM_XY;
+            }
+        }
+    }
+    Generator->DensityLatticeSpacing = 1;
+
+    // NOTE(boti): 3 ore octaves + 1 cave octave per sample point.
+    //             This is an upper bound, Generate skips the samples that can't affect the result.
+    u32 SamplePointCount = GENERATOR_DIM_Z * CHUNK_DIM_XY * CHUNK_DIM_XY;
+    if (Spacing > 1)
+    {
+        u32 CountXY = CHUNK_DIM_XY / Spacing + 1;
+        u32 CountZ = (GENERATOR_DIM_Z - 1) / Spacing + 2;
+        SamplePointCount = (u32)AlignToPow2(CountXY * CountXY * CountZ, 8);
+    }
+    SamplePointCount *= BENCH_COLUMN_CHUNK_COUNT;
+
+    u32 ChunkCount = (u32)(ChunkCountSqrt * ChunkCountSqrt);
+    printf("  Spacing %2u: %8.2f columns/s (%.2fms/column), %7u max noise samples/column, "
+           "mismatching voxels: %.3f%% (air/solid: %.3f%%, ore: %.3f%%)\n",
+           Spacing, ChunkCount / Time, 1000.0 * Time / ChunkCount, 4 * SamplePointCount,
+           100.0 * MismatchCount / VoxelCount, 100.0 * SolidMismatchCount / VoxelCount, 100.0 * OreMismatchCount / VoxelCount);
+}
+
+// Validates the 8-wide hash noise against the scalar one on random points, returns the number of mismatches
+TARGET_AVX2 static u32 ValidateHashNoise(const hash_noise* Noise, u32 PointCount, f32 Range)
+{
+    u32 Result = 0;
+
+    u32 Random = 0x12345678u;
+    auto NextF32 = [&Random, Range]() -> f32
+    {
+        Random = XorShift32(Random);
+        f32 Result = Range * (2.0f * ((f32)(Random >> 8) / (f32)(1u << 24)) - 1.0f);
+        return Result;
+    };
+
+    for (u32 Base = 0; Base < PointCount; Base += 8)
+    {
+        alignas(32) f32 X[8], Y[8], Z[8];
+        for (u32 Lane = 0; Lane < 8; Lane++)
+        {
+            X[Lane] = NextF32();
+            Y[Lane] = NextF32();
+            Z[Lane] = NextF32();
+        }
+
+        alignas(32) f32 Samples2[8];
+        alignas(32) f32 Samples3[8];
+        _mm256_store_ps(Samples2, SampleOctave8(Noise, _mm256_load_ps(X), _mm256_load_ps(Y), 8, 0.5f, 2.0f));
+        _mm256_store_ps(Samples3, OctaveNoise8(Noise, _mm256_load_ps(X), _mm256_load_ps(Y), _mm256_load_ps(Z), 3, 0.5f, 2.0f));
+        for (u32 Lane = 0; Lane < 8; Lane++)
+        {
+            f32 Sample2 = SampleOctave(Noise, vec2{ X[Lane], Y[Lane] }, 8, 0.5f, 2.0f);
+            f32 Sample3 = OctaveNoise(Noise, vec3{ X[Lane], Y[Lane], Z[Lane] }, 3, 0.5f, 2.0f);
+            if (memcmp(&Sample2, &Samples2[Lane], sizeof(f32)) != 0) Result++;
+            if (memcmp(&Sample3, &Samples3[Lane], sizeof(f32)) != 0) Result++;
+        }
+    }
+    return Result;
+}
+
+// Validates the 8-wide 3D octave noise against the scalar one on random points, returns the number of mismatches
+template<typename noise_t>
+TARGET_AVX2 static u32 ValidateNoise3(const noise_t* Noise, u32 PointCount, f32 Range)
+{
+    u32 Result = 0;
+
+    u32 Random = 0x12345678u;
+    auto NextF32 = [&Random, Range]() -> f32
+    {
+        Random = XorShift32(Random);
+        f32 Result = Range * (2.0f * ((f32)(Random >> 8) / (f32)(1u << 24)) - 1.0f);
+        return Result;
+    };
+
+    for (u32 Base = 0; Base < PointCount; Base += 8)
+    {
+        alignas(32) f32 X[8], Y[8], Z[8];
+        for (u32 Lane = 0; Lane < 8; Lane++)
+        {
+            X[Lane] = NextF32();
+            Y[Lane] = NextF32();
+            Z[Lane] = NextF32();
+        }
+
+        alignas(32) f32 Samples[8];
+        _mm256_store_ps(Samples, OctaveNoise8(Noise, _mm256_load_ps(X), _mm256_load_ps(Y), _mm256_load_ps(Z), 3, 0.5f, 2.0f));
+        for (u32 Lane = 0; Lane < 8; Lane++)
+        {
+            f32 Sample = OctaveNoise(Noise, vec3{ X[Lane], Y[Lane], Z[Lane] }, 3, 0.5f, 2.0f);
+            if (memcmp(&Sample, &Samples[Lane], sizeof(f32)) != 0) Result++;
+        }
+    }
+    return Result;
+}
+
+// Times single octave 8-wide sampling, returns nanoseconds per sample. OutMin/OutMax are the extremes of the samples.
+template<typename noise_t>
+TARGET_AVX2 static f64 BenchNoise3(const noise_t* Noise, u32 SampleCount, f32* OutMin, f32* OutMax)
+{
+    __m256 Min8 = _mm256_set1_ps(+1e30f);
+    __m256 Max8 = _mm256_set1_ps(-1e30f);
+
+    // NOTE(boti): Points are spread out along a line that isn't aligned to either lattice
+    const __m256 Step = _mm256_set1_ps(8.0f * 0.173f);
+    __m256 X = _mm256_mul_ps(_mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f), _mm256_set1_ps(0.173f));
+    __m256 Y = _mm256_mul_ps(X, _mm256_set1_ps(0.61f));
+    __m256 Z = _mm256_mul_ps(X, _mm256_set1_ps(0.37f));
+
+    s64 Start = Bench_GetCounter();
+    for (u32 i = 0; i < SampleCount; i += 8)
+    {
+        __m256 Sample = SampleNoise8(Noise, X, Y, Z);
+        Min8 = _mm256_min_ps(Min8, Sample);
+        Max8 = _mm256_max_ps(Max8, Sample);
+
+        X = _mm256_add_ps(X, Step);
+        Y = _mm256_add_ps(Y, _mm256_mul_ps(Step, _mm256_set1_ps(0.61f)));
+        Z = _mm256_add_ps(Z, _mm256_mul_ps(Step, _mm256_set1_ps(0.37f)));
+        // Keep the coordinates small so that the precision doesn't degrade
+        X = _mm256_sub_ps(X, _mm256_and_ps(_mm256_cmp_ps(X, _mm256_set1_ps(4096.0f), _CMP_GT_OQ), _mm256_set1_ps(4096.0f)));
+    }
+    s64 End = Bench_GetCounter();
+
+    alignas(32) f32 Mins[8], Maxs[8];
+    _mm256_store_ps(Mins, Min8);
+    _mm256_store_ps(Maxs, Max8);
+    *OutMin = Mins[0];
+    *OutMax = Maxs[0];
+    for (u32 Lane = 1; Lane < 8; Lane++)
+    {
+        *OutMin = Min(*OutMin, Mins[Lane]);
+        *OutMax = Max(*OutMax, Maxs[Lane]);
+    }
+
+    f64 Result = 1e9 * Bench_GetElapsedTime(Start, End) / (f64)SampleCount;
+    return Result;
+}
+
+// Times Sample(X, Y, Z) on a line of points, returns nanoseconds per sample.
+// Sum is the sum of the samples, which also keeps the compiler from throwing the work away.
+template<typename sample_func>
+TARGET_AVX2 static f64 BenchSampler(u32 SampleCount, sample_func&& Sample, f32* Sum)
+{
+    __m256 Sum8 = _mm256_setzero_ps();
+
+    const __m256 Step = _mm256_set1_ps(8.0f * 0.173f);
+    __m256 X = _mm256_mul_ps(_mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f), _mm256_set1_ps(0.173f));
+    __m256 Y = _mm256_mul_ps(X, _mm256_set1_ps(0.61f));
+    __m256 Z = _mm256_mul_ps(X, _mm256_set1_ps(0.37f));
+
+    s64 Start = Bench_GetCounter();
+    for (u32 i = 0; i < SampleCount; i += 8)
+    {
+        Sum8 = _mm256_add_ps(Sum8, Sample(X, Y, Z));
+
+        X = _mm256_add_ps(X, Step);
+        Y = _mm256_add_ps(Y, _mm256_mul_ps(Step, _mm256_set1_ps(0.61f)));
+        Z = _mm256_add_ps(Z, _mm256_mul_ps(Step, _mm256_set1_ps(0.37f)));
+        X = _mm256_sub_ps(X, _mm256_and_ps(_mm256_cmp_ps(X, _mm256_set1_ps(4096.0f), _CMP_GT_OQ), _mm256_set1_ps(4096.0f)));
+    }
+    s64 End = Bench_GetCounter();
+
+    alignas(32) f32 Sums[8];
+    _mm256_store_ps(Sums, Sum8);
+    *Sum = 0.0f;
+    for (u32 Lane = 0; Lane < 8; Lane++)
+    {
+        *Sum += Sums[Lane];
+    }
+
+    f64 Result = 1e9 * Bench_GetElapsedTime(Start, End) / (f64)SampleCount;
+    return Result;
+}
+
+// Runs the runtime and the specialized octave noise on the same points and reports the cost of both
+template<typename runtime_func, typename specialized_func>
+TARGET_AVX2 static u32 CompareOctaveNoise(const char* Name, u32 SampleCount, runtime_func&& Runtime, specialized_func&& Specialized)
+{
+    f32 RuntimeSum, SpecializedSum;
+    f64 RuntimeCost = BenchSampler(SampleCount, Runtime, &RuntimeSum);
+    f64 SpecializedCost = BenchSampler(SampleCount, Specialized, &SpecializedSum);
+    printf("  %-24s runtime %6.2fns/sample, specialized %6.2fns/sample, %.2fx\n", Name, RuntimeCost, SpecializedCost, RuntimeCost / SpecializedCost);
+
+    // NOTE(boti): The sums are accumulated in the same order, so they have to match exactly too
+    u32 Result = (memcmp(&RuntimeSum, &SpecializedSum, sizeof(f32)) == 0) ? 0 : 1;
+    return Result;
+}
+
+// Writes the z = Z slice of the noise to a SliceDim x SliceDim block of Pixels (RGB, rows are Stride bytes), mapped from [-1, 1]
+template<typename noise_t>
+static void DrawNoiseSlice(const noise_t* Noise, u8* Pixels, u32 Stride, u32 SliceDim, f32 Frequency, f32 Z)
+{
+    for (u32 y = 0; y < SliceDim; y++)
+    {
+        u8* Row = Pixels + y * Stride;
+        for (u32 x = 0; x < SliceDim; x++)
+        {
+            f32 Sample = SampleNoise(Noise, Frequency * vec3{ (f32)x, (f32)y, Z });
+            u8 Value = (u8)Round(255.0f * Clamp(0.5f * Sample + 0.5f, 0.0f, 1.0f));
+            Row[3*x + 0] = Value;
+            Row[3*x + 1] = Value;
+            Row[3*x + 2] = Value;
+        }
+    }
+}
+
+#pragma pack(push, 1)
+struct bench_bmp_header
+{
+    u16 Tag;
+    u32 FileSize;
+    u16 Reserved1;
+    u16 Reserved2;
+    u32 Offset;
+
+    u32 HeaderSize;
+    s32 Width;
+    s32 Height;
+    u16 Planes;
+    u16 BitCount;
+    u32 Compression;
+    u32 ImageSize;
+    s32 PixelsPerMeterX;
+    s32 PixelsPerMeterY;
+    u32 ClrUsed;
+    u32 ClrImportant;
+};
+#pragma pack(pop)
+
+// Writes perlin3 | hash_noise | simplex3 slices next to each other
+static bool WriteNoiseSlices(const char* Path, const world_generator* Generator, memory_arena* Arena)
+{
+    bool Result = false;
+
+    constexpr u32 SliceDim = 256;
+    constexpr u32 SliceCount = 3;
+    constexpr u32 Width = SliceCount * SliceDim;
+    constexpr u32 Stride = 3 * Width;
+    static_assert((Stride % 4) == 0);
+    constexpr f32 Frequency = 1.0f / 16.0f;
+    constexpr f32 Z = 64.0f;
+
+    memory_arena_checkpoint Checkpoint = ArenaCheckpoint(Arena);
+    u8* Pixels = PushArray<u8>(Arena, Stride * SliceDim);
+    if (Pixels)
+    {
+        DrawNoiseSlice(&Generator->Perlin3, Pixels + 0 * 3 * SliceDim, Stride, SliceDim, Frequency, Z);
+        DrawNoiseSlice(&Generator->HashNoise, Pixels + 1 * 3 * SliceDim, Stride, SliceDim, Frequency, Z);
+        DrawNoiseSlice(&Generator->Simplex3, Pixels + 2 * 3 * SliceDim, Stride, SliceDim, Frequency, Z);
+
+        bench_bmp_header Header = {};
+        Header.Tag = 'MB';
+        Header.Offset = sizeof(bench_bmp_header);
+        Header.FileSize = Header.Offset + Stride * SliceDim;
+        Header.HeaderSize = 40;
+        Header.Width = Width;
+        Header.Height = -(s32)SliceDim; // Top-down
+        Header.Planes = 1;
+        Header.BitCount = 24;
+        Header.ImageSize = Stride * SliceDim;
+
+        FILE* File = fopen(Path, "wb");
+        if (File)
+        {
+            Result = 
+                (fwrite(&Header, sizeof(Header), 1, File) == 1) &&
+                (fwrite(Pixels, Stride * SliceDim, 1, File) == 1);
+            fclose(File);
+        }
+    }
+    RestoreArena(Arena, Checkpoint);
+
+    return Result;
+}
+
+// Counts how many of 256 noise samples are the same Offset lattice cells further along x
+template<typename noise_t>
+static u32 CountRepeatingSamples(const noise_t* Noise, f32 Offset)
+{
+    u32 Result = 0;
+    for (u32 i = 0; i < 256; i++)
+    {
+        // NOTE(boti): Positions are multiples of 1/8 so that adding Offset is exact
+        vec3 P = { 0.125f * i - 16.0f, 37.25f, 3.5f };
+        if (SampleNoise(Noise, P) == SampleNoise(Noise, P + vec3{ Offset, 0.0f, 0.0f }))
+        {
+            Result++;
+        }
+    }
+    return Result;
+}
+
+// Checks Philox4x32-10 against the known answers from the reference implementation (Random123),
+// the 8-wide version against the scalar one, and times both. Returns the number of mismatches
+TARGET_AVX2 static u32 BenchCounterRandom(u32 SampleCount)
+{
+    u32 Result = 0;
+
+    struct known_answer
+    {
+        u32 Counter[4];
+        u32 Key[2];
+        u32 Out[4];
+    };
+    static const known_answer KnownAnswers[] = 
+    {
+        { { 0, 0, 0, 0 }, { 0, 0 }, { 0x6627E8D5u, 0xE169C58Du, 0xBC57AC4Cu, 0x9B00DBD8u } },
+        { { 0xFFFFFFFFu, 0xFFFFFFFFu, 0xFFFFFFFFu, 0xFFFFFFFFu }, { 0xFFFFFFFFu, 0xFFFFFFFFu }, { 0x408F276Du, 0x41C83B0Eu, 0xA20BC7C6u, 0x6D5451FDu } },
+        { { 0x243F6A88u, 0x85A308D3u, 0x13198A2Eu, 0x03707344u }, { 0xA4093822u, 0x299F31D0u }, { 0xD16CFE09u, 0x94FDCCEBu, 0x5001E420u, 0x24126EA1u } },
+    };
+
+    u32 KnownAnswerMismatchCount = 0;
+    for (u32 i = 0; i < CountOf(KnownAnswers); i++)
+    {
+        const known_answer* Answer = KnownAnswers + i;
+        u32 Out[4];
+        Philox4x32(Answer->Counter, Answer->Key, Out);
+
+        __m256i Counter8[4];
+        __m256i Out8[4];
+        for (u32 j = 0; j < 4; j++)
+        {
+            Counter8[j] = _mm256_set1_epi32((s32)Answer->Counter[j]);
+        }
+        Philox4x32_8(Counter8, Answer->Key, Out8);
+
+        for (u32 j = 0; j < 4; j++)
+        {
+            alignas(32) u32 Lanes[8];
+            _mm256_store_si256((__m256i*)Lanes, Out8[j]);
+            KnownAnswerMismatchCount += (Out[j] != Answer->Out[j]) ? 1 : 0;
+            for (u32 Lane = 0; Lane < 8; Lane++)
+            {
+                KnownAnswerMismatchCount += (Lanes[Lane] != Answer->Out[j]) ? 1 : 0;
+            }
+        }
+    }
+    printf("  Known answer mismatches: %u\n", KnownAnswerMismatchCount);
+    Result += KnownAnswerMismatchCount;
+
+    random_stream Stream = RandomStream(1337, vec2i{ -48, 1024 }, RandomPurpose_Trees);
+
+    u32 MismatchCount = 0;
+    f64 Sum = 0.0;
+    s64 StartCounter = Bench_GetCounter();
+    for (u32 Index = 0; Index < SampleCount; Index++)
+    {
+        Sum += RandomUnilateral(&Stream, Index);
+    }
+    s64 MidCounter = Bench_GetCounter();
+    __m256 Sum8 = _mm256_setzero_ps();
+    for (u32 Index = 0; Index < SampleCount; Index += 8)
+    {
+        __m256i Index8 = _mm256_add_epi32(_mm256_set1_epi32((s32)Index), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        Sum8 = _mm256_add_ps(Sum8, RandomUnilateral8(&Stream, Index8));
+    }
+    s64 EndCounter = Bench_GetCounter();
+
+    for (u32 Index = 0; Index < (1u << 16); Index += 8)
+    {
+        __m256i Index8 = _mm256_add_epi32(_mm256_set1_epi32((s32)(Index * 0x9E3779B9u)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        alignas(32) u32 Indices[8];
+        alignas(32) u32 Lanes[8];
+        _mm256_store_si256((__m256i*)Indices, Index8);
+        _mm256_store_si256((__m256i*)Lanes, RandomU32_8(&Stream, Index8));
+        for (u32 Lane = 0; Lane < 8; Lane++)
+        {
+            MismatchCount += (Lanes[Lane] != RandomU32(&Stream, Indices[Lane])) ? 1 : 0;
+        }
+    }
+    printf("  8-wide vs scalar mismatches: %u\n", MismatchCount);
+    Result += MismatchCount;
+
+    alignas(32) f32 Sums[8];
+    _mm256_store_ps(Sums, Sum8);
+    f64 Sum8Total = 0.0;
+    for (u32 Lane = 0; Lane < 8; Lane++)
+    {
+        Sum8Total += Sums[Lane];
+    }
+
+    f64 ScalarTime = Bench_GetElapsedTime(StartCounter, MidCounter);
+    f64 WideTime = Bench_GetElapsedTime(MidCounter, EndCounter);
+    printf("  scalar: %6.2fns/number, 8-wide: %6.2fns/number (%.2fx), mean %.4f/%.4f\n",
+           1e9 * ScalarTime / SampleCount, 1e9 * WideTime / SampleCount, ScalarTime / WideTime,
+           Sum / SampleCount, Sum8Total / SampleCount);
+
+    return(Result);
+}
+
+// Runs every kernel variant up to MaxLevel against the scalar code on random inputs (and odd counts, so the remainders are covered too),
+// and times the noise kernels. Returns the number of mismatches
+static u32 BenchKernels(cpu_level MaxLevel, const world_generator* Generator, memory_arena* Arena)
+{
+    u32 Result = 0;
+
+    u32 Random = 0x12345678u;
+    auto NextF32 = [&Random](f32 Range) -> f32
+    {
+        Random = XorShift32(Random);
+        f32 Result = Range * (2.0f * ((f32)(Random >> 8) / (f32)(1u << 24)) - 1.0f);
+        return Result;
+    };
+
+    constexpr u32 PointCount = (1u << 16) + 7;
+    f32* X = PushArray<f32>(Arena, PointCount);
+    f32* Y = PushArray<f32>(Arena, PointCount);
+    f32* Z = PushArray<f32>(Arena, PointCount);
+    f32* ReferenceOut = PushArray<f32>(Arena, PointCount);
+    f32* ReferencePerlin = PushArray<f32>(Arena, PointCount);
+    f32* ReferenceHash = PushArray<f32>(Arena, PointCount);
+    f32* Out = PushArray<f32>(Arena, PointCount);
+    for (u32 i = 0; i < PointCount; i++)
+    {
+        X[i] = NextF32(1e5f);
+        Y[i] = NextF32(1e5f);
+        Z[i] = NextF32(256.0f);
+    }
+
+    constexpr u32 LayerCount = 255;
+    u16* Opaque = PushArray<u16>(Arena, LayerCount * 16);
+    u16* ReferenceBuried = PushArray<u16>(Arena, LayerCount * 16);
+    u16* Buried = PushArray<u16>(Arena, LayerCount * 16);
+    for (u32 i = 0; i < LayerCount * 16; i++)
+    {
+        // NOTE(boti): Mostly solid, otherwise almost nothing would be buried
+        Random = XorShift32(Random);
+        u32 Holes = Random;
+        Random = XorShift32(Random);
+        Opaque[i] = (u16)~(Holes & Random & (Random >> 16));
+    }
+
+    frustum Frustum;
+    for (u32 i = 0; i < 6; i++)
+    {
+        vec3 Normal = Normalize(vec3{ NextF32(1.0f), NextF32(1.0f), NextF32(1.0f) });
+        Frustum.Planes[i] = vec4{ Normal.x, Normal.y, Normal.z, NextF32(256.0f) + 256.0f };
+    }
+    const vec3 HalfExtent = { 0.5f * CHUNK_DIM_XY, 0.5f * CHUNK_DIM_XY, 0.5f * CHUNK_DIM_Z };
+    u8* ReferenceVisible = PushArray<u8>(Arena, PointCount);
+    u8* Visible = PushArray<u8>(Arena, PointCount);
+
+    s16* Samples = PushArray<s16>(Arena, PointCount);
+    audio_sample* ReferenceMix = PushArray<audio_sample>(Arena, PointCount);
+    audio_sample* Mix = PushArray<audio_sample>(Arena, PointCount);
+    audio_sample* MixReference = PushArray<audio_sample>(Arena, PointCount);
+    for (u32 i = 0; i < PointCount; i++)
+    {
+        Random = XorShift32(Random);
+        Samples[i] = (s16)Random;
+        ReferenceMix[i] = audio_sample{ NextF32(1.0f), NextF32(1.0f) };
+    }
+
+    // NOTE(boti): The references are the plain scalar loops that the kernels have to match
+    auto FindBuriedVoxels_Reference = [](u32 LayerCount, const u16* Opaque, u16* Buried)
+    {
+        for (u32 Layer = 0; Layer < LayerCount; Layer++)
+        {
+            for (u32 y = 0; y < 16; y++)
+            {
+                u32 Row = Opaque[Layer * 16 + y];
+                u32 Result = Row & (Row << 1) & (Row >> 1);
+                Result &= (y > 0) ? Opaque[Layer * 16 + y - 1] : 0u;
+                Result &= (y < 15) ? Opaque[Layer * 16 + y + 1] : 0u;
+                Result &= (Layer > 0) ? Opaque[(Layer - 1) * 16 + y] : 0u;
+                Result &= (Layer + 1 < LayerCount) ? Opaque[(Layer + 1) * 16 + y] : 0u;
+                Buried[Layer * 16 + y] = (u16)Result;
+            }
+        }
+    };
+    auto CullBoxes_Reference = [&Frustum, HalfExtent](u32 Count, const f32* X, const f32* Y, const f32* Z, u8* Visible)
+    {
+        for (u32 i = 0; i < Count; i++)
+        {
+            vec3 CenterP = { X[i], Y[i], Z[i] };
+            Visible[i] = IntersectFrustumAABB(Frustum, aabb{ CenterP - HalfExtent, CenterP + HalfExtent }) ? 1 : 0;
+        }
+    };
+    auto MixMono_Reference = [](audio_sample* Dst, const s16* Src, u32 Count, f32 Volume)
+    {
+        for (u32 i = 0; i < Count; i++)
+        {
+            f32 Sample = Src[i] / 32768.0f;
+            Dst[i].Left += Volume * Sample;
+            Dst[i].Right += Volume * Sample;
+        }
+    };
+
+    s64 StartCounter = Bench_GetCounter();
+    for (u32 i = 0; i < PointCount; i++)
+    {
+        ReferencePerlin[i] = SampleOctave(&Generator->Perlin2, vec2{ X[i], Y[i] }, 8, 0.5f, 2.0f);
+    }
+    s64 MidCounter = Bench_GetCounter();
+    for (u32 i = 0; i < PointCount; i++)
+    {
+        ReferenceHash[i] = SampleOctave(&Generator->HashNoise, vec2{ X[i], Y[i] }, 8, 0.5f, 2.0f);
+    }
+    s64 EndCounter = Bench_GetCounter();
+    f64 ScalarPerlinCost = 1e9 * Bench_GetElapsedTime(StartCounter, MidCounter) / PointCount;
+    f64 ScalarHashCost = 1e9 * Bench_GetElapsedTime(MidCounter, EndCounter) / PointCount;
+
+    FindBuriedVoxels_Reference(LayerCount, Opaque, ReferenceBuried);
+    CullBoxes_Reference(PointCount, X, Y, Z, ReferenceVisible);
+    u32 VisibleCount = 0;
+    for (u32 i = 0; i < PointCount; i++)
+    {
+        VisibleCount += ReferenceVisible[i];
+    }
+    printf("  Scalar   perlin2 %6.2fns/sample, hash %6.2fns/sample, %u/%u boxes visible\n",
+           ScalarPerlinCost, ScalarHashCost, VisibleCount, PointCount);
+
+    memcpy(MixReference, ReferenceMix, PointCount * sizeof(audio_sample));
+    MixMono_Reference(MixReference + 1, Samples + 3, PointCount - 3, 0.7f);
+    MixMono_Reference(MixReference, Samples, 5, 0.25f);
+
+    for (u32 Level = CPULevel_Scalar; Level <= (u32)MaxLevel; Level++)
+    {
+        const simd_kernels* Variant = GetSIMDKernels((cpu_level)Level);
+        u32 LevelMismatchCount = 0;
+
+        StartCounter = Bench_GetCounter();
+        Variant->SampleOctavePerlin2(&Generator->Perlin2, PointCount, X, Y, 8, 0.5f, 2.0f, Out);
+        EndCounter = Bench_GetCounter();
+        f64 PerlinCost = 1e9 * Bench_GetElapsedTime(StartCounter, EndCounter) / PointCount;
+        LevelMismatchCount += (memcmp(Out, ReferencePerlin, PointCount * sizeof(f32)) == 0) ? 0 : 1;
+
+        StartCounter = Bench_GetCounter();
+        Variant->SampleOctaveHash2(&Generator->HashNoise, PointCount, X, Y, 8, 0.5f, 2.0f, Out);
+        EndCounter = Bench_GetCounter();
+        f64 HashCost = 1e9 * Bench_GetElapsedTime(StartCounter, EndCounter) / PointCount;
+        LevelMismatchCount += (memcmp(Out, ReferenceHash, PointCount * sizeof(f32)) == 0) ? 0 : 1;
+
+        // NOTE(boti): The default persistence/lacunarity above go through the specialized octaves, these through the runtime loops
+        Variant->SampleOctaveHash2(&Generator->HashNoise, PointCount, X, Y, 5, 0.45f, 2.1f, Out);
+        for (u32 i = 0; i < PointCount; i++)
+        {
+            ReferenceOut[i] = SampleOctave(&Generator->HashNoise, vec2{ X[i], Y[i] }, 5, 0.45f, 2.1f);
+        }
+        LevelMismatchCount += (memcmp(Out, ReferenceOut, PointCount * sizeof(f32)) == 0) ? 0 : 1;
+
+        // Odd counts for the remainders
+        u16* CountReferenceBuried = PushArray<u16>(Arena, LayerCount * 16);
+        u8* CountReferenceVisible = PushArray<u8>(Arena, PointCount);
+        for (u32 Count = 0; Count < 40; Count++)
+        {
+            Variant->SampleOctavePerlin2(&Generator->Perlin2, Count, X + Count, Y + Count, 3, 0.5f, 2.0f, Out);
+            for (u32 i = 0; i < Count; i++)
+            {
+                ReferenceOut[i] = SampleOctave(&Generator->Perlin2, vec2{ X[Count + i], Y[Count + i] }, 3, 0.5f, 2.0f);
+            }
+            LevelMismatchCount += (memcmp(Out, ReferenceOut, Count * sizeof(f32)) == 0) ? 0 : 1;
+
+            Variant->SampleOctavePerlin2(&Generator->Perlin2, Count, X + Count, Y + Count, 3, 0.45f, 2.1f, Out);
+            for (u32 i = 0; i < Count; i++)
+            {
+                ReferenceOut[i] = SampleOctave(&Generator->Perlin2, vec2{ X[Count + i], Y[Count + i] }, 3, 0.45f, 2.1f);
+            }
+            LevelMismatchCount += (memcmp(Out, ReferenceOut, Count * sizeof(f32)) == 0) ? 0 : 1;
+
+            Variant->FindBuriedVoxels(Count, Opaque + Count, Buried);
+            FindBuriedVoxels_Reference(Count, Opaque + Count, CountReferenceBuried);
+            LevelMismatchCount += (memcmp(Buried, CountReferenceBuried, Count * 16 * sizeof(u16)) == 0) ? 0 : 1;
+
+            Variant->CullBoxes(&Frustum, HalfExtent, Count, X + Count, Y + Count, Z + Count, Visible);
+            CullBoxes_Reference(Count, X + Count, Y + Count, Z + Count, CountReferenceVisible);
+            LevelMismatchCount += (memcmp(Visible, CountReferenceVisible, Count) == 0) ? 0 : 1;
+        }
+
+        Variant->FindBuriedVoxels(LayerCount, Opaque, Buried);
+        LevelMismatchCount += (memcmp(Buried, ReferenceBuried, LayerCount * 16 * sizeof(u16)) == 0) ? 0 : 1;
+
+        Variant->CullBoxes(&Frustum, HalfExtent, PointCount, X, Y, Z, Visible);
+        LevelMismatchCount += (memcmp(Visible, ReferenceVisible, PointCount) == 0) ? 0 : 1;
+
+        memcpy(Mix, ReferenceMix, PointCount * sizeof(audio_sample));
+        Variant->MixMono(Mix + 1, Samples + 3, PointCount - 3, 0.7f);
+        Variant->MixMono(Mix, Samples, 5, 0.25f);
+        LevelMismatchCount += (memcmp(Mix, MixReference, PointCount * sizeof(audio_sample)) == 0) ? 0 : 1;
+
+        printf("  %-8s perlin2 %6.2fns/sample (%.2fx), hash %6.2fns/sample (%.2fx), mismatching kernels: %u\n",
+               CPULevelNames[Level], PerlinCost, ScalarPerlinCost / PerlinCost, HashCost, ScalarHashCost / HashCost, LevelMismatchCount);
+        Result += LevelMismatchCount;
+    }
+
+    return(Result);
+}
+
+// Reports how much memory the generated chunks take with the palette storage, and compares reading and writing it
+// against the flat [z][y][x] array. Returns the number of voxels where the two disagree after the same writes
+static u32 BenchChunkStorage(const world_generator* Generator, s32 ChunkCountSqrt, memory_arena* Arena)
+{
+    u32 Result = 0;
+
+    memory_arena_checkpoint Checkpoint = ArenaCheckpoint(Arena);
+    chunk_data* Data = Bench_PushChunkData(Arena, 1);
+    chunk_voxels* Voxels = PushStruct<chunk_voxels>(Arena);
+
+    // Memory
+    u64 DataSize = 0;
+    u32 BoundsMismatchCount = 0;
+    u32 MaskMismatchCount = 0;
+    u32 SectionCountByBits[CHUNK_MAX_BITS_PER_INDEX + 1] = {};
+    f64 PackTime = 0.0;
+    f64 UnpackTime = 0.0;
+    u64 CompressibleDenseSize = 0;
+    u64 CompressedSize = 0;
+    u32 CompressedCount = 0;
+    u32 CompressMismatchCount = 0;
+    f64 CompressTime = 0.0;
+    f64 DecompressTime = 0.0;
+    chunk Chunk = {};
+    Chunk.Data = Data;
+    for (s32 y = 0; y < ChunkCountSqrt; y++)
+    {
+        for (s32 x = 0; x < ChunkCountSqrt; x++)
+        {
+            for (s32 z = 0; z < BENCH_COLUMN_CHUNK_COUNT; z++)
+            {
+                Chunk.P = vec3i{ x - ChunkCountSqrt / 2, y - ChunkCountSqrt / 2, z } * CHUNK_DIM_XY;
+                Generate(&Chunk, Generator, Arena);
+                BoundsMismatchCount += CountColumnBoundsMismatches(&Chunk, Arena);
+                MaskMismatchCount += CountVoxelMaskMismatches(&Chunk, Arena);
+
+                DataSize += GetChunkDataSize(Data);
+                for (u32 SectionIndex = 0; SectionIndex < CHUNK_SECTION_COUNT; SectionIndex++)
+                {
+                    SectionCountByBits[Data->Sections[SectionIndex].BitsPerIndex]++;
+                }
+
+                s64 StartCounter = Bench_GetCounter();
+                UnpackChunkData(Data, Voxels);
+                s64 MidCounter = Bench_GetCounter();
+                PackChunkData(Data, Voxels);
+                s64 EndCounter = Bench_GetCounter();
+                UnpackTime += Bench_GetElapsedTime(StartCounter, MidCounter);
+                PackTime += Bench_GetElapsedTime(MidCounter, EndCounter);
+
+                // NOTE(boti): Same as the cold chunks in the world, the voxels have to survive the round trip
+                u64 DenseSize = GetDenseChunkDataSize(Data);
+                StartCounter = Bench_GetCounter();
+                bool IsCompressed = CompressChunkData(Data);
+                EndCounter = Bench_GetCounter();
+                if (IsCompressed)
+                {
+                    CompressTime += Bench_GetElapsedTime(StartCounter, EndCounter);
+                    CompressibleDenseSize += DenseSize;
+                    CompressedSize += GetChunkDataSize(Data);
+                    CompressedCount++;
+
+                    StartCounter = Bench_GetCounter();
+                    DecompressChunkData(Data);
+                    EndCounter = Bench_GetCounter();
+                    DecompressTime += Bench_GetElapsedTime(StartCounter, EndCounter);
+
+                    for (s32 VoxelZ = 0; VoxelZ < CHUNK_DIM_Z; VoxelZ++)
+                    {
+                        for (s32 VoxelY = 0; VoxelY < CHUNK_DIM_XY; VoxelY++)
+                        {
+                            for (s32 VoxelX = 0; VoxelX < CHUNK_DIM_XY; VoxelX++)
+                            {
+                                CompressMismatchCount += (GetVoxel(Data, VoxelX, VoxelY, VoxelZ) != Voxels->Voxels[VoxelZ][VoxelY][VoxelX]) ? 1 : 0;
+                            }
+                        }
+                    }
+                    CompressMismatchCount += (GetChunkDataSize(Data) == DenseSize) ? 0 : 1;
+                }
+            }
+        }
+    }
+
+    u32 ChunkCount = (u32)(ChunkCountSqrt * ChunkCountSqrt * BENCH_COLUMN_CHUNK_COUNT);
+    u32 SectionCount = ChunkCount * CHUNK_SECTION_COUNT;
+    printf("  Memory/chunk: flat %.1fKiB, palette %.1fKiB (chunk_data %.2fKiB + section indices)\n",
+           sizeof(chunk_voxels) / 1024.0, DataSize / (1024.0 * ChunkCount), sizeof(chunk_data) / 1024.0);
+    printf("  Sections by index width: 0 bits %.1f%%, 1 bit %.1f%%, 2 bits %.1f%%, 4 bits %.1f%%\n",
+           100.0 * SectionCountByBits[0] / SectionCount, 100.0 * SectionCountByBits[1] / SectionCount,
+           100.0 * SectionCountByBits[2] / SectionCount, 100.0 * SectionCountByBits[4] / SectionCount);
+    printf("  Unpack: %.3fms/chunk, pack: %.3fms/chunk\n", 1000.0 * UnpackTime / ChunkCount, 1000.0 * PackTime / ChunkCount);
+    printf("  Generated columns with wrong bounds: %u, rows with wrong voxel masks: %u\n", BoundsMismatchCount, MaskMismatchCount);
+    Result += BoundsMismatchCount + MaskMismatchCount;
+    printf("  Compressed %.1f%% of the chunks, %.2fKiB -> %.2fKiB/chunk (%.2fx), compress: %.2fus/chunk, decompress: %.2fus/chunk, mismatches: %u\n",
+           100.0 * CompressedCount / ChunkCount,
+           CompressedCount ? CompressibleDenseSize / (1024.0 * CompressedCount) : 0.0,
+           CompressedCount ? CompressedSize / (1024.0 * CompressedCount) : 0.0,
+           CompressedSize ? (f64)CompressibleDenseSize / (f64)CompressedSize : 0.0,
+           CompressedCount ? 1e6 * CompressTime / CompressedCount : 0.0,
+           CompressedCount ? 1e6 * DecompressTime / CompressedCount : 0.0,
+           CompressMismatchCount);
+    Result += CompressMismatchCount;
+
+    // NOTE(boti): The surface chunk at the origin is used for the throughput tests (most of the others are uniform air or stone),
+    //             the flat copy gets the same operations as the packed one
+    Chunk.P = vec3i{ 0, 0, 0 };
+    Generate(&Chunk, Generator, Arena);
+    Chunk.P.z = (Chunk.Heightmap[CHUNK_DIM_XY / 2][CHUNK_DIM_XY / 2] / CHUNK_DIM_Z) * CHUNK_DIM_Z;
+    Generate(&Chunk, Generator, Arena);
+    UnpackChunkData(Data, Voxels);
+
+    constexpr u32 VoxelCount = CHUNK_DIM_Z * CHUNK_DIM_XY * CHUNK_DIM_XY;
+    constexpr u32 RandomAccessCount = 1u << 22;
+    u32* Positions = PushArray<u32>(Arena, RandomAccessCount);
+    u32 Random = 0x9E3779B9u;
+    for (u32 i = 0; i < RandomAccessCount; i++)
+    {
+        Random = XorShift32(Random);
+        Positions[i] = Random % VoxelCount;
+    }
+
+    u64 PackedSum = 0;
+    u64 FlatSum = 0;
+    s64 StartCounter = Bench_GetCounter();
+    for (s32 z = 0; z < CHUNK_DIM_Z; z++)
+    {
+        for (s32 y = 0; y < CHUNK_DIM_XY; y++)
+        {
+            for (s32 x = 0; x < CHUNK_DIM_XY; x++)
+            {
+                PackedSum += GetVoxel(Data, x, y, z);
+            }
+        }
+    }
+    s64 MidCounter = Bench_GetCounter();
+    for (s32 z = 0; z < CHUNK_DIM_Z; z++)
+    {
+        for (s32 y = 0; y < CHUNK_DIM_XY; y++)
+        {
+            for (s32 x = 0; x < CHUNK_DIM_XY; x++)
+            {
+                FlatSum += Voxels->Voxels[z][y][x];
+            }
+        }
+    }
+    s64 EndCounter = Bench_GetCounter();
+    f64 PackedSequentialTime = Bench_GetElapsedTime(StartCounter, MidCounter);
+    f64 FlatSequentialTime = Bench_GetElapsedTime(MidCounter, EndCounter);
+
+    StartCounter = Bench_GetCounter();
+    for (u32 i = 0; i < RandomAccessCount; i++)
+    {
+        u32 P = Positions[i];
+        PackedSum += GetVoxel(Data, P % CHUNK_DIM_XY, (P / CHUNK_DIM_XY) % CHUNK_DIM_XY, P / (CHUNK_DIM_XY * CHUNK_DIM_XY));
+    }
+    MidCounter = Bench_GetCounter();
+    for (u32 i = 0; i < RandomAccessCount; i++)
+    {
+        u32 P = Positions[i];
+        FlatSum += Voxels->Voxels[P / (CHUNK_DIM_XY * CHUNK_DIM_XY)][(P / CHUNK_DIM_XY) % CHUNK_DIM_XY][P % CHUNK_DIM_XY];
+    }
+    EndCounter = Bench_GetCounter();
+    f64 PackedRandomTime = Bench_GetElapsedTime(StartCounter, MidCounter);
+    f64 FlatRandomTime = Bench_GetElapsedTime(MidCounter, EndCounter);
+
+    printf("  Read:  sequential %5.2fns/voxel (flat %5.2fns), random %5.2fns/voxel (flat %5.2fns)%s\n",
+           1e9 * PackedSequentialTime / VoxelCount, 1e9 * FlatSequentialTime / VoxelCount,
+           1e9 * PackedRandomTime / RandomAccessCount, 1e9 * FlatRandomTime / RandomAccessCount,
+           (PackedSum == FlatSum) ? "" : ", sums differ");
+    Result += (PackedSum == FlatSum) ? 0 : 1;
+
+    // NOTE(boti): Edits mostly dig out or place a handful of types, so the writes don't go through every palette width right away
+    static const u16 WriteTypes[] = { VOXEL_AIR, VOXEL_AIR, VOXEL_STONE, VOXEL_LEAVES };
+    StartCounter = Bench_GetCounter();
+    for (u32 i = 0; i < RandomAccessCount; i++)
+    {
+        u32 P = Positions[i];
+        SetVoxel(Data, P % CHUNK_DIM_XY, (P / CHUNK_DIM_XY) % CHUNK_DIM_XY, P / (CHUNK_DIM_XY * CHUNK_DIM_XY), WriteTypes[i % CountOf(WriteTypes)]);
+    }
+    MidCounter = Bench_GetCounter();
+    for (u32 i = 0; i < RandomAccessCount; i++)
+    {
+        u32 P = Positions[i];
+        Voxels->Voxels[P / (CHUNK_DIM_XY * CHUNK_DIM_XY)][(P / CHUNK_DIM_XY) % CHUNK_DIM_XY][P % CHUNK_DIM_XY] = WriteTypes[i % CountOf(WriteTypes)];
+    }
+    EndCounter = Bench_GetCounter();
+    printf("  Write: random %5.2fns/voxel (flat %5.2fns), palette size after the writes %.1fKiB\n",
+           1e9 * Bench_GetElapsedTime(StartCounter, MidCounter) / RandomAccessCount,
+           1e9 * Bench_GetElapsedTime(MidCounter, EndCounter) / RandomAccessCount,
+           GetChunkDataSize(Data) / 1024.0);
+
+    u32 MismatchCount = 0;
+    for (s32 z = 0; z < CHUNK_DIM_Z; z++)
+    {
+        for (s32 y = 0; y < CHUNK_DIM_XY; y++)
+        {
+            for (s32 x = 0; x < CHUNK_DIM_XY; x++)
+            {
+                MismatchCount += (GetVoxel(Data, x, y, z) != Voxels->Voxels[z][y][x]) ? 1 : 0;
+            }
+        }
+    }
+    printf("  Packed vs flat mismatching voxels: %u\n", MismatchCount);
+    Result += MismatchCount;
+
+    ResetChunkData(Data);
+    RestoreArena(Arena, Checkpoint);
+    return(Result);
+}
+
+// Block of 3x3x3 chunks that the layout bench reads, P is relative to the min corner of the block
+struct bench_chunk_block
+{
+    chunk_data* Data[3][3][3];
+
+    u16 GetVoxelAt(vec3i P) const
+    {
+        const chunk_data* Chunk = Data[P.z / CHUNK_DIM_Z][P.y / CHUNK_DIM_XY][P.x / CHUNK_DIM_XY];
+        u16 Result = GetVoxel(Chunk, P.x % CHUNK_DIM_XY, P.y % CHUNK_DIM_XY, P.z % CHUNK_DIM_Z);
+        return(Result);
+    }
+};
+
+// Reads the same 3x3x3 block of chunks around the surface with every voxel layout: the 3x3x3 neighborhoods of the center chunk
+// (what meshing does for every voxel it doesn't skip) and box scanning ray casts (same as RayCast).
+// Returns the number of layouts that disagree with the linear one
+static u32 BenchVoxelLayouts(const world_generator* Generator, memory_arena* Arena)
+{
+    u32 Result = 0;
+    memory_arena_checkpoint Checkpoint = ArenaCheckpoint(Arena);
+
+    constexpr u32 BlockChunkCount = 27;
+    chunk_voxels* Voxels = PushArray<chunk_voxels>(Arena, BlockChunkCount);
+    chunk_voxels* Unpacked = PushStruct<chunk_voxels>(Arena);
+    {
+        chunk* Chunk = PushStruct<chunk>(Arena);
+        Chunk->Data = Bench_PushChunkData(Arena, 1);
+        Chunk->P = vec3i{ 0, 0, 0 };
+        GenerateHeightmap(Chunk, Generator);
+        s32 SurfaceZ = (Chunk->Heightmap[CHUNK_DIM_XY / 2][CHUNK_DIM_XY / 2] / CHUNK_DIM_Z) * CHUNK_DIM_Z;
+        for (u32 i = 0; i < BlockChunkCount; i++)
+        {
+            vec3i Offset = { (s32)(i % 3) - 1, (s32)((i / 3) % 3) - 1, (s32)(i / 9) - 1 };
+            Chunk->P = Offset * CHUNK_DIM_XY + vec3i{ 0, 0, SurfaceZ };
+            Generate(Chunk, Generator, Arena);
+            UnpackChunkData(Chunk->Data, Voxels + i);
+        }
+        ResetChunkData(Chunk->Data);
+    }
+
+    // NOTE(boti): The rays start inside the center chunk and are at most 8 voxels long (about the reach of the player),
+    //             so they never leave the block
+    constexpr u32 RayCount = 1u << 14;
+    constexpr f32 RayLength = 8.0f;
+    vec3* RayP = PushArray<vec3>(Arena, RayCount);
+    vec3* RayV = PushArray<vec3>(Arena, RayCount);
+    u32 Random = 0x2545F491u;
+    auto NextF32 = [&Random]() -> f32
+    {
+        Random = XorShift32(Random);
+        return (f32)(Random >> 8) * (1.0f / 16777216.0f);
+    };
+    for (u32 i = 0; i < RayCount; i++)
+    {
+        RayP[i] = vec3{ NextF32(), NextF32(), NextF32() } * (f32)CHUNK_DIM_XY + vec3{ 1.0f, 1.0f, 1.0f } * (f32)CHUNK_DIM_XY;
+        RayV[i] = NOZ(vec3{ NextF32() - 0.5f, NextF32() - 0.5f, NextF32() - 0.5f });
+    }
+
+    u64 ReferenceNeighborSum = 0;
+    u64 ReferenceRaySum = 0;
+    for (u32 Layout = 0; Layout < VoxelLayout_Count; Layout++)
+    {
+        bench_chunk_block Block = {};
+        chunk_data* Data = Bench_PushChunkData(Arena, BlockChunkCount);
+        for (u32 i = 0; i < BlockChunkCount; i++)
+        {
+            Data[i].Layout = (voxel_layout)Layout;
+            Block.Data[i / 9][(i / 3) % 3][i % 3] = Data + i;
+        }
+
+        s64 StartCounter = Bench_GetCounter();
+        for (u32 i = 0; i < BlockChunkCount; i++)
+        {
+            PackChunkData(Data + i, Voxels + i);
+        }
+        s64 MidCounter = Bench_GetCounter();
+        for (u32 i = 0; i < BlockChunkCount; i++)
+        {
+            UnpackChunkData(Data + i, Unpacked);
+        }
+        s64 EndCounter = Bench_GetCounter();
+        f64 PackTime = Bench_GetElapsedTime(StartCounter, MidCounter);
+        f64 UnpackTime = Bench_GetElapsedTime(MidCounter, EndCounter);
+
+        u64 NeighborSum = 0;
+        StartCounter = Bench_GetCounter();
+        for (s32 z = CHUNK_DIM_Z; z < 2 * CHUNK_DIM_Z; z++)
+        {
+            for (s32 y = CHUNK_DIM_XY; y < 2 * CHUNK_DIM_XY; y++)
+            {
+                for (s32 x = CHUNK_DIM_XY; x < 2 * CHUNK_DIM_XY; x++)
+                {
+                    for (s32 dz = -1; dz <= 1; dz++)
+                    {
+                        for (s32 dy = -1; dy <= 1; dy++)
+                        {
+                            for (s32 dx = -1; dx <= 1; dx++)
+                            {
+                                NeighborSum += Block.GetVoxelAt(vec3i{ x + dx, y + dy, z + dz });
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        EndCounter = Bench_GetCounter();
+        f64 NeighborTime = Bench_GetElapsedTime(StartCounter, EndCounter);
+
+        u64 RaySum = 0;
+        u32 HitCount = 0;
+        StartCounter = Bench_GetCounter();
+        for (u32 i = 0; i < RayCount; i++)
+        {
+            vec3 P = RayP[i];
+            vec3 V = RayV[i];
+            f32 tMax = RayLength;
+            aabb SearchBox = MakeAABB(Floor(P), Floor(P + tMax * V));
+            vec3i StartP = (vec3i)SearchBox.Min;
+            vec3i EndP = (vec3i)SearchBox.Max;
+
+            bool AnyHit = false;
+            vec3i HitP = {};
+            for (s32 z = StartP.z; z <= EndP.z; z++)
+            {
+                for (s32 y = StartP.y; y <= EndP.y; y++)
+                {
+                    for (s32 x = StartP.x; x <= EndP.x; x++)
+                    {
+                        if (Block.GetVoxelAt(vec3i{ x, y, z }) != VOXEL_AIR)
+                        {
+                            aabb Box = MakeAABB(vec3{ (f32)x, (f32)y, (f32)z }, vec3{ (f32)(x + 1), (f32)(y + 1), (f32)(z + 1) });
+                            f32 tCurrent;
+                            direction CurrentDir;
+                            if (IntersectRayAABB(P, V, Box, 0.0f, tMax, &tCurrent, &CurrentDir))
+                            {
+                                tMax = Min(tMax, tCurrent);
+                                HitP = vec3i{ x, y, z };
+                                AnyHit = true;
+                            }
+                        }
+                    }
+                }
+            }
+            if (AnyHit)
+            {
+                HitCount++;
+                RaySum += (u64)(HitP.x + (HitP.y << 8) + (HitP.z << 16));
+            }
+        }
+        EndCounter = Bench_GetCounter();
+        f64 RayTime = Bench_GetElapsedTime(StartCounter, EndCounter);
+
+        if (Layout == VoxelLayout_Linear)
+        {
+            ReferenceNeighborSum = NeighborSum;
+            ReferenceRaySum = RaySum;
+        }
+        bool IsMismatch = (NeighborSum != ReferenceNeighborSum) || (RaySum != ReferenceRaySum);
+        Result += IsMismatch ? 1 : 0;
+
+        constexpr u32 NeighborReadCount = 27 * CHUNK_DIM_XY * CHUNK_DIM_XY * CHUNK_DIM_Z;
+        printf("  %-6s pack %.3fms/chunk, unpack %.3fms/chunk, neighborhoods %5.2fns/read, ray casts %7.2fns/ray (%u/%u hit)%s\n",
+               VoxelLayoutNames[Layout], 1000.0 * PackTime / BlockChunkCount, 1000.0 * UnpackTime / BlockChunkCount,
+               1e9 * NeighborTime / NeighborReadCount, 1e9 * RayTime / RayCount, HitCount, RayCount,
+               IsMismatch ? ", differs from linear" : "");
+
+        for (u32 i = 0; i < BlockChunkCount; i++)
+        {
+            ResetChunkData(Data + i);
+        }
+    }
+
+    RestoreArena(Arena, Checkpoint);
+    return(Result);
+}
+
+// NOTE(boti): Same as GetVoxelTypeAt, either hashing into the chunk table for every voxel or going through the accessor
+template<bool UseAccessor>
+static u16 Bench_GetVoxelType(const chunk_table* Table, voxel_accessor* Accessor, vec3i P)
+{
+    u16 Result = VOXEL_AIR;
+    if constexpr (UseAccessor)
+    {
+        Result = GetVoxelType(Accessor, P);
+    }
+    else
+    {
+        vec3i ChunkP = 
+        {
+            FloorDiv(P.x, CHUNK_DIM_XY) * CHUNK_DIM_XY,
+            FloorDiv(P.y, CHUNK_DIM_XY) * CHUNK_DIM_XY,
+            FloorDiv(P.z, CHUNK_DIM_Z) * CHUNK_DIM_Z,
+        };
+        chunk* Chunk = FindChunk(Table, ChunkP);
+        if (Chunk && (Chunk->GenerationLevel == ChunkGen_LevelFinal))
+        {
+            vec3i RelP = P - ChunkP;
+            Result = GetVoxel(Chunk->Data, RelP.x, RelP.y, RelP.z);
+        }
+    }
+    return(Result);
+}
+
+// Box scanning ray casts (RayCast before the solid masks), returns the sum of the hit positions
+template<bool UseAccessor>
+static u64 Bench_CastRays(const chunk_table* Table, u32 RayCount, const vec3* RayP, const vec3* RayV, f32 RayLength, u32* OutHitCount)
+{
+    u64 Result = 0;
+    u32 HitCount = 0;
+    for (u32 i = 0; i < RayCount; i++)
+    {
+        voxel_accessor Accessor = MakeVoxelAccessor(Table);
+
+        vec3 P = RayP[i];
+        vec3 V = RayV[i];
+        f32 tMax = RayLength;
+        aabb SearchBox = MakeAABB(Floor(P), Floor(P + tMax * V));
+        vec3i StartP = (vec3i)SearchBox.Min;
+        vec3i EndP = (vec3i)SearchBox.Max;
+
+        bool AnyHit = false;
+        vec3i HitP = {};
+        for (s32 z = StartP.z; z <= EndP.z; z++)
+        {
+            for (s32 y = StartP.y; y <= EndP.y; y++)
+            {
+                for (s32 x = StartP.x; x <= EndP.x; x++)
+                {
+                    u16 VoxelType = Bench_GetVoxelType<UseAccessor>(Table, &Accessor, vec3i{ x, y, z });
+                    if (IsSolidVoxel(VoxelType))
+                    {
+                        aabb Box = MakeAABB(vec3{ (f32)x, (f32)y, (f32)z }, vec3{ (f32)(x + 1), (f32)(y + 1), (f32)(z + 1) });
+                        f32 tCurrent;
+                        direction CurrentDir;
+                        if (IntersectRayAABB(P, V, Box, 0.0f, tMax, &tCurrent, &CurrentDir))
+                        {
+                            tMax = Min(tMax, tCurrent);
+                            HitP = vec3i{ x, y, z };
+                            AnyHit = true;
+                        }
+                    }
+                }
+            }
+        }
+        if (AnyHit)
+        {
+            HitCount++;
+            Result += (u64)(HitP.x + (HitP.y << 8) + (HitP.z << 16));
+        }
+    }
+    *OutHitCount = HitCount;
+    return(Result);
+}
+
+// Gathers the solid voxels overlapping a player sized box (what MoveEntityBy collides against), returns their count
+template<bool UseAccessor>
+static u64 Bench_GatherCollisions(const chunk_table* Table, u32 BoxCount, const vec3* BoxP)
+{
+    constexpr f32 BoxWidth = 0.6f;
+    constexpr f32 BoxHeight = 1.8f;
+
+    u64 Result = 0;
+    for (u32 i = 0; i < BoxCount; i++)
+    {
+        voxel_accessor Accessor = MakeVoxelAccessor(Table);
+
+        vec3 Min = BoxP[i] - vec3{ 0.5f * BoxWidth, 0.5f * BoxWidth, 0.0f };
+        vec3 Max = BoxP[i] + vec3{ 0.5f * BoxWidth, 0.5f * BoxWidth, BoxHeight };
+        vec3i MinPi = (vec3i)Floor(Min);
+        vec3i MaxPi = (vec3i)Ceil(Max);
+        for (s32 z = MinPi.z; z <= MaxPi.z; z++)
+        {
+            for (s32 y = MinPi.y; y <= MaxPi.y; y++)
+            {
+                for (s32 x = MinPi.x; x <= MaxPi.x; x++)
+                {
+                    u16 VoxelType = Bench_GetVoxelType<UseAccessor>(Table, &Accessor, vec3i{ x, y, z });
+                    Result += IsSolidVoxel(VoxelType) ? 1 : 0;
+                }
+            }
+        }
+    }
+    return(Result);
+}
+
+// Ray casts and collision gathers voxel by voxel in a 3x3x3 block of chunks around the surface,
+// hashing into the chunk table for every voxel vs. going through a voxel accessor.
+// Returns 1 if the two disagree
+static u32 BenchVoxelAccessor(const world_generator* Generator, memory_arena* Arena)
+{
+    u32 Result = 0;
+    memory_arena_checkpoint Checkpoint = ArenaCheckpoint(Arena);
+
+    constexpr u32 BlockChunkCount = 27;
+    chunk* Chunks = PushArray<chunk>(Arena, BlockChunkCount);
+    chunk_data* Data = Bench_PushChunkData(Arena, BlockChunkCount);
+    chunk_table Table = {};
+    if (!Chunks || !Data || !InitializeChunkTable(&Table, 2 * BlockChunkCount, Arena))
+    {
+        printf("  Not enough memory\n");
+        RestoreArena(Arena, Checkpoint);
+        return(1);
+    }
+
+    Chunks[0].P = vec3i{ 0, 0, 0 };
+    GenerateHeightmap(Chunks, Generator);
+    s32 SurfaceZ = (Chunks[0].Heightmap[CHUNK_DIM_XY / 2][CHUNK_DIM_XY / 2] / CHUNK_DIM_Z) * CHUNK_DIM_Z;
+    for (u32 i = 0; i < BlockChunkCount; i++)
+    {
+        vec3i Offset = { (s32)(i % 3) - 1, (s32)((i / 3) % 3) - 1, (s32)(i / 9) - 1 };
+        chunk* Chunk = Chunks + i;
+        Chunk->Data = Data + i;
+        Chunk->P = Offset * CHUNK_DIM + vec3i{ 0, 0, SurfaceZ };
+        Generate(Chunk, Generator, Arena);
+        Chunk->GenerationLevel = ChunkGen_LevelFinal;
+        InsertChunk(&Table, Chunk);
+    }
+
+    // NOTE(boti): The rays and boxes are in the center chunk, the rays are at most 8 voxels long (about the reach of the player),
+    //             so neither of them leave the block
+    constexpr u32 QueryCount = 1u << 14;
+    constexpr f32 RayLength = 8.0f;
+    vec3* RayP = PushArray<vec3>(Arena, QueryCount);
+    vec3* RayV = PushArray<vec3>(Arena, QueryCount);
+    vec3* BoxP = PushArray<vec3>(Arena, QueryCount);
+    u32 Random = 0x68E31DA4u;
+    auto NextF32 = [&Random]() -> f32
+    {
+        Random = XorShift32(Random);
+        return (f32)(Random >> 8) * (1.0f / 16777216.0f);
+    };
+    vec3 CenterChunkP = vec3{ 0.0f, 0.0f, (f32)SurfaceZ };
+    for (u32 i = 0; i < QueryCount; i++)
+    {
+        RayP[i] = vec3{ NextF32(), NextF32(), NextF32() } * (f32)CHUNK_DIM_XY + CenterChunkP;
+        RayV[i] = NOZ(vec3{ NextF32() - 0.5f, NextF32() - 0.5f, NextF32() - 0.5f });
+        BoxP[i] = vec3{ NextF32(), NextF32(), NextF32() } * (f32)CHUNK_DIM_XY + CenterChunkP;
+    }
+
+    u32 HashedHitCount = 0;
+    u32 AccessorHitCount = 0;
+    s64 StartCounter = Bench_GetCounter();
+    u64 HashedRaySum = Bench_CastRays<false>(&Table, QueryCount, RayP, RayV, RayLength, &HashedHitCount);
+    s64 MidCounter = Bench_GetCounter();
+    u64 AccessorRaySum = Bench_CastRays<true>(&Table, QueryCount, RayP, RayV, RayLength, &AccessorHitCount);
+    s64 EndCounter = Bench_GetCounter();
+    f64 HashedRayTime = Bench_GetElapsedTime(StartCounter, MidCounter);
+    f64 AccessorRayTime = Bench_GetElapsedTime(MidCounter, EndCounter);
+
+    StartCounter = Bench_GetCounter();
+    u64 HashedSolidCount = Bench_GatherCollisions<false>(&Table, QueryCount, BoxP);
+    MidCounter = Bench_GetCounter();
+    u64 AccessorSolidCount = Bench_GatherCollisions<true>(&Table, QueryCount, BoxP);
+    EndCounter = Bench_GetCounter();
+    f64 HashedBoxTime = Bench_GetElapsedTime(StartCounter, MidCounter);
+    f64 AccessorBoxTime = Bench_GetElapsedTime(MidCounter, EndCounter);
+
+    bool IsMismatch = (HashedRaySum != AccessorRaySum) || (HashedHitCount != AccessorHitCount) || (HashedSolidCount != AccessorSolidCount);
+    Result += IsMismatch ? 1 : 0;
+
+    printf("  Ray casts:  hashed %7.2fns/ray, accessor %7.2fns/ray (%.2fx, %u/%u hit)\n",
+           1e9 * HashedRayTime / QueryCount, 1e9 * AccessorRayTime / QueryCount, HashedRayTime / AccessorRayTime,
+           AccessorHitCount, QueryCount);
+    printf("  Collision:  hashed %7.2fns/box, accessor %7.2fns/box (%.2fx, %llu solid voxels)%s\n",
+           1e9 * HashedBoxTime / QueryCount, 1e9 * AccessorBoxTime / QueryCount, HashedBoxTime / AccessorBoxTime,
+           AccessorSolidCount, IsMismatch ? ", the accessor disagrees" : "");
+
+    for (u32 i = 0; i < BlockChunkCount; i++)
+    {
+        ResetChunkData(Data + i);
+    }
+    RestoreArena(Arena, Checkpoint);
+    return(Result);
+}
+
+// Generates a square of chunks with Graph and reports the generation speed, the fraction of the stone turned into ore
+// and the fraction of the ground carved out by caves
+// NOTE(boti): Streams a window of chunks through the table the way the world does (the chunks that fall out are erased,
+//             the ones that come in are inserted), with a teleport every once in a while,
+//             and looks up every chunk of the window and the ring around it after each step.
+//             The capacity is a percentage of the window's chunk count (before rounding up to a power of 2),
+//             the tight ones run out of space because of the tombstones and have to be rehashed.
+static u32 BenchChunkTable(u32 CapacityPercent, memory_arena* Arena)
+{
+    u32 Result = 0;
+    memory_arena_checkpoint Checkpoint = ArenaCheckpoint(Arena);
+
+    constexpr s32 RadiusXY = 10;
+    constexpr s32 RadiusZ = 3;
+    constexpr u32 WindowCount = (2*RadiusXY + 1)*(2*RadiusXY + 1)*(2*RadiusZ + 1);
+    chunk* Chunks = PushArray<chunk>(Arena, WindowCount);
+    b32* IsLoaded = PushArray<b32>(Arena, WindowCount);
+    u32 FreeCount = WindowCount;
+    chunk** FreeChunks = PushArray<chunk*>(Arena, WindowCount);
+    chunk_table Table = {};
+    if (!Chunks || !IsLoaded || !FreeChunks || !InitializeChunkTable(&Table, WindowCount * CapacityPercent / 100, Arena))
+    {
+        printf("  Not enough memory\n");
+        RestoreArena(Arena, Checkpoint);
+        return(1);
+    }
+    for (u32 i = 0; i < WindowCount; i++)
+    {
+        IsLoaded[i] = false;
+        FreeChunks[i] = Chunks + i;
+    }
+
+    auto IsInWindow = [](vec3i P, vec3i CenterP) -> bool
+    {
+        vec3i d = (P - CenterP);
+        bool Result = 
+            (Abs(d.x) <= RadiusXY * CHUNK_DIM_XY) && 
+            (Abs(d.y) <= RadiusXY * CHUNK_DIM_XY) && 
+            (Abs(d.z) <= RadiusZ * CHUNK_DIM_Z);
+        return(Result);
+    };
+
+    constexpr u32 StepCount = 256;
+    constexpr u32 TeleportInterval = 64;
+    u32 RehashCount = 0;
+    u32 MaxTombstoneCount = 0;
+    u64 LookupCount = 0;
+    u64 HitCount = 0;
+    f64 LookupTime = 0.0;
+    vec3i CenterP = {};
+    for (u32 Step = 0; Step < StepCount; Step++)
+    {
+        CenterP = CenterP + ((Step % TeleportInterval) ? vec3i{ 1, 0, 0 } : vec3i{ 1000, -700, 30 }) * CHUNK_DIM;
+
+        for (u32 i = 0; i < WindowCount; i++)
+        {
+            if (IsLoaded[i] && !IsInWindow(Chunks[i].P, CenterP))
+            {
+                EraseChunk(&Table, Chunks + i);
+                IsLoaded[i] = false;
+                FreeChunks[FreeCount++] = Chunks + i;
+            }
+        }
+        MaxTombstoneCount = Max(MaxTombstoneCount, Table.TombstoneCount);
+
+        for (s32 z = -RadiusZ; z <= RadiusZ; z++)
+        {
+            for (s32 y = -RadiusXY; y <= RadiusXY; y++)
+            {
+                for (s32 x = -RadiusXY; x <= RadiusXY; x++)
+                {
+                    vec3i P = CenterP + vec3i{ x, y, z } * CHUNK_DIM;
+                    if (!FindChunk(&Table, P))
+                    {
+                        if (Table.Count + Table.TombstoneCount >= Table.MaxUsedCount)
+                        {
+                            RehashChunkTable(&Table);
+                            RehashCount++;
+                        }
+
+                        assert(FreeCount);
+                        chunk* Chunk = FreeChunks[--FreeCount];
+                        Chunk->P = P;
+                        if (InsertChunk(&Table, Chunk))
+                        {
+                            IsLoaded[Chunk - Chunks] = true;
+                        }
+                        else
+                        {
+                            FreeCount++;
+                            Result++;
+                        }
+                    }
+                }
+            }
+        }
+
+        s64 StartCounter = Bench_GetCounter();
+        u64 StepHitCount = 0;
+        u32 StepMismatchCount = 0;
+        for (s32 z = -RadiusZ - 1; z <= RadiusZ + 1; z++)
+        {
+            for (s32 y = -RadiusXY - 1; y <= RadiusXY + 1; y++)
+            {
+                for (s32 x = -RadiusXY - 1; x <= RadiusXY + 1; x++)
+                {
+                    vec3i P = CenterP + vec3i{ x, y, z } * CHUNK_DIM;
+                    chunk* Chunk = FindChunk(&Table, P);
+                    if (Chunk)
+                    {
+                        StepHitCount++;
+                    }
+                    if ((Chunk != nullptr) != IsInWindow(P, CenterP) || (Chunk && Chunk->P != P))
+                    {
+                        StepMismatchCount++;
+                    }
+                }
+            }
+        }
+        s64 EndCounter = Bench_GetCounter();
+        LookupTime += Bench_GetElapsedTime(StartCounter, EndCounter);
+        LookupCount += (u64)(2*RadiusXY + 3)*(2*RadiusXY + 3)*(2*RadiusZ + 3);
+        HitCount += StepHitCount;
+        Result += StepMismatchCount;
+    }
+
+    printf("  %u steps (%u chunks, capacity %u): %.2fns/lookup (%.1f%% hits), %u tombstones at most, %u rehashes, mismatches: %u\n",
+           StepCount, WindowCount, Table.Capacity, 1e9 * LookupTime / (f64)LookupCount, 100.0 * (f64)HitCount / (f64)LookupCount,
+           MaxTombstoneCount, RehashCount, Result);
+
+    RestoreArena(Arena, Checkpoint);
+    return(Result);
+}
+
+// NOTE(boti): Field by field, the structs have padding that the compiler doesn't have to clear,
+//             and only the used part of the fixed size arrays is compared
+static bool AreNoiseProgramsEqual(const noise_program* A, const noise_program* B)
+{
+    bool Result = (A->OpCount == B->OpCount);
+    for (u32 OpIndex = 0; Result && (OpIndex < A->OpCount); OpIndex++)
+    {
+        const noise_op* OpA = A->Ops + OpIndex;
+        const noise_op* OpB = B->Ops + OpIndex;
+        Result = (OpA->Type == OpB->Type) && (OpA->Value == OpB->Value) &&
+            (OpA->OctaveCount == OpB->OctaveCount) && (OpA->Persistence == OpB->Persistence) && (OpA->Lacunarity == OpB->Lacunarity);
+    }
+    return(Result);
+}
+
+static bool AreNoiseGraphsEqual(const noise_graph* A, const noise_graph* B)
+{
+    bool Result = AreNoiseProgramsEqual(&A->Height, &B->Height) &&
+        AreNoiseProgramsEqual(&A->Temperature, &B->Temperature) &&
+        AreNoiseProgramsEqual(&A->Humidity, &B->Humidity);
+
+    Result = Result && (A->LayerCount == B->LayerCount);
+    for (u32 LayerIndex = 0; Result && (LayerIndex < A->LayerCount); LayerIndex++)
+    {
+        Result = (A->LayerTypes[LayerIndex] == B->LayerTypes[LayerIndex]) &&
+            (A->LayerEndDepths[LayerIndex] == B->LayerEndDepths[LayerIndex]);
+    }
+
+    Result = Result && (A->FieldCount == B->FieldCount);
+    for (u32 FieldIndex = 0; Result && (FieldIndex < A->FieldCount); FieldIndex++)
+    {
+        Result = (strncmp(A->FieldNames[FieldIndex], B->FieldNames[FieldIndex], noise_graph::MaxFieldNameLength) == 0) &&
+            AreNoiseProgramsEqual(A->Fields + FieldIndex, B->Fields + FieldIndex);
+    }
+
+    Result = Result && (A->RuleCount == B->RuleCount);
+    for (u32 RuleIndex = 0; Result && (RuleIndex < A->RuleCount); RuleIndex++)
+    {
+        const noise_rule* RuleA = A->Rules + RuleIndex;
+        const noise_rule* RuleB = B->Rules + RuleIndex;
+        Result = (RuleA->FromTypeMask == RuleB->FromTypeMask) && (RuleA->ToType == RuleB->ToType) &&
+            (RuleA->FieldIndex == RuleB->FieldIndex) && (RuleA->Compare == RuleB->Compare) &&
+            (RuleA->Threshold == RuleB->Threshold) && (RuleA->Ceiling == RuleB->Ceiling);
+    }
+
+    Result = Result && (A->BiomeCount == B->BiomeCount);
+    for (u32 BiomeIndex = 0; Result && (BiomeIndex < A->BiomeCount); BiomeIndex++)
+    {
+        const noise_biome* BiomeA = A->Biomes + BiomeIndex;
+        const noise_biome* BiomeB = B->Biomes + BiomeIndex;
+        Result = (strncmp(A->BiomeNames[BiomeIndex], B->BiomeNames[BiomeIndex], noise_graph::MaxBiomeNameLength) == 0) &&
+            (BiomeA->SurfaceType == BiomeB->SurfaceType) &&
+            (BiomeA->Temperature == BiomeB->Temperature) && (BiomeA->Humidity == BiomeB->Humidity) &&
+            (BiomeA->HeightScale == BiomeB->HeightScale) && (BiomeA->HeightOffset == BiomeB->HeightOffset);
+    }
+
+    Result = Result && (A->OreCount == B->OreCount);
+    for (u32 OreIndex = 0; Result && (OreIndex < A->OreCount); OreIndex++)
+    {
+        const noise_ore* OreA = A->Ores + OreIndex;
+        const noise_ore* OreB = B->Ores + OreIndex;
+        Result = (OreA->Type == OreB->Type) && (OreA->CountPerChunk == OreB->CountPerChunk) &&
+            (OreA->MinRadius == OreB->MinRadius) && (OreA->MaxRadius == OreB->MaxRadius) &&
+            (OreA->MinZ == OreB->MinZ) && (OreA->MaxZ == OreB->MaxZ);
+    }
+
+    Result = Result &&
+        (A->Worms.CountPerRegion == B->Worms.CountPerRegion) && (A->Worms.SegmentCount == B->Worms.SegmentCount) &&
+        (A->Worms.MinRadius == B->Worms.MinRadius) && (A->Worms.MaxRadius == B->Worms.MaxRadius) &&
+        (A->Worms.MinZ == B->Worms.MinZ) && (A->Worms.MaxZ == B->Worms.MaxZ);
+    return(Result);
+}
+
+// NOTE(boti): The density lattice samples every field of the graph, not just the ones the rules use,
+//             so the fields that lost their rules have to go too for the feature costs to be isolated
+static void RemoveUnusedNoiseFields(noise_graph* Graph)
+{
+    u32 UsedFieldMask = 0;
+    for (u32 RuleIndex = 0; RuleIndex < Graph->RuleCount; RuleIndex++)
+    {
+        UsedFieldMask |= 1u << Graph->Rules[RuleIndex].FieldIndex;
+    }
+
+    u32 NewFieldIndices[noise_graph::MaxFieldCount] = {};
+    u32 FieldCount = 0;
+    for (u32 FieldIndex = 0; FieldIndex < Graph->FieldCount; FieldIndex++)
+    {
+        if (UsedFieldMask & (1u << FieldIndex))
+        {
+            NewFieldIndices[FieldIndex] = FieldCount;
+            memcpy(Graph->FieldNames[FieldCount], Graph->FieldNames[FieldIndex], noise_graph::MaxFieldNameLength);
+            Graph->Fields[FieldCount] = Graph->Fields[FieldIndex];
+            FieldCount++;
+        }
+    }
+    Graph->FieldCount = FieldCount;
+
+    for (u32 RuleIndex = 0; RuleIndex < Graph->RuleCount; RuleIndex++)
+    {
+        Graph->Rules[RuleIndex].FieldIndex = NewFieldIndices[Graph->Rules[RuleIndex].FieldIndex];
+    }
+}
+
+static void BenchFeatures(const char* Name, const world_generator* BaseGenerator, const noise_graph* Graph,
+                      s32 ChunkCountSqrt, chunk_data* Data, memory_arena* Arena)
+{
+    world_generator* Generator = PushStruct<world_generator>(Arena);
+    *Generator = *BaseGenerator;
+    Generator->Graph = *Graph;
+    Generator->ColumnCache = nullptr;
+
+    u64 VoxelCounts[VoxelDescCount] = {};
+    u64 GroundCount = 0;
+    u64 CaveCount = 0;
+    f64 Time = 0.0;
+    chunk_voxels* Voxels = PushStruct<chunk_voxels>(Arena);
+    chunk Chunk = {};
+    Chunk.Data = Data;
+    for (s32 y = 0; y < ChunkCountSqrt; y++)
+    {
+        for (s32 x = 0; x < ChunkCountSqrt; x++)
+        {
+            for (s32 ChunkZ = 0; ChunkZ < BENCH_COLUMN_CHUNK_COUNT; ChunkZ++)
+            {
+                Chunk.P = vec3i{ x - ChunkCountSqrt / 2, y - ChunkCountSqrt / 2, ChunkZ } * CHUNK_DIM_XY;
+
+                s64 StartCounter = Bench_GetCounter();
+                Generate(&Chunk, Generator, Arena);
+                s64 EndCounter = Bench_GetCounter();
+                Time += Bench_GetElapsedTime(StartCounter, EndCounter);
+
+                UnpackChunkData(Data, Voxels);
+                for (u32 i = 0; i < CHUNK_DIM_Z * CHUNK_DIM_XY * CHUNK_DIM_XY; i++)
+                {
+                    VoxelCounts[(&Voxels->Voxels[0][0][0])[i]]++;
+                }
+
+                for (u32 y = 0; y < CHUNK_DIM_XY; y++)
+                {
+                    for (u32 x = 0; x < CHUNK_DIM_XY; x++)
+                    {
+                        s32 MaxZ = Min(Chunk.Heightmap[y][x] - Chunk.P.z, CHUNK_DIM_Z - 1);
+                        for (s32 z = 0; z <= MaxZ; z++)
+                        {
+                            GroundCount++;
+                            CaveCount += (Voxels->Voxels[z][y][x] == VOXEL_AIR) ? 1 : 0;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    u32 ChunkCount = (u32)(ChunkCountSqrt * ChunkCountSqrt);
+    f64 StoneCount = (f64)(VoxelCounts[VOXEL_STONE] + VoxelCounts[VOXEL_COAL] + VoxelCounts[VOXEL_IRON]);
+    printf("  %s: %8.2f columns/s (%.2fms/column), coal %.2f%%, iron %.2f%% of the stone, caves %.2f%% of the ground\n", Name,
+           ChunkCount / Time, 1000.0 * Time / ChunkCount,
+           100.0 * VoxelCounts[VOXEL_COAL] / StoneCount, 100.0 * VoxelCounts[VOXEL_IRON] / StoneCount,
+           100.0 * CaveCount / GroundCount);
+}
+
+// Heightmap pass with and without the biomes of Graph, validated against the scalar queries.
+// Returns the number of mismatching columns
+static u32 BenchBiomes(const world_generator* BaseGenerator, const noise_graph* Graph, s32 ChunkCountSqrt, memory_arena* Arena)
+{
+    u32 Result = 0;
+
+    world_generator* Generator = PushStruct<world_generator>(Arena);
+    world_generator* NoBiomeGenerator = PushStruct<world_generator>(Arena);
+    chunk* Chunk = PushStruct<chunk>(Arena);
+    *Generator = *BaseGenerator;
+    Generator->Graph = *Graph;
+    Generator->ColumnCache = nullptr;
+    *NoBiomeGenerator = *Generator;
+    NoBiomeGenerator->Graph.BiomeCount = 0;
+
+    f64 BiomeTime = 0.0;
+    f64 NoBiomeTime = 0.0;
+    for (s32 y = 0; y < ChunkCountSqrt; y++)
+    {
+        for (s32 x = 0; x < ChunkCountSqrt; x++)
+        {
+            Chunk->P = vec3i{ x - ChunkCountSqrt / 2, y - ChunkCountSqrt / 2, 0 } * CHUNK_DIM_XY;
+
+            s64 StartCounter = Bench_GetCounter();
+            GenerateHeightmap(Chunk, NoBiomeGenerator);
+            s64 MidCounter = Bench_GetCounter();
+            GenerateHeightmap(Chunk, Generator);
+            s64 EndCounter = Bench_GetCounter();
+            NoBiomeTime += Bench_GetElapsedTime(StartCounter, MidCounter);
+            BiomeTime += Bench_GetElapsedTime(MidCounter, EndCounter);
+
+            for (s32 ColumnY = 0; ColumnY < CHUNK_DIM_XY; ColumnY++)
+            {
+                for (s32 ColumnX = 0; ColumnX < CHUNK_DIM_XY; ColumnX++)
+                {
+                    vec2i P = (vec2i)Chunk->P + vec2i{ ColumnX, ColumnY };
+                    if ((GetTerrainHeight(Generator, P) != Chunk->Heightmap[ColumnY][ColumnX]) ||
+                        (GetBiome(Generator, P) != Chunk->Biomes[ColumnY][ColumnX]))
+                    {
+                        Result++;
+                    }
+                }
+            }
+        }
+    }
+
+    u32 ChunkCount = (u32)(ChunkCountSqrt * ChunkCountSqrt);
+    f64 ColumnCount = (f64)ChunkCount * CHUNK_DIM_XY * CHUNK_DIM_XY;
+    printf("  Heightmap: %.3fms/chunk with %u biomes, %.3fms/chunk without (+%.2fns/column), mismatching columns: %u\n",
+           1000.0 * BiomeTime / ChunkCount, Graph->BiomeCount, 1000.0 * NoBiomeTime / ChunkCount,
+           1e9 * (BiomeTime - NoBiomeTime) / ColumnCount, Result);
+
+    // NOTE(boti): The climate changes slowly, so the distribution is sampled over a much larger area than what's generated
+    constexpr s32 SampleCountSqrt = 256;
+    constexpr s32 SampleSpacing = 64;
+    u32 BiomeColumnCounts[noise_graph::MaxBiomeCount] = {};
+    for (s32 y = 0; y < SampleCountSqrt; y++)
+    {
+        for (s32 x = 0; x < SampleCountSqrt; x++)
+        {
+            vec2i P = vec2i{ x - SampleCountSqrt / 2, y - SampleCountSqrt / 2 } * SampleSpacing;
+            BiomeColumnCounts[GetBiome(Generator, P)]++;
+        }
+    }
+    printf("  Distribution:");
+    for (u32 BiomeIndex = 0; BiomeIndex < Graph->BiomeCount; BiomeIndex++)
+    {
+        printf(" %s %.1f%%", Graph->BiomeNames[BiomeIndex], 100.0 * BiomeColumnCounts[BiomeIndex] / (SampleCountSqrt * SampleCountSqrt));
+    }
+    printf("\n");
+
+    return(Result);
+}
+
+int main(int ArgCount, char** Args)
+{
+    s32 ChunkCountSqrt = (ArgCount > 1) ? atoi(Args[1]) : 8;
+    u32 Seed = (ArgCount > 2) ? (u32)strtoul(Args[2], nullptr, 10) : 1337;
+    const char* SliceBitmapPath = (ArgCount > 3) ? Args[3] : nullptr;
+    if (ChunkCountSqrt <= 0)
+    {
+        fprintf(stderr, "Usage: %s [ChunkCountSqrt] [Seed] [SliceBitmapPath]\n", Args[0]);
+        return 1;
+    }
+
+    LARGE_INTEGER Frequency;
+    QueryPerformanceFrequency(&Frequency);
+    Bench_PerformanceFrequency = Frequency.QuadPart;
+
+    cpu_features CPUFeatures = DetectCPUFeatures();
+    cpu_level CPULevel = GetCPULevel(&CPUFeatures);
+    Kernels = GetSIMDKernels(CPULevel);
+
+    u32 ChunkCount = (u32)(ChunkCountSqrt * ChunkCountSqrt);
+
+    // NOTE(boti): There are never more than 32 chunk_datas alive (the layout bench and the decoration neighborhood are the biggest users),
+    //             twice that because the freed blocks of one index width can't be reused for another
+    constexpr u64 SectionPoolSize = 64 * CHUNK_SECTION_COUNT * CHUNK_MAX_SECTION_INDICES_SIZE;
+    u64 MemorySize = MiB(64) + MiB(16) + SectionPoolSize + 27 * sizeof(chunk_data) + 2 * ChunkCount * sizeof(u64);
+    void* Memory = VirtualAlloc(nullptr, MemorySize, MEM_COMMIT|MEM_RESERVE, PAGE_READWRITE);
+    if (!Memory)
+    {
+        fprintf(stderr, "Failed to allocate memory\n");
+        return 1;
+    }
+    memory_arena Arena = InitializeArena(MemorySize, Memory);
+    InitializeChunkSectionPool(&Bench_SectionPool, SectionPoolSize, PushSize(&Arena, SectionPoolSize));
+
+    world_generator* Generator = PushStruct<world_generator>(&Arena);
+    chunk_data* Data = Bench_PushChunkData(&Arena, 1);
+    chunk_data* ReferenceData = Bench_PushChunkData(&Arena, 1);
+    u64* ReferenceHashes = PushArray<u64>(&Arena, ChunkCount);
+    u64* Hashes = PushArray<u64>(&Arena, ChunkCount);
+    InitializeWorldGenerator(Generator, Seed, buffer{}, &Arena);
+
+    printf("Generating %u chunk columns (seed: %u, %s kernels)\n", ChunkCount, Seed, CPULevelNames[CPULevel]);
+
+    f64 ReferenceTime = BenchGenerate(Generator, &Generate_Reference, ChunkCountSqrt, Data, ReferenceHashes, &Arena);
+    printf("  Reference: %8.2f columns/s (%.2fms/column)\n", ChunkCount / ReferenceTime, 1000.0 * ReferenceTime / ChunkCount);
+
+    f64 GenerateTime = BenchGenerate(Generator, &Generate, ChunkCountSqrt, Data, Hashes, &Arena);
+    printf("  Generate:  %8.2f columns/s (%.2fms/column), %.2fx\n", ChunkCount / GenerateTime, 1000.0 * GenerateTime / ChunkCount, ReferenceTime / GenerateTime);
+
+    u32 MismatchCount = 0;
+    for (u32 i = 0; i < ChunkCount; i++)
+    {
+        if (Hashes[i] != ReferenceHashes[i])
+        {
+            MismatchCount++;
+        }
+    }
+    printf("  Mismatching columns: %u/%u\n", MismatchCount, ChunkCount);
+
+    // Heightmap pass alone, validated against the scalar terrain height query
+    {
+        u32 MismatchColumnCount = 0;
+        f64 HeightmapTime = 0.0;
+        chunk* Chunk = PushStruct<chunk>(&Arena);
+        for (s32 y = 0; y < ChunkCountSqrt; y++)
+        {
+            for (s32 x = 0; x < ChunkCountSqrt; x++)
+            {
+                Chunk->P = vec3i{ x - ChunkCountSqrt / 2, y - ChunkCountSqrt / 2, 0 } * CHUNK_DIM_XY;
+
+                s64 StartCounter = Bench_GetCounter();
+                GenerateHeightmap(Chunk, Generator);
+                s64 EndCounter = Bench_GetCounter();
+                HeightmapTime += Bench_GetElapsedTime(StartCounter, EndCounter);
+
+                for (s32 ColumnY = 0; ColumnY < CHUNK_DIM_XY; ColumnY++)
+                {
+                    for (s32 ColumnX = 0; ColumnX < CHUNK_DIM_XY; ColumnX++)
+                    {
+                        s32 Height = GetTerrainHeight(Generator, (vec2i)Chunk->P + vec2i{ ColumnX, ColumnY });
+                        if (Height != Chunk->Heightmap[ColumnY][ColumnX])
+                        {
+                            MismatchColumnCount++;
+                        }
+                    }
+                }
+            }
+        }
+        printf("  Heightmap: %8.2f chunks/s (%.3fms/chunk), mismatching columns: %u\n", 
+               ChunkCount / HeightmapTime, 1000.0 * HeightmapTime / ChunkCount, MismatchColumnCount);
+        MismatchCount += MismatchColumnCount;
+    }
+
+    // Voxel layouts
+    {
+        printf("Voxel layouts:\n");
+        MismatchCount += BenchVoxelLayouts(Generator, &Arena);
+    }
+
+    // Voxel storage
+    {
+        printf("Chunk storage:\n");
+        MismatchCount += BenchChunkStorage(Generator, ChunkCountSqrt, &Arena);
+    }
+
+    {
+        printf("Chunk table:\n");
+        MismatchCount += BenchChunkTable(200, &Arena);
+        MismatchCount += BenchChunkTable(110, &Arena);
+    }
+
+    {
+        printf("Voxel accessor:\n");
+        MismatchCount += BenchVoxelAccessor(Generator, &Arena);
+    }
+
+    // Decorations for the 3x3x3 neighborhood around the surface chunk at the origin, the center chunk gets the structures of all of them
+    {
+        chunk* Chunks = PushArray<chunk>(&Arena, 27);
+        chunk_data* ChunkData = Bench_PushChunkData(&Arena, 27);
+        const chunk* Neighborhood[3][3][3] = {};
+
+        Chunks->P = vec3i{ 0, 0, 0 };
+        GenerateHeightmap(Chunks, Generator);
+        s32 SurfaceZ = (Chunks->Heightmap[CHUNK_DIM_XY / 2][CHUNK_DIM_XY / 2] / CHUNK_DIM_Z) * CHUNK_DIM_Z;
+
+        u32 StructureCount = 0;
+        for (s32 z = 0; z < 3; z++)
+        {
+            for (s32 y = 0; y < 3; y++)
+            {
+                for (s32 x = 0; x < 3; x++)
+                {
+                    chunk* Chunk = Chunks + (x + 3 * y + 9 * z);
+                    Chunk->P = vec3i{ x - 1, y - 1, z - 1 } * CHUNK_DIM_XY + vec3i{ 0, 0, SurfaceZ };
+                    Chunk->Data = ChunkData + (x + 3 * y + 9 * z);
+                    Generate(Chunk, Generator, &Arena);
+                    StructureCount += Chunk->StructurePlacementCount;
+                    Neighborhood[z][y][x] = Chunk;
+                }
+            }
+        }
+
+        chunk* Center = Chunks + 13;
+        u32 ChangedVoxelCount = 0;
+        chunk_voxels* Before = PushStruct<chunk_voxels>(&Arena);
+        chunk_voxels* After = PushStruct<chunk_voxels>(&Arena);
+        UnpackChunkData(Center->Data, Before);
+        s64 StartCounter = Bench_GetCounter();
+        GenerateDecorations(Center, Neighborhood, Generator);
+        s64 EndCounter = Bench_GetCounter();
+        UnpackChunkData(Center->Data, After);
+        u32 BoundsMismatchCount = CountColumnBoundsMismatches(Center, &Arena);
+        u32 MaskMismatchCount = CountVoxelMaskMismatches(Center, &Arena);
+        MismatchCount += BoundsMismatchCount + MaskMismatchCount;
+        for (u32 i = 0; i < CHUNK_DIM_Z * CHUNK_DIM_XY * CHUNK_DIM_XY; i++)
+        {
+            if ((&Before->Voxels[0][0][0])[i] != (&After->Voxels[0][0][0])[i])
+            {
+                ChangedVoxelCount++;
+            }
+        }
+        printf("  Decorations: %u structures in the neighborhood, %u voxels written, %.3fms, columns with wrong bounds: %u, rows with wrong voxel masks: %u\n",
+               StructureCount, ChangedVoxelCount, 1000.0 * Bench_GetElapsedTime(StartCounter, EndCounter), BoundsMismatchCount, MaskMismatchCount);
+    }
+
+    // NOTE(boti): The density lattice is an approximation, so differences here are expected and don't count as failures
+    printf("Density lattice (ores, caves):\n");
+    for (u32 Spacing = 1; Spacing <= 8; Spacing *= 2)
+    {
+        BenchDensityLattice(Generator, Spacing, ChunkCountSqrt, ReferenceData, Data, &Arena);
+    }
+
+    // Hash noise
+    {
+        printf("Hash noise:\n");
+
+        if (CPULevel >= CPULevel_AVX2)
+        {
+            u32 NoiseMismatchCount = ValidateHashNoise(&Generator->HashNoise, 1u << 16, 1e6f);
+            printf("  8-wide vs scalar mismatches: %u\n", NoiseMismatchCount);
+            MismatchCount += NoiseMismatchCount;
+        }
+
+        // NOTE(boti): The permutation table makes perlin noise repeat every 256 lattice cells,
+        //             which is 16384 blocks at the default terrain frequency
+        constexpr f32 PerlinPeriod = (f32)perlin3::TableCount;
+        printf("  Samples repeating after %.0f lattice cells: perlin %u/256, hash %u/256\n", PerlinPeriod,
+               CountRepeatingSamples(&Generator->Perlin3, PerlinPeriod), CountRepeatingSamples(&Generator->HashNoise, PerlinPeriod));
+
+        Generator->NoiseType = Noise_Hash;
+        Generator->DensityNoiseType = Noise_Hash;
+
+        f64 HashTime = BenchGenerate(Generator, &Generate, ChunkCountSqrt, Data, Hashes, &Arena);
+        printf("  Generate:  %8.2f columns/s (%.2fms/column), %.2fx vs perlin\n", 
+               ChunkCount / HashTime, 1000.0 * HashTime / ChunkCount, GenerateTime / HashTime);
+
+        // The heightmap pass has to agree with the scalar query for the hash noise too
+        u32 MismatchColumnCount = 0;
+        chunk* Chunk = PushStruct<chunk>(&Arena);
+        Chunk->P = vec3i{ 1 << 20, -(1 << 20), 0 };
+        GenerateHeightmap(Chunk, Generator);
+        for (s32 ColumnY = 0; ColumnY < CHUNK_DIM_XY; ColumnY++)
+        {
+            for (s32 ColumnX = 0; ColumnX < CHUNK_DIM_XY; ColumnX++)
+            {
+                if (GetTerrainHeight(Generator, (vec2i)Chunk->P + vec2i{ ColumnX, ColumnY }) != Chunk->Heightmap[ColumnY][ColumnX])
+                {
+                    MismatchColumnCount++;
+                }
+            }
+        }
+        printf("  Heightmap mismatching columns: %u\n", MismatchColumnCount);
+        MismatchCount += MismatchColumnCount;
+
+        Generator->NoiseType = Noise_Perlin;
+        Generator->DensityNoiseType = Noise_Perlin;
+    }
+
+    // Simplex noise
+    {
+        printf("Simplex noise:\n");
+
+        if (CPULevel >= CPULevel_AVX2)
+        {
+            u32 NoiseMismatchCount = ValidateNoise3(&Generator->Simplex3, 1u << 16, 1e6f);
+            printf("  8-wide vs scalar mismatches: %u\n", NoiseMismatchCount);
+            MismatchCount += NoiseMismatchCount;
+
+            constexpr u32 SampleCount = 1u << 24;
+            f32 SampleMin, SampleMax;
+            f64 PerlinCost = BenchNoise3(&Generator->Perlin3, SampleCount, &SampleMin, &SampleMax);
+            printf("  perlin3: %6.2fns/sample, range [%.3f, %.3f]\n", PerlinCost, SampleMin, SampleMax);
+            f64 HashCost = BenchNoise3(&Generator->HashNoise, SampleCount, &SampleMin, &SampleMax);
+            printf("  hash:    %6.2fns/sample, range [%.3f, %.3f]\n", HashCost, SampleMin, SampleMax);
+            f64 SimplexCost = BenchNoise3(&Generator->Simplex3, SampleCount, &SampleMin, &SampleMax);
+            printf("  simplex: %6.2fns/sample, range [%.3f, %.3f], %.2fx vs perlin3\n", SimplexCost, SampleMin, SampleMax, PerlinCost / SimplexCost);
+        }
+
+        // NOTE(boti): Only the density fields use simplex noise, the terrain height stays the same
+        Generator->DensityNoiseType = Noise_Simplex;
+        f64 SimplexTime = BenchGenerate(Generator, &Generate, ChunkCountSqrt, Data, Hashes, &Arena);
+        printf("  Generate:  %8.2f columns/s (%.2fms/column), %.2fx vs perlin\n", 
+               ChunkCount / SimplexTime, 1000.0 * SimplexTime / ChunkCount, GenerateTime / SimplexTime);
+        Generator->DensityNoiseType = Noise_Perlin;
+
+        if (SliceBitmapPath)
+        {
+            bool IsWritten = WriteNoiseSlices(SliceBitmapPath, Generator, &Arena);
+            printf("  Slices (perlin3 | hash | simplex): %s %s\n", IsWritten ? "written to" : "failed to write", SliceBitmapPath);
+        }
+    }
+
+    // Compile-time specialized octave noise
+    {
+        printf("Specialized octave noise:\n");
+
+        constexpr u32 SampleCount = 1u << 22;
+        u32 OctaveMismatchCount = 0;
+        if (CPULevel >= CPULevel_AVX2)
+        {
+            OctaveMismatchCount += CompareOctaveNoise("perlin2, 8 octaves:", SampleCount,
+                [Generator](__m256 X, __m256 Y, __m256) TARGET_AVX2 { return SampleOctave8(&Generator->Perlin2, X, Y, 8, 0.5f, 2.0f); },
+                [Generator](__m256 X, __m256 Y, __m256) TARGET_AVX2 { return SampleOctave8<8>(&Generator->Perlin2, X, Y); });
+            OctaveMismatchCount += CompareOctaveNoise("perlin3, 3 octaves:", SampleCount,
+                [Generator](__m256 X, __m256 Y, __m256 Z) TARGET_AVX2 { return OctaveNoise8(&Generator->Perlin3, X, Y, Z, 3, 0.5f, 2.0f); },
+                [Generator](__m256 X, __m256 Y, __m256 Z) TARGET_AVX2 { return OctaveNoise8<3>(&Generator->Perlin3, X, Y, Z); });
+            OctaveMismatchCount += CompareOctaveNoise("simplex3, 3 octaves:", SampleCount,
+                [Generator](__m256 X, __m256 Y, __m256 Z) TARGET_AVX2 { return OctaveNoise8(&Generator->Simplex3, X, Y, Z, 3, 0.5f, 2.0f); },
+                [Generator](__m256 X, __m256 Y, __m256 Z) TARGET_AVX2 { return OctaveNoise8<3>(&Generator->Simplex3, X, Y, Z); });
+        }
+
+        // Scalar
+        for (u32 i = 0; i < 4096; i++)
+        {
+            vec3 P = { 0.173f * i - 300.0f, 0.61f * i, 0.37f * i };
+            f32 Runtime2 = SampleOctave(&Generator->Perlin2, vec2{ P.x, P.y }, 8, 0.5f, 2.0f);
+            f32 Specialized2 = SampleOctave<8>(&Generator->Perlin2, vec2{ P.x, P.y });
+            f32 Runtime3 = OctaveNoise(&Generator->Perlin3, P, 3, 0.5f, 2.0f);
+            f32 Specialized3 = OctaveNoise<3>(&Generator->Perlin3, P);
+            if (memcmp(&Runtime2, &Specialized2, sizeof(f32)) != 0) OctaveMismatchCount++;
+            if (memcmp(&Runtime3, &Specialized3, sizeof(f32)) != 0) OctaveMismatchCount++;
+        }
+
+        printf("  Runtime vs specialized mismatches: %u\n", OctaveMismatchCount);
+        MismatchCount += OctaveMismatchCount;
+    }
+
+    // SIMD kernel variants, including the whole chunk generation on each level
+    {
+        printf("SIMD kernels:\n");
+        MismatchCount += BenchKernels(CPULevel, Generator, &Arena);
+
+        for (u32 Level = CPULevel_Scalar; Level <= (u32)CPULevel; Level++)
+        {
+            Kernels = GetSIMDKernels((cpu_level)Level);
+            f64 LevelTime = BenchGenerate(Generator, &Generate, ChunkCountSqrt, Data, Hashes, &Arena);
+            u32 LevelMismatchCount = 0;
+            for (u32 i = 0; i < ChunkCount; i++)
+            {
+                LevelMismatchCount += (Hashes[i] != ReferenceHashes[i]) ? 1 : 0;
+            }
+            printf("  %-8s Generate: %8.2f columns/s (%.2fms/column), mismatching columns: %u/%u\n",
+                   CPULevelNames[Level], ChunkCount / LevelTime, 1000.0 * LevelTime / ChunkCount, LevelMismatchCount, ChunkCount);
+            MismatchCount += LevelMismatchCount;
+        }
+        Kernels = GetSIMDKernels(CPULevel);
+    }
+
+    // Counter-based RNG
+    {
+        printf("Counter-based random numbers:\n");
+        if (CPULevel >= CPULevel_AVX2)
+        {
+            MismatchCount += BenchCounterRandom(1u << 22);
+        }
+    }
+
+    // Noise graph
+    {
+        printf("Noise graph:\n");
+
+        noise_graph* DefaultGraph = PushStruct<noise_graph>(&Arena);
+        noise_graph* Graph = PushStruct<noise_graph>(&Arena);
+        CompileDefaultNoiseGraph(DefaultGraph);
+
+        // NOTE(boti): The shipped terrain description is the built-in one with biomes on top
+        FILE* File = fopen("worldgen/terrain.txt", "rb");
+        if (File)
+        {
+            static char Source[16 * 1024];
+            size_t Size = fread(Source, 1, sizeof(Source), File);
+            fclose(File);
+
+            u32 ErrorLine = 0;
+            bool IsValid = CompileNoiseGraph(Graph, buffer{ Size, (u8*)Source }, &ErrorLine);
+            bool IsSame = IsValid && AreNoiseGraphsEqual(Graph, DefaultGraph);
+            printf("  worldgen/terrain.txt: %s\n", !IsValid ? "invalid" : (IsSame ? "same as the default" : "differs from the default"));
+            if (!IsValid)
+            {
+                printf("    error on line %u\n", ErrorLine);
+                MismatchCount++;
+            }
+            else
+            {
+                // NOTE(boti): The default terrain with the ore rules swapped for the shipped veins, then the cave rule for the worms,
+                //             this isolates the cost of each from the rest of the shipped graph
+                noise_graph* VeinGraph = PushStruct<noise_graph>(&Arena);
+                *VeinGraph = *DefaultGraph;
+                VeinGraph->RuleCount = 0;
+                for (u32 RuleIndex = 0; RuleIndex < DefaultGraph->RuleCount; RuleIndex++)
+                {
+                    const noise_rule* Rule = DefaultGraph->Rules + RuleIndex;
+                    if ((Rule->ToType != VOXEL_COAL) && (Rule->ToType != VOXEL_IRON))
+                    {
+                        VeinGraph->Rules[VeinGraph->RuleCount++] = *Rule;
+                    }
+                }
+                RemoveUnusedNoiseFields(VeinGraph);
+                VeinGraph->OreCount = Graph->OreCount;
+                memcpy(VeinGraph->Ores, Graph->Ores, sizeof(Graph->Ores));
+
+                noise_graph* WormGraph = PushStruct<noise_graph>(&Arena);
+                *WormGraph = *VeinGraph;
+                WormGraph->RuleCount = 0;
+                for (u32 RuleIndex = 0; RuleIndex < VeinGraph->RuleCount; RuleIndex++)
+                {
+                    const noise_rule* Rule = VeinGraph->Rules + RuleIndex;
+                    if (Rule->ToType != VOXEL_AIR)
+                    {
+                        WormGraph->Rules[WormGraph->RuleCount++] = *Rule;
+                    }
+                }
+                RemoveUnusedNoiseFields(WormGraph);
+                WormGraph->Worms = Graph->Worms;
+
+                BenchFeatures("Generate (default)            ", Generator, DefaultGraph, ChunkCountSqrt, Data, &Arena);
+                BenchFeatures("Generate (default+veins)      ", Generator, VeinGraph, ChunkCountSqrt, Data, &Arena);
+                BenchFeatures("Generate (default+veins+worms)", Generator, WormGraph, ChunkCountSqrt, Data, &Arena);
+                BenchFeatures("Generate (shipped)            ", Generator, Graph, ChunkCountSqrt, Data, &Arena);
+                if (Graph->BiomeCount)
+                {
+                    MismatchCount += BenchBiomes(Generator, Graph, ChunkCountSqrt, &Arena);
+                }
+            }
+        }
+        else
+        {
+            printf("  worldgen/terrain.txt: not found\n");
+        }
+
+        // Errors have to be reported on the right line
+        const char InvalidSource[] = "height noise\n\nlayer stone\nrule stone coal ore > 0.5\n";
+        u32 ErrorLine = 0;
+        bool IsValid = CompileNoiseGraph(Graph, buffer{ sizeof(InvalidSource) - 1, (u8*)InvalidSource }, &ErrorLine);
+        printf("  Undefined field: %s on line %u\n", IsValid ? "accepted" : "rejected", ErrorLine);
+        if (IsValid || ErrorLine != 4)
+        {
+            MismatchCount++;
+        }
+    }
+
+    return (MismatchCount == 0) ? 0 : 1;
+}
@@ -21,19 +21,9 @@ static const char* Win32_WindowTitle = "Blokker";
 static const char* Win32_GameDLLPath = "build/game.dll";
 static const char* Win32_GameDLLTempPath = "build/game-temp.dll";
 
-struct platform_work_queue
-{
-    static constexpr u32 MaxWorkCount = 512;
-
-    HANDLE Semaphore;
+static void WinDebugPrint(const char* Format, ...);
 
-    // TODO(boti): u64 Completion
-    volatile u32 Completion;
-    volatile u32 CompletionGoal;
-    volatile u32 ReadIndex;
-    volatile u32 WriteIndex;
-    work_function WorkQueue[MaxWorkCount];
-};
+#include "Win32_Work.cpp"
 
 struct win32_state
 {
@@ -55,14 +45,10 @@ struct win32_state
     BOOL HasDebugger;
     bool IsCursorDisabled;
 
-    HANDLE WorkerSemaphore;
-    platform_work_queue HighPriorityQueue;
-    platform_work_queue LowPriorityQueue;
+    win32_work_system WorkSystem;
 };
 static win32_state Win32State;
 
-static void WinDebugPrint(const char* Format, ...);
-
 static DWORD __stdcall WinAudioThread(void* Param)
 {
     game_memory* GameMemory = (game_memory*)Param;
@@ -154,82 +140,6 @@ static DWORD __stdcall WinAudioThread(void* Param)
     //return(0);
 }
 
-static DWORD __stdcall WinWorkerThread(void* Param)
-{
-    HANDLE Semaphore = Win32State.WorkerSemaphore;
-    platform_work_queue* HighPriorityQueue = &Win32State.HighPriorityQueue;
-    platform_work_queue* LowPriorityQueue = &Win32State.LowPriorityQueue;
-
-    memory_arena Arena = {};
-    Arena.Size = MiB(32);
-    Arena.Base = (u8*)VirtualAlloc(nullptr, Arena.Size, MEM_COMMIT|MEM_RESERVE, PAGE_READWRITE);
-    if (!Arena.Base)
-    {
-        WinDebugPrint("Failed to allocate thread memory");
-        ExitProcess(1);
-    }
-
-    for (;;)
-    {
-        // NOTE(boti): The control flow is ugly here, we only want to move onto the low priority queue
-        //             when we know the high priority queue is empty, and we only want to sleep
-        //             when both queues are empty.
-        //             This means that we want to restart the loop each time there is/was work in whichever queue.
-        u32 ReadIndex = HighPriorityQueue->ReadIndex;
-        if (ReadIndex < HighPriorityQueue->WriteIndex)
-        {
-            function Work = HighPriorityQueue->WorkQueue[ReadIndex % HighPriorityQueue->MaxWorkCount];
-            if (AtomicCompareExchange(&HighPriorityQueue->ReadIndex, ReadIndex + 1, ReadIndex) == ReadIndex)
-            {
-                Work.Invoke(&Arena);
-                AtomicIncrement(&HighPriorityQueue->Completion);
-                ResetArena(&Arena);
-            }
-            continue;
-        }
-        ReadIndex = LowPriorityQueue->ReadIndex;
-        if (ReadIndex < LowPriorityQueue->WriteIndex)
-        {
-            function Work = LowPriorityQueue->WorkQueue[ReadIndex % LowPriorityQueue->MaxWorkCount];
-            if (AtomicCompareExchange(&LowPriorityQueue->ReadIndex, ReadIndex + 1, ReadIndex) == ReadIndex)
-            {
-                Work.Invoke(&Arena);
-                AtomicIncrement(&LowPriorityQueue->Completion);
-                ResetArena(&Arena);
-            }
-
-            continue;
-        }
-
-        WaitForSingleObject(Semaphore, INFINITE);
-    }
-    //return(0);
-}
-
-static void WinAddWork(platform_work_queue* Queue, work_function Work)
-{
-    u32 WriteIndex = Queue->WriteIndex;
-    while (WriteIndex - Queue->ReadIndex >= Queue->MaxWorkCount)
-    {
-        SpinWait;
-    }
-
-    Queue->WorkQueue[WriteIndex % Queue->MaxWorkCount] = Work;
-    u32 PrevIndex = AtomicCompareExchange(&Queue->WriteIndex, WriteIndex + 1, WriteIndex);
-    assert(PrevIndex == WriteIndex);
-
-    AtomicIncrement(&Queue->CompletionGoal);
-    ReleaseSemaphore(Win32State.WorkerSemaphore, 1, nullptr);
-}
-
-static void WinWaitForAllWork(platform_work_queue* Queue)
-{
-    while (Queue->Completion != Queue->CompletionGoal)
-    {
-        SpinWait;
-    }
-}
-
 static bool SetClipCursorToWindow(bool Clip)
 {
     if (Clip)
@@ -679,17 +589,17 @@ int CALLBACK WinMain(HINSTANCE Instance, HINSTANCE PrevInstance, LPSTR CommandLi
     }
 #endif
 
+    // NOTE(boti): Everything is built for the x64 baseline, so there's no level that can't run.
+    //             The game DLL picks its kernels for the same level on its own when it gets loaded
+    cpu_features CPUFeatures = DetectCPUFeatures();
+    cpu_level CPULevel = GetCPULevel(&CPUFeatures);
+    WinDebugPrint("SIMD kernels: %s\n", CPULevelNames[CPULevel]);
+
     static constexpr u32 WorkerCount = 5;
-    Win32State.WorkerSemaphore = CreateSemaphoreA(nullptr, 0, WorkerCount, nullptr);
-    if (!Win32State.WorkerSemaphore || Win32State.WorkerSemaphore == INVALID_HANDLE_VALUE)
+    if (!WinStartWorkers(&Win32State.WorkSystem, WorkerCount, MiB(32)))
     {
         return -1;
     }
-    for (u32 ThreadIndex = 0; ThreadIndex < WorkerCount; ThreadIndex++)
-    {
-        DWORD WorkerID;
-        HANDLE WorkerHandle = CreateThread(nullptr, 0, &WinWorkerThread, nullptr, 0, &WorkerID);
-    }
 
     WNDCLASSA WindowClass = 
     {
@@ -761,8 +671,8 @@ int CALLBACK WinMain(HINSTANCE Instance, HINSTANCE PrevInstance, LPSTR CommandLi
         Memory.Platform.GetElapsedTime = &WinGetElapsedTime;
         Memory.Platform.GetTimeFromCounter = &WinGetTimeFromCounter;
 
-        Memory.Platform.HighPriorityQueue = &Win32State.HighPriorityQueue;
-        Memory.Platform.LowPriorityQueue = &Win32State.LowPriorityQueue;
+        Memory.Platform.HighPriorityQueue = &Win32State.WorkSystem.HighPriorityQueue;
+        Memory.Platform.LowPriorityQueue = &Win32State.WorkSystem.LowPriorityQueue;
 
         Memory.ImGuiAlloc = &WinImGuiAlloc;
         Memory.ImGuiFree = &WinImGuiFree;
@@ -824,8 +734,8 @@ int CALLBACK WinMain(HINSTANCE Instance, HINSTANCE PrevInstance, LPSTR CommandLi
                 {
                     GameDLLWriteTime = Info.ftLastWriteTime;
 
-                    WinWaitForAllWork(&Win32State.HighPriorityQueue);
-                    WinWaitForAllWork(&Win32State.LowPriorityQueue);
+                    WinWaitForAllWork(&Win32State.WorkSystem.HighPriorityQueue);
+                    WinWaitForAllWork(&Win32State.WorkSystem.LowPriorityQueue);
 
                     FreeLibrary(Win32State.GameDLL);
                     Win32State.GameDLL = nullptr;
@@ -916,8 +826,8 @@ int CALLBACK WinMain(HINSTANCE Instance, HINSTANCE PrevInstance, LPSTR CommandLi
     }
 
     TerminateThread(AudioThread, 0);
-    WinWaitForAllWork(&Win32State.HighPriorityQueue);
-    WinWaitForAllWork(&Win32State.LowPriorityQueue);
+    WinWaitForAllWork(&Win32State.WorkSystem.HighPriorityQueue);
+    WinWaitForAllWork(&Win32State.WorkSystem.LowPriorityQueue);
     FreeLibrary(Win32State.GameDLL);
     DeleteFile(Win32_GameDLLTempPath);
     return 0;
@@ -0,0 +1,369 @@
+//
+// Headless world pregeneration
+//
+// Usage: pregen.exe Seed Radius [ThreadCount] [OutputPath]
+//
+// Generates the (2*Radius + 1)^2 chunk columns around the spawn chunk on the job system
+// and writes them to OutputPath (default: world.chunks) in the chunk file format (see ChunkFile.hpp).
+//
+
+#include <Common.hpp>
+#include <Intrinsics.hpp>
+#include <Math.hpp>
+#include <Memory.hpp>
+#include <Random.hpp>
+#include <Shapes.hpp>
+#include <Profiler.hpp>
+#include <Platform.hpp>
+
+// NOTE(boti): Only for the types chunk refers to, nothing here touches the renderer
+#include <Renderer/RenderAPI.hpp>
+
+#include <Chunk.hpp>
+#include <ChunkFile.hpp>
+#include <WorldGen.hpp>
+
+#include <Windows.h>
+#include <psapi.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdarg>
+
+static void WinDebugPrint(const char* Format, ...)
+{
+    va_list ArgList;
+    va_start(ArgList, Format);
+    vfprintf(stderr, Format, ArgList);
+    va_end(ArgList);
+}
+
+#include "Win32_Work.cpp"
+
+#include "Random.cpp"
+#include "Kernels.cpp"
+#include "ChunkData.cpp"
+#include "NoiseGraph.cpp"
+#include "WorldGen.cpp"
+
+//
+// NOTE(boti): Chunks are generated in rows of columns. Decorating a row needs the Level0 pass of the rows above and below it,
+//             so there's a ring of RingRowCount rows in memory: while row y is being decorated (and written),
+//             the Level0 pass of row y + 2 already runs in the slot row y - 2 used to be in.
+//             Each row has a 1 column border on both sides (and there's a border row above and below the area),
+//             and each column has a border chunk below and above the part that's written,
+//             so that the chunks on the edge get the structures of their neighbors too. The border isn't written.
+//
+struct pregen_state
+{
+    static constexpr u32 RingRowCount = 4;
+    static constexpr u32 ColumnChunkCount = CHUNK_FILE_COLUMN_CHUNK_COUNT + 2;
+
+    world_generator* Generator;
+    HANDLE OutputFile;
+    volatile u32 WriteErrorCount;
+
+    u32 ChunkCountSqrt;     // Columns per side written to the file
+    u32 RowColumnCount;     // ChunkCountSqrt + border
+    vec2i MinP;             // Position of the first column written to the file
+
+    chunk* Rows[RingRowCount]; // [RowColumnCount][ColumnChunkCount]
+};
+
+// RowIndex, ColumnIndex and ChunkIndex (in the column, from the bottom) include the border
+static chunk* GetRingChunk(pregen_state* State, u32 RowIndex, u32 ColumnIndex, u32 ChunkIndex)
+{
+    assert(ColumnIndex < State->RowColumnCount);
+    assert(ChunkIndex < State->ColumnChunkCount);
+    chunk* Result = State->Rows[RowIndex % State->RingRowCount] + ColumnIndex * State->ColumnChunkCount + ChunkIndex;
+    return(Result);
+}
+
+static void QueueLevel0(platform_work_queue* Queue, pregen_state* State, u32 RowIndex)
+{
+    for (u32 ColumnIndex = 0; ColumnIndex < State->RowColumnCount; ColumnIndex++)
+    {
+        vec2i ColumnP = State->MinP + vec2i{ (s32)ColumnIndex - 1, (s32)RowIndex - 1 } * CHUNK_DIM_XY;
+        for (u32 ChunkIndex = 0; ChunkIndex < State->ColumnChunkCount; ChunkIndex++)
+        {
+            chunk* Chunk = GetRingChunk(State, RowIndex, ColumnIndex, ChunkIndex);
+            Chunk->P = vec3i{ ColumnP.x, ColumnP.y, ((s32)ChunkIndex - 1) * CHUNK_DIM_Z };
+            Chunk->GenerationLevel = ChunkGen_Level0;
+            Chunk->StructurePlacementCount = 0;
+
+            const world_generator* Generator = State->Generator;
+            WinAddWork(Queue, [Chunk, Generator](memory_arena* Arena)
+            {
+                Generate(Chunk, Generator, Arena);
+                Chunk->GenerationLevel = ChunkGen_Level1;
+            });
+        }
+    }
+}
+
+static void QueueDecorationsAndWrite(platform_work_queue* Queue, pregen_state* State, u32 RowIndex)
+{
+    assert(RowIndex >= 1);
+    for (u32 ColumnIndex = 1; ColumnIndex + 1 < State->RowColumnCount; ColumnIndex++)
+    {
+        WinAddWork(Queue, [State, RowIndex, ColumnIndex](memory_arena* Arena)
+        {
+            for (u32 ChunkIndex = 1; ChunkIndex + 1 < State->ColumnChunkCount; ChunkIndex++)
+            {
+                const chunk* Neighborhood[3][3][3];
+                for (u32 z = 0; z < 3; z++)
+                {
+                    for (u32 y = 0; y < 3; y++)
+                    {
+                        for (u32 x = 0; x < 3; x++)
+                        {
+                            Neighborhood[z][y][x] = GetRingChunk(State, RowIndex + y - 1, ColumnIndex + x - 1, ChunkIndex + z - 1);
+                            assert(Neighborhood[z][y][x]->GenerationLevel >= ChunkGen_Level1);
+                        }
+                    }
+                }
+
+                chunk* Chunk = GetRingChunk(State, RowIndex, ColumnIndex, ChunkIndex);
+                GenerateDecorations(Chunk, Neighborhood, State->Generator);
+                Chunk->GenerationLevel = ChunkGen_LevelFinal;
+            }
+
+            chunk_file_record* Record = PushStruct<chunk_file_record>(Arena);
+            if (Record)
+            {
+                const chunk* BottomChunk = GetRingChunk(State, RowIndex, ColumnIndex, 1);
+                Record->P = (vec2i)BottomChunk->P;
+                Record->GenerationLevel = BottomChunk->GenerationLevel;
+                Record->Reserved = 0;
+                memcpy(Record->Heightmap, BottomChunk->Heightmap, sizeof(Record->Heightmap));
+                for (u32 ChunkIndex = 0; ChunkIndex < CHUNK_FILE_COLUMN_CHUNK_COUNT; ChunkIndex++)
+                {
+                    const chunk* Chunk = GetRingChunk(State, RowIndex, ColumnIndex, ChunkIndex + 1);
+                    for (u32 SectionIndex = 0; SectionIndex < CHUNK_SECTION_COUNT; SectionIndex++)
+                    {
+                        u32 z = ChunkIndex * CHUNK_DIM_Z + SectionIndex * CHUNK_SECTION_DIM;
+                        UnpackChunkSection(Chunk->Data, SectionIndex, &Record->Voxels[z][0][0]);
+                    }
+                }
+
+                // NOTE(boti): The records are fixed size, so the workers can write them directly to their place in the file
+                chunk_file_header Header = {};
+                Header.HeaderSize = sizeof(chunk_file_header);
+                Header.RecordSize = sizeof(chunk_file_record);
+                Header.ChunkCountX = State->ChunkCountSqrt;
+                Header.ChunkCountY = State->ChunkCountSqrt;
+                u64 Offset = GetChunkFileRecordOffset(&Header, ColumnIndex - 1, RowIndex - 1);
+
+                OVERLAPPED Overlapped = {};
+                Overlapped.Offset = (DWORD)(Offset & 0xFFFFFFFFu);
+                Overlapped.OffsetHigh = (DWORD)(Offset >> 32);
+                DWORD BytesWritten = 0;
+                if (!WriteFile(State->OutputFile, Record, sizeof(*Record), &BytesWritten, &Overlapped) || BytesWritten != sizeof(*Record))
+                {
+                    AtomicIncrement(&State->WriteErrorCount);
+                }
+            }
+            else
+            {
+                AtomicIncrement(&State->WriteErrorCount);
+            }
+        });
+    }
+}
+
+int main(int ArgCount, char** Args)
+{
+    if (ArgCount < 3)
+    {
+        fprintf(stderr, "Usage: %s Seed Radius [ThreadCount] [OutputPath]\n", Args[0]);
+        return 1;
+    }
+
+    SYSTEM_INFO SystemInfo = {};
+    GetSystemInfo(&SystemInfo);
+    // NOTE(boti): The main thread only waits on the workers, but it does spin while doing so
+    u32 DefaultThreadCount = Max((u32)SystemInfo.dwNumberOfProcessors, 2u) - 1;
+
+    u32 Seed = (u32)strtoul(Args[1], nullptr, 10);
+    s32 Radius = atoi(Args[2]);
+    s32 ThreadCount = (ArgCount > 3) ? atoi(Args[3]) : (s32)DefaultThreadCount;
+    const char* OutputPath = (ArgCount > 4) ? Args[4] : "world.chunks";
+    if (Radius < 0 || ThreadCount <= 0 || ThreadCount > (s32)win32_work_system::MaxWorkerCount)
+    {
+        fprintf(stderr, "Invalid arguments\n");
+        return 1;
+    }
+
+    // NOTE(boti): The kernels give the same bits on every level, so the output doesn't depend on the machine
+    cpu_features CPUFeatures = DetectCPUFeatures();
+    Kernels = GetSIMDKernels(GetCPULevel(&CPUFeatures));
+
+    LARGE_INTEGER Frequency;
+    QueryPerformanceFrequency(&Frequency);
+
+    pregen_state State = {};
+    State.ChunkCountSqrt = 2 * (u32)Radius + 1;
+    State.RowColumnCount = State.ChunkCountSqrt + 2;
+    State.MinP = vec2i{ -Radius, -Radius } * CHUNK_DIM_XY;
+
+    const u64 RingChunkCount = (u64)State.RingRowCount * State.RowColumnCount * State.ColumnChunkCount;
+    u64 SectionPoolSize = RingChunkCount * CHUNK_SECTION_COUNT * CHUNK_MAX_SECTION_INDICES_SIZE;
+    u64 MemorySize = MiB(1) + sizeof(world_generator) + sizeof(cave_region_cache) + sizeof(column_heightmap_cache) + SectionPoolSize +
+        RingChunkCount * (sizeof(chunk) + sizeof(chunk_data)) + State.RingRowCount * 2 * 64;
+    void* Memory = VirtualAlloc(nullptr, MemorySize, MEM_COMMIT|MEM_RESERVE, PAGE_READWRITE);
+    if (!Memory)
+    {
+        fprintf(stderr, "Failed to allocate memory\n");
+        return 1;
+    }
+    memory_arena Arena = InitializeArena(MemorySize, Memory);
+    chunk_section_pool SectionPool = {};
+    InitializeChunkSectionPool(&SectionPool, SectionPoolSize, PushSize(&Arena, SectionPoolSize));
+
+    // NOTE(boti): Same terrain description as the game
+    buffer GraphSource = {};
+    {
+        FILE* File = fopen("worldgen/terrain.txt", "rb");
+        if (File)
+        {
+            static char Source[64 * 1024];
+            GraphSource.Size = fread(Source, 1, sizeof(Source), File);
+            GraphSource.Data = (u8*)Source;
+            fclose(File);
+        }
+    }
+
+    State.Generator = PushStruct<world_generator>(&Arena);
+    if (!State.Generator)
+    {
+        fprintf(stderr, "Failed to allocate memory\n");
+        return 1;
+    }
+
+    u32 GraphErrorLine = 0;
+    if (!InitializeWorldGenerator(State.Generator, Seed, GraphSource, &Arena, &GraphErrorLine))
+    {
+        fprintf(stderr, "worldgen/terrain.txt(%u): invalid terrain description, using the default terrain\n", GraphErrorLine);
+    }
+
+    const u32 RowChunkCount = State.RowColumnCount * State.ColumnChunkCount;
+    for (u32 RowIndex = 0; RowIndex < State.RingRowCount; RowIndex++)
+    {
+        State.Rows[RowIndex] = PushArray<chunk>(&Arena, RowChunkCount);
+        chunk_data* Data = PushArray<chunk_data>(&Arena, RowChunkCount);
+        if (!State.Rows[RowIndex] || !Data)
+        {
+            fprintf(stderr, "Failed to allocate chunks\n");
+            return 1;
+        }
+        for (u32 ChunkIndex = 0; ChunkIndex < RowChunkCount; ChunkIndex++)
+        {
+            Data[ChunkIndex] = {};
+            Data[ChunkIndex].Pool = &SectionPool;
+            State.Rows[RowIndex][ChunkIndex].Data = Data + ChunkIndex;
+        }
+    }
+
+    State.OutputFile = CreateFileA(OutputPath, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (State.OutputFile == INVALID_HANDLE_VALUE)
+    {
+        fprintf(stderr, "Failed to open %s\n", OutputPath);
+        return 1;
+    }
+
+    static win32_work_system WorkSystem;
+    if (!WinStartWorkers(&WorkSystem, (u32)ThreadCount, MiB(32)))
+    {
+        fprintf(stderr, "Failed to start the worker threads\n");
+        return 1;
+    }
+    platform_work_queue* Queue = &WorkSystem.HighPriorityQueue;
+
+    u32 ChunkCount = State.ChunkCountSqrt * State.ChunkCountSqrt;
+    printf("Generating %u chunk columns (%ux%u around spawn, seed: %u) on %d threads, %s kernels\n",
+           ChunkCount, State.ChunkCountSqrt, State.ChunkCountSqrt, Seed, ThreadCount, CPULevelNames[Kernels->Level]);
+
+    LARGE_INTEGER StartCounter;
+    QueryPerformanceCounter(&StartCounter);
+
+    // NOTE(boti): Row indices include the border rows, so the rows written are [1, ChunkCountSqrt]
+    //             and the Level0 pass needs to run on [0, ChunkCountSqrt + 1]
+    u32 LastRowIndex = State.ChunkCountSqrt + 1;
+    QueueLevel0(Queue, &State, 0);
+    QueueLevel0(Queue, &State, 1);
+    QueueLevel0(Queue, &State, 2);
+    WinWaitForAllWork(Queue);
+
+    for (u32 RowIndex = 1; RowIndex <= State.ChunkCountSqrt; RowIndex++)
+    {
+        QueueDecorationsAndWrite(Queue, &State, RowIndex);
+        if (RowIndex + 2 <= LastRowIndex)
+        {
+            QueueLevel0(Queue, &State, RowIndex + 2);
+        }
+        WinWaitForAllWork(Queue);
+
+        if ((RowIndex % 16) == 0 || RowIndex == State.ChunkCountSqrt)
+        {
+            printf("\r  %u/%u rows", RowIndex, State.ChunkCountSqrt);
+            fflush(stdout);
+        }
+    }
+    printf("\n");
+
+    LARGE_INTEGER EndCounter;
+    QueryPerformanceCounter(&EndCounter);
+    s64 ElapsedCounter = EndCounter.QuadPart - StartCounter.QuadPart;
+    f64 ElapsedTime = (f64)ElapsedCounter / (f64)Frequency.QuadPart;
+
+    // The header goes in last, so a file that didn't finish writing can't be mistaken for a valid one
+    bool IsWritten = (State.WriteErrorCount == 0);
+    {
+        chunk_file_header Header = {};
+        Header.Magic = CHUNK_FILE_MAGIC;
+        Header.Version = CHUNK_FILE_VERSION;
+        Header.HeaderSize = sizeof(chunk_file_header);
+        Header.RecordSize = sizeof(chunk_file_record);
+        Header.Seed = Seed;
+        Header.MinP = State.MinP;
+        Header.ChunkCountX = State.ChunkCountSqrt;
+        Header.ChunkCountY = State.ChunkCountSqrt;
+
+        OVERLAPPED Overlapped = {};
+        DWORD BytesWritten = 0;
+        IsWritten = IsWritten && WriteFile(State.OutputFile, &Header, sizeof(Header), &BytesWritten, &Overlapped) && (BytesWritten == sizeof(Header));
+        CloseHandle(State.OutputFile);
+    }
+
+    // NOTE(boti): The border chunks aren't written, but they're generated (Level0) so they count towards the work done
+    u32 Level0Count = (State.ChunkCountSqrt + 2) * RowChunkCount;
+    printf("  %u chunk columns in %.2fs: %.2f columns/s (%u Level0 passes including the border)\n",
+           ChunkCount, ElapsedTime, ChunkCount / ElapsedTime, Level0Count);
+
+    u64 PeakWorkerArenaUsed = 0;
+    for (u32 WorkerIndex = 0; WorkerIndex < WorkSystem.WorkerCount; WorkerIndex++)
+    {
+        win32_worker* Worker = WorkSystem.Workers + WorkerIndex;
+        printf("  Thread %2u: %5.1f%% busy, %6u jobs\n", WorkerIndex,
+               100.0 * (f64)Worker->BusyCounter / (f64)ElapsedCounter, Worker->CompletedWorkCount);
+        PeakWorkerArenaUsed = Max(PeakWorkerArenaUsed, (u64)Worker->PeakArenaUsed);
+    }
+
+    PROCESS_MEMORY_COUNTERS MemoryCounters = {};
+    MemoryCounters.cb = sizeof(MemoryCounters);
+    GetProcessMemoryInfo(GetCurrentProcess(), &MemoryCounters, sizeof(MemoryCounters));
+    printf("  Peak memory: %.2fMiB working set, %.2fMiB arena + %.2fKiB peak scratch per thread\n",
+           MemoryCounters.PeakWorkingSetSize / (f64)MiB(1), Arena.Used / (f64)MiB(1), PeakWorkerArenaUsed / (f64)KiB(1));
+
+    u64 FileSize = sizeof(chunk_file_header) + (u64)ChunkCount * sizeof(chunk_file_record);
+    if (IsWritten)
+    {
+        printf("  Written to %s (%.2fMiB)\n", OutputPath, FileSize / (f64)MiB(1));
+    }
+    else
+    {
+        fprintf(stderr, "Failed to write %s (%u chunks)\n", OutputPath, State.WriteErrorCount);
+    }
+
+    return IsWritten ? 0 : 1;
+}
@@ -0,0 +1,172 @@
+//
+// Win32 job system
+//
+// NOTE(boti): Shared between the game executable and the headless tools,
+//             so this must not depend on anything window or renderer related.
+//
+
+struct platform_work_queue
+{
+    static constexpr u32 MaxWorkCount = 512;
+
+    HANDLE Semaphore;
+
+    // TODO(boti): u64 Completion
+    volatile u32 Completion;
+    volatile u32 CompletionGoal;
+    volatile u32 ReadIndex;
+    volatile u32 WriteIndex;
+    work_function WorkQueue[MaxWorkCount];
+};
+
+struct win32_work_system;
+
+struct win32_worker
+{
+    win32_work_system* WorkSystem;
+    HANDLE Thread;
+
+    // NOTE(boti): Stats, only written by the worker itself
+    volatile s64 BusyCounter; // Ticks spent executing work
+    volatile u32 CompletedWorkCount;
+    volatile u64 PeakArenaUsed;
+};
+
+struct win32_work_system
+{
+    static constexpr u32 MaxWorkerCount = 64;
+
+    HANDLE Semaphore;
+    platform_work_queue HighPriorityQueue;
+    platform_work_queue LowPriorityQueue;
+
+    u64 WorkerArenaSize;
+    u32 WorkerCount;
+    win32_worker Workers[MaxWorkerCount];
+};
+
+static void WinWorkerExecute(win32_worker* Worker, work_function* Work, memory_arena* Arena)
+{
+    LARGE_INTEGER StartCounter, EndCounter;
+    QueryPerformanceCounter(&StartCounter);
+    Work->Invoke(Arena);
+    QueryPerformanceCounter(&EndCounter);
+
+    Worker->BusyCounter = Worker->BusyCounter + (EndCounter.QuadPart - StartCounter.QuadPart);
+    Worker->CompletedWorkCount = Worker->CompletedWorkCount + 1;
+    if (Arena->Used > Worker->PeakArenaUsed)
+    {
+        Worker->PeakArenaUsed = Arena->Used;
+    }
+}
+
+static DWORD __stdcall WinWorkerThread(void* Param)
+{
+    win32_worker* Worker = (win32_worker*)Param;
+    win32_work_system* WorkSystem = Worker->WorkSystem;
+
+    HANDLE Semaphore = WorkSystem->Semaphore;
+    platform_work_queue* HighPriorityQueue = &WorkSystem->HighPriorityQueue;
+    platform_work_queue* LowPriorityQueue = &WorkSystem->LowPriorityQueue;
+
+    memory_arena Arena = {};
+    Arena.Size = WorkSystem->WorkerArenaSize;
+    Arena.Base = (u8*)VirtualAlloc(nullptr, Arena.Size, MEM_COMMIT|MEM_RESERVE, PAGE_READWRITE);
+    if (!Arena.Base)
+    {
+        WinDebugPrint("Failed to allocate thread memory");
+        ExitProcess(1);
+    }
+
+    for (;;)
+    {
+        // NOTE(boti): The control flow is ugly here, we only want to move onto the low priority queue
+        //             when we know the high priority queue is empty, and we only want to sleep
+        //             when both queues are empty.
+        //             This means that we want to restart the loop each time there is/was work in whichever queue.
+        u32 ReadIndex = HighPriorityQueue->ReadIndex;
+        if (ReadIndex < HighPriorityQueue->WriteIndex)
+        {
+            function Work = HighPriorityQueue->WorkQueue[ReadIndex % HighPriorityQueue->MaxWorkCount];
+            if (AtomicCompareExchange(&HighPriorityQueue->ReadIndex, ReadIndex + 1, ReadIndex) == ReadIndex)
+            {
+                WinWorkerExecute(Worker, &Work, &Arena);
+                AtomicIncrement(&HighPriorityQueue->Completion);
+                ResetArena(&Arena);
+            }
+            continue;
+        }
+        ReadIndex = LowPriorityQueue->ReadIndex;
+        if (ReadIndex < LowPriorityQueue->WriteIndex)
+        {
+            function Work = LowPriorityQueue->WorkQueue[ReadIndex % LowPriorityQueue->MaxWorkCount];
+            if (AtomicCompareExchange(&LowPriorityQueue->ReadIndex, ReadIndex + 1, ReadIndex) == ReadIndex)
+            {
+                WinWorkerExecute(Worker, &Work, &Arena);
+                AtomicIncrement(&LowPriorityQueue->Completion);
+                ResetArena(&Arena);
+            }
+
+            continue;
+        }
+
+        WaitForSingleObject(Semaphore, INFINITE);
+    }
+    //return(0);
+}
+
+static void WinAddWork(platform_work_queue* Queue, work_function Work)
+{
+    u32 WriteIndex = Queue->WriteIndex;
+    while (WriteIndex - Queue->ReadIndex >= Queue->MaxWorkCount)
+    {
+        SpinWait;
+    }
+
+    Queue->WorkQueue[WriteIndex % Queue->MaxWorkCount] = Work;
+    u32 PrevIndex = AtomicCompareExchange(&Queue->WriteIndex, WriteIndex + 1, WriteIndex);
+    assert(PrevIndex == WriteIndex);
+
+    AtomicIncrement(&Queue->CompletionGoal);
+    ReleaseSemaphore(Queue->Semaphore, 1, nullptr);
+}
+
+static void WinWaitForAllWork(platform_work_queue* Queue)
+{
+    while (Queue->Completion != Queue->CompletionGoal)
+    {
+        SpinWait;
+    }
+}
+
+// NOTE(boti): WorkSystem must stay alive (and at the same address) for as long as the program runs,
+//             the workers are never shut down.
+static bool WinStartWorkers(win32_work_system* WorkSystem, u32 WorkerCount, u64 WorkerArenaSize)
+{
+    assert(WorkerCount > 0 && WorkerCount <= WorkSystem->MaxWorkerCount);
+
+    WorkSystem->Semaphore = CreateSemaphoreA(nullptr, 0, WorkerCount, nullptr);
+    if (!WorkSystem->Semaphore || WorkSystem->Semaphore == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    WorkSystem->HighPriorityQueue.Semaphore = WorkSystem->Semaphore;
+    WorkSystem->LowPriorityQueue.Semaphore = WorkSystem->Semaphore;
+    WorkSystem->WorkerArenaSize = WorkerArenaSize;
+
+    for (u32 ThreadIndex = 0; ThreadIndex < WorkerCount; ThreadIndex++)
+    {
+        win32_worker* Worker = WorkSystem->Workers + ThreadIndex;
+        Worker->WorkSystem = WorkSystem;
+
+        DWORD WorkerID;
+        Worker->Thread = CreateThread(nullptr, 0, &WinWorkerThread, Worker, 0, &WorkerID);
+        if (!Worker->Thread)
+        {
+            break;
+        }
+        WorkSystem->WorkerCount++;
+    }
+
+    return(WorkSystem->WorkerCount == WorkerCount);
+}
@@ -3,18 +3,31 @@
 //
 // Internal functions
 //
-static void InitializeWorldGenerator(world_generator* Generator, u32 Seed, memory_arena* Arena);
-
-static u32 HashChunkP(const world* World, vec2i P, vec2i* Coords = nullptr);
 static void LoadChunksAroundPlayer(world* World, memory_arena* TransientArena);
-static chunk* ReserveChunk(world* World, vec2i P);
+static chunk* ReserveChunk(world* World, vec3i P);
 static chunk* FindPlayerChunk(world* World);
 static void FreeChunkMesh(world* World, chunk* Chunk);
+static void EvictChunk(world* World, chunk* Chunk);
+static bool IsChunkReadByWork(const chunk* Chunk);
+static void EvictDistantChunks(world* World, vec3i PlayerChunkP);
+static void CompressColdChunks(world* World, vec3i PlayerChunkP);
+static void DecompressChunk(world* World, chunk* Chunk);
+
+static bool CanGenerateChunk(world* World, chunk* Chunk);
+static void QueueChunkGeneration(world* World, chunk* Chunk);
+static chunk* QueuePlayerChunkGeneration(world* World);
 
-static void FlushChunkWorks(world* World, render_frame* Frame, bool WaitForPlayerChunk, chunk* PlayerChunk);
+static void FlushChunkWorks(world* World, render_frame* Frame, bool WaitForPlayerChunk);
 static chunk_work* GetNextChunkWorkToWrite(chunk_work_queue* Queue);
 
 static bool PlantStructure(world* World, world_structure* Structure, vec3i P);
+// Same as the world's Get/SetVoxelTypeAt, for accessing a lot of nearby voxels
+static u16 GetVoxelTypeAt(world* World, voxel_accessor* Accessor, vec3i P);
+static bool SetVoxelTypeAt(world* World, voxel_accessor* Accessor, vec3i P, u16 Type);
+
+template<typename func>
+static void ForEachSolidVoxel(world* World, vec3i MinP, vec3i MaxP, func&& Func);
+static bool FindColumnTopZ(world* World, vec2i P, s32* OutZ);
 
 //
 // Implementations
@@ -40,6 +53,7 @@ static bool PlantStructure(world* World, world_structure* Structure, vec3i P)
         };
 
         Result = true;
+        voxel_accessor Accessor = MakeVoxelAccessor(&World->ChunkTable);
         for (s32 z = 0; z < Structure->Extent.z; z++)
         {
             for (s32 y = 0; y < Structure->Extent.y; y++)
@@ -50,7 +64,7 @@ static bool PlantStructure(world* World, world_structure* Structure, vec3i P)
                     u16 VoxelType = Structure->Voxels[Index];
                     if (VoxelType != VOXEL_INVALID)
                     {
-                        Result &= SetVoxelTypeAt(World, MinP + vec3i{ x, y, z }, VoxelType);
+                        Result &= SetVoxelTypeAt(World, &Accessor, MinP + vec3i{ x, y, z }, VoxelType);
                     }
                 }
             }
@@ -86,7 +100,130 @@ static void FreeChunkMesh(world* World, chunk* Chunk)
         u32 DeletionIndex = World->ChunkDeletionWriteIndex++;
         World->ChunkDeletionQueue[DeletionIndex % World->MaxChunkDeletionQueueCount] = Chunk->VertexBlock;
         Chunk->VertexBlock = nullptr;
-        Chunk->IsMeshDirty = false;
+    }
+    Chunk->IsMeshed = false;
+    Chunk->IsMeshDirty = false;
+}
+
+// NOTE(boti): The decorations and the mesher read the neighbors of their chunk (through Chunk->Neighbors) when they run,
+//             so a chunk is in use for as long as it or any of its neighbors has work in flight
+static bool IsChunkReadByWork(const chunk* Chunk)
+{
+    bool Result = false;
+    for (s32 z = 0; z < 3; z++)
+    {
+        for (s32 y = 0; y < 3; y++)
+        {
+            for (s32 x = 0; x < 3; x++)
+            {
+                const chunk* Neighbor = Chunk->Neighbors[z][y][x];
+                if (Neighbor && (Neighbor->InGenerationQueue || Neighbor->InMeshQueue))
+                {
+                    Result = true;
+                }
+            }
+        }
+    }
+    return(Result);
+}
+
+// Frees the mesh, returns the data to the pool and removes the chunk from the table, the chunk is free afterwards
+static void EvictChunk(world* World, chunk* Chunk)
+{
+    assert(Chunk->Data);
+    assert(!IsChunkReadByWork(Chunk));
+
+    if (IsCompressedChunkData(Chunk->Data))
+    {
+        World->ColdChunks.ChunkCount--;
+        World->ColdChunks.DenseSize -= GetDenseChunkDataSize(Chunk->Data);
+        World->ColdChunks.CompressedSize -= GetChunkDataSize(Chunk->Data);
+    }
+
+    FreeChunkMesh(World, Chunk);
+    EraseChunk(&World->ChunkTable, Chunk);
+    FreeChunkData(&World->ChunkDataPool, Chunk->Data);
+    Chunk->Data = nullptr;
+    Chunk->GenerationLevel = ChunkGen_Level0;
+    Chunk->StructurePlacementCount = 0;
+    World->FreeChunks[World->FreeChunkCount++] = Chunk;
+}
+
+static void EvictDistantChunks(world* World, vec3i PlayerChunkP)
+{
+    TIMED_FUNCTION();
+
+    chunk_data_pool* Pool = &World->ChunkDataPool;
+    for (u32 i = 0; i < Pool->Capacity; i++)
+    {
+        chunk* Chunk = Pool->Owners[i];
+        if (Chunk)
+        {
+            s32 DistanceXY = ChebyshevDistance((vec2i)Chunk->P, (vec2i)PlayerChunkP) / CHUNK_DIM_XY;
+            s32 DistanceZ = Abs(Chunk->P.z - PlayerChunkP.z) / CHUNK_DIM_Z;
+            // NOTE(boti): Chunks that the works in flight might still read are skipped, they get evicted on a later pass
+            if ((DistanceXY > world::EvictionDistanceXY || DistanceZ > world::EvictionDistanceZ) && !IsChunkReadByWork(Chunk))
+            {
+                EvictChunk(World, Chunk);
+            }
+        }
+    }
+    World->LastEvictionP = PlayerChunkP;
+}
+
+static void CompressColdChunks(world* World, vec3i PlayerChunkP)
+{
+    TIMED_FUNCTION();
+
+    chunk_data_pool* Pool = &World->ChunkDataPool;
+    u32 CompressionCount = 0;
+    for (u32 VisitCount = 0; 
+         (VisitCount < world::ColdChunkVisitsPerFrame) && (CompressionCount < world::ColdChunkCompressionsPerFrame);
+         VisitCount++)
+    {
+        u32 Index = World->ColdChunks.Cursor;
+        World->ColdChunks.Cursor = (Index + 1) % Pool->Capacity;
+
+        chunk* Chunk = Pool->Owners[Index];
+        // NOTE(boti): Only the final chunks with nothing in flight and nothing left to mesh,
+        //             everything else is either going to be written or read by a job soon
+        if (!Chunk || (Chunk->GenerationLevel != ChunkGen_LevelFinal) ||
+            Chunk->InGenerationQueue || Chunk->InMeshQueue || Chunk->IsMeshDirty)
+        {
+            continue;
+        }
+
+        s32 DistanceXY = ChebyshevDistance((vec2i)Chunk->P, (vec2i)PlayerChunkP) / CHUNK_DIM_XY;
+        s32 DistanceZ = Abs(Chunk->P.z - PlayerChunkP.z) / CHUNK_DIM_Z;
+        if ((DistanceXY > world::MeshDistanceXY || DistanceZ > world::MeshDistanceZ) && !IsCompressedChunkData(Chunk->Data))
+        {
+            u64 DenseSize = GetDenseChunkDataSize(Chunk->Data);
+            if (CompressChunkData(Chunk->Data))
+            {
+                World->ColdChunks.ChunkCount++;
+                World->ColdChunks.DenseSize += DenseSize;
+                World->ColdChunks.CompressedSize += GetChunkDataSize(Chunk->Data);
+                CompressionCount++;
+            }
+        }
+    }
+}
+
+static void DecompressChunk(world* World, chunk* Chunk)
+{
+    if (Chunk->Data && IsCompressedChunkData(Chunk->Data))
+    {
+        counter BeginCounter = Platform.GetPerformanceCounter();
+
+        World->ColdChunks.ChunkCount--;
+        World->ColdChunks.DenseSize -= GetDenseChunkDataSize(Chunk->Data);
+        World->ColdChunks.CompressedSize -= GetChunkDataSize(Chunk->Data);
+        DecompressChunkData(Chunk->Data);
+
+        f32 Time = Platform.GetElapsedTime(BeginCounter, Platform.GetPerformanceCounter());
+        World->ColdChunks.DecompressCount++;
+        World->ColdChunks.TotalDecompressTime += Time;
+        World->ColdChunks.MaxDecompressTime = Max(Time, World->ColdChunks.MaxDecompressTime);
     }
 }
 
@@ -94,6 +231,7 @@ static void FreeChunkMesh(world* World, chunk* Chunk)
 void map_view::ResetAll(world* World)
 {
     CurrentP = { World->Player.P.x, World->Player.P.y };
+    CurrentZ = World->Player.P.z;
     CurrentPitch = ToRadians(-60.0f);
     ZoomCurrent = 10.0f;
     CurrentYaw = ToRadians(45.0f);
@@ -105,6 +243,7 @@ void map_view::Reset(world* World)
 {
     ZoomTarget = 1.0f;
     TargetP = { World->Player.P.x, World->Player.P.y };
+    TargetZ = World->Player.P.z;
     TargetPitch = ToRadians(-60.0f);
     TargetYaw = ToRadians(45.0f);
 }
@@ -128,24 +267,32 @@ void ResetPlayer(world* World)
     Player->P.x = PlayerP.x + 0.5f;
     Player->P.y = PlayerP.y + 0.5f;
     
-    vec3i RelP;
-    chunk* Chunk = GetChunkFromP(World, PlayerP, &RelP);
-    if (Chunk && Chunk->GenerationLevel == ChunkGen_LevelFinal)
+    // NOTE(boti): Looks for the highest solid voxel of the column in the loaded chunks, from the top of the window down
+    bool IsFound = false;
+    vec3i PlayerChunkP = GetChunkP(PlayerP);
+    vec3i RelP = PlayerP - PlayerChunkP;
+    for (s32 ChunkZ = world::GenerationDistanceZ; (ChunkZ >= -world::GenerationDistanceZ) && !IsFound; ChunkZ--)
     {
-        for (s32 z = CHUNK_DIM_Z - 1; z >= 0; z--)
+        chunk* Chunk = GetChunkFromP(World, PlayerChunkP + vec3i{ 0, 0, ChunkZ * CHUNK_DIM_Z });
+        if (Chunk && Chunk->GenerationLevel == ChunkGen_LevelFinal)
         {
-            u16 VoxelType = Chunk->Data->Voxels[z][RelP.y][RelP.x];
-            const voxel_desc* Desc = &VoxelDescs[VoxelType];
-            if (Desc->Flags & VOXEL_FLAGS_SOLID)
+            for (s32 z = Chunk->HighestNonAirZ[RelP.y][RelP.x]; z >= 0; z--)
             {
-                Player->P.z = z + Player->EyeHeight;
-                break;
+                if (Chunk->SolidMask[z][RelP.y] & (1u << RelP.x))
+                {
+                    Player->P.z = Chunk->P.z + z + Player->EyeHeight;
+                    IsFound = true;
+                    break;
+                }
             }
         }
     }
-    else
+
+    if (!IsFound)
     {
-        assert(!"Invalid player chunk");
+        // NOTE(boti): The chunk isn't ready yet, fall back to the generated terrain height (this ignores caves)
+        s32 Height = GetTerrainHeight(&World->Generator, vec2i{ PlayerP.x, PlayerP.y });
+        Player->P.z = Height + Player->EyeHeight;
     }
 }
 
@@ -153,39 +300,9 @@ void ResetPlayer(world* World)
 // World
 //
 
-static u32 HashChunkP(const world* World, vec2i P, vec2i* Coords /*= nullptr*/)
-{
-    P.x = FloorDiv(P.x, CHUNK_DIM_XY);
-    P.y = FloorDiv(P.y, CHUNK_DIM_XY);
-    P.x += World->MaxChunkCountSqrt / 2;
-    P.y += World->MaxChunkCountSqrt / 2;
-    s32 ix = Modulo(P.x, World->MaxChunkCountSqrt);
-    s32 iy = Modulo(P.y, World->MaxChunkCountSqrt);
-
-    u32 x = (u32)ix;
-    u32 y = (u32)iy;
-
-    u32 Result = x + y * World->MaxChunkCountSqrt;
-    if (Coords)
-    {
-        Coords->x = ix;
-        Coords->y = iy;
-    }
-
-    return Result;
-}
-
-chunk* GetChunkFromP(world* World, vec2i P)
+chunk* GetChunkFromP(world* World, vec3i P)
 {
-    chunk* Result = nullptr;
-
-    u32 Index = HashChunkP(World, P);
-    chunk* Chunk = World->Chunks + Index;
-    if (Chunk->P == P)
-    {
-        Result = Chunk;
-    }
-
+    chunk* Result = FindChunk(&World->ChunkTable, P);
     return Result;
 }
 
@@ -193,14 +310,14 @@ chunk* GetChunkFromP(world* World, vec3i P, vec3i* RelP)
 {
     chunk* Result = nullptr;
 
-    vec2i ChunkP = { FloorDiv(P.x, CHUNK_DIM_XY) * CHUNK_DIM_XY, FloorDiv(P.y, CHUNK_DIM_XY) * CHUNK_DIM_XY };
+    vec3i ChunkP = GetChunkP(P);
     chunk* Chunk = GetChunkFromP(World, ChunkP);
     if (Chunk)
     {
         Result = Chunk;
         if (RelP)
         {
-            *RelP = P - vec3i{ ChunkP.x, ChunkP.y, 0 };
+            *RelP = P - ChunkP;
         }
     }
 
@@ -209,76 +326,64 @@ chunk* GetChunkFromP(world* World, vec3i P, vec3i* RelP)
 
 u16 GetVoxelTypeAt(world* World, vec3i P)
 {
-    u16 Result = VOXEL_AIR;
+    voxel_accessor Accessor = MakeVoxelAccessor(&World->ChunkTable);
+    u16 Result = GetVoxelTypeAt(World, &Accessor, P);
+    return Result;
+}
 
-    if (0 <= P.z && P.z < CHUNK_DIM_Z)
-    {
-        vec3i RelP = {};
-        chunk* Chunk = GetChunkFromP(World, P, &RelP);
+bool SetVoxelTypeAt(world* World, vec3i P, u16 Type)
+{
+    voxel_accessor Accessor = MakeVoxelAccessor(&World->ChunkTable);
+    bool Result = SetVoxelTypeAt(World, &Accessor, P, Type);
+    return Result;
+}
 
-        if (Chunk && Chunk->GenerationLevel == ChunkGen_LevelFinal)
-        {
-            assert(Chunk->Data);
-            Result = Chunk->Data->Voxels[RelP.z][RelP.y][RelP.x];
-        }
-        else
-        {
-            //DebugPrint("WARNING: Invalid voxel read\n");
-        }
+static u16 GetVoxelTypeAt(world* World, voxel_accessor* Accessor, vec3i P)
+{
+    vec3i RelP = {};
+    chunk* Chunk = GetChunk(Accessor, P, &RelP);
+    if (Chunk && Chunk->GenerationLevel == ChunkGen_LevelFinal)
+    {
+        DecompressChunk(World, Chunk);
     }
+    u16 Result = GetVoxelType(Accessor, P);
     return Result;
 }
 
-bool SetVoxelTypeAt(world* World, vec3i P, u16 Type)
+static bool SetVoxelTypeAt(world* World, voxel_accessor* Accessor, vec3i P, u16 Type)
 {
     bool Result = false;
 
     vec3i RelP = {};
-    chunk* Chunk = GetChunkFromP(World, P, &RelP);
+    chunk* Chunk = GetChunk(Accessor, P, &RelP);
 
     if (Chunk && Chunk->GenerationLevel == ChunkGen_LevelFinal)
     {
         assert(Chunk->Data);
-        if ((0 <= RelP.z) && (RelP.z < CHUNK_DIM_Z))
+        DecompressChunk(World, Chunk);
+        SetVoxel(Chunk->Data, RelP.x, RelP.y, RelP.z, Type);
+        UpdateColumnBounds(Chunk, RelP.x, RelP.y, RelP.z, Type);
+        UpdateVoxelMasks(Chunk, RelP.x, RelP.y, RelP.z, Type);
+        Chunk->IsMeshDirty = true;
+
+        // NOTE(boti): The voxels on the faces of the chunk are part of the neighbors' meshes too
+        for (u32 Direction = DIRECTION_First; Direction < DIRECTION_Count; Direction++)
         {
-            Chunk->Data->Voxels[RelP.z][RelP.y][RelP.x] = Type;
-            Chunk->IsMeshDirty = true;
-
-            if (RelP.x == 0)
-            {
-                chunk* Neighbor = GetChunkFromP(World, Chunk->P + CardinalDirections[West] * CHUNK_DIM_XY);
-                if (Neighbor && Neighbor->VertexBlock)
-                {
-                    Neighbor->IsMeshDirty = true;
-                }
-            }
-            else if (RelP.x == CHUNK_DIM_XY - 1)
+            vec3i NeighborRelP = RelP + GlobalDirections[Direction];
+            if ((NeighborRelP.x < 0) || (NeighborRelP.x >= CHUNK_DIM_XY) ||
+                (NeighborRelP.y < 0) || (NeighborRelP.y >= CHUNK_DIM_XY) ||
+                (NeighborRelP.z < 0) || (NeighborRelP.z >= CHUNK_DIM_Z))
             {
-                chunk* Neighbor = GetChunkFromP(World, Chunk->P + CardinalDirections[East] * CHUNK_DIM_XY);
-                if (Neighbor && Neighbor->VertexBlock)
+                vec3i d = GlobalDirections[Direction];
+                chunk* Neighbor = Chunk->Neighbors[d.z + 1][d.y + 1][d.x + 1];
+                if (Neighbor && Neighbor->IsMeshed)
                 {
                     Neighbor->IsMeshDirty = true;
                 }
             }
-            if (RelP.y == 0)
-            {
-                chunk* Neighbor = GetChunkFromP(World, Chunk->P + CardinalDirections[South] * CHUNK_DIM_XY);
-                if (Neighbor && Neighbor->VertexBlock)
-                {
-                    Neighbor->IsMeshDirty = true;
-                }
-            }
-            else if (RelP.y == CHUNK_DIM_XY - 1)
-            {
-                chunk* Neighbor = GetChunkFromP(World, Chunk->P + CardinalDirections[North] * CHUNK_DIM_XY);
-                if (Neighbor && Neighbor->VertexBlock)
-                {
-                    Neighbor->IsMeshDirty = true;
-                }
-            }
-
-            Result = true;
         }
+
+        Result = true;
     }
 
     return Result;
@@ -288,13 +393,14 @@ voxel_neighborhood GetVoxelNeighborhood(world* World, vec3i P)
 {
     voxel_neighborhood Result = {};
 
+    voxel_accessor Accessor = MakeVoxelAccessor(&World->ChunkTable);
     for (s32 z = -1; z <= 1; z++)
     {
         for (s32 y = -1; y <= 1; y++)
         {
             for (s32 x = -1; x <= 1; x++)
             {
-                Result.GetVoxel(vec3i{ x, y, z }) = GetVoxelTypeAt(World, P + vec3i{ x, y, z });
+                Result.GetVoxel(vec3i{ x, y, z }) = GetVoxelTypeAt(World, &Accessor, P + vec3i{ x, y, z });
             }
         }
     }
@@ -302,19 +408,106 @@ voxel_neighborhood GetVoxelNeighborhood(world* World, vec3i P)
     return Result;
 }
 
-static chunk* ReserveChunk(world* World, vec2i P)
+// NOTE(boti): Goes over the solid voxels between MinP and MaxP (inclusive) a row at a time through the chunks' solid masks,
+//             the voxels of the chunks that aren't loaded or final yet are air (same as GetVoxelTypeAt)
+template<typename func>
+static void ForEachSolidVoxel(world* World, vec3i MinP, vec3i MaxP, func&& Func)
 {
+    static_assert(CHUNK_DIM_XY == 16);
+
+    vec3i MinChunkP = GetChunkP(MinP);
+    vec3i MaxChunkP = GetChunkP(MaxP);
+    voxel_accessor Accessor = MakeVoxelAccessor(&World->ChunkTable);
+    for (s32 ChunkZ = MinChunkP.z; ChunkZ <= MaxChunkP.z; ChunkZ += CHUNK_DIM_Z)
+    {
+        for (s32 ChunkY = MinChunkP.y; ChunkY <= MaxChunkP.y; ChunkY += CHUNK_DIM_XY)
+        {
+            for (s32 ChunkX = MinChunkP.x; ChunkX <= MaxChunkP.x; ChunkX += CHUNK_DIM_XY)
+            {
+                vec3i ChunkP = { ChunkX, ChunkY, ChunkZ };
+                vec3i RelP;
+                chunk* Chunk = GetChunk(&Accessor, ChunkP, &RelP);
+                if (!Chunk || (Chunk->GenerationLevel != ChunkGen_LevelFinal))
+                {
+                    continue;
+                }
+
+                // Relative to the chunk
+                vec3i BeginP = 
+                {
+                    Max(MinP.x - ChunkX, 0),
+                    Max(MinP.y - ChunkY, 0),
+                    Max(MinP.z - ChunkZ, 0),
+                };
+                vec3i EndP = 
+                {
+                    Min(MaxP.x - ChunkX, CHUNK_DIM_XY - 1),
+                    Min(MaxP.y - ChunkY, CHUNK_DIM_XY - 1),
+                    Min(MaxP.z - ChunkZ, CHUNK_DIM_Z - 1),
+                };
+
+                u32 RowMask = ((2u << EndP.x) - 1) & ~((1u << BeginP.x) - 1);
+                for (s32 z = BeginP.z; z <= EndP.z; z++)
+                {
+                    for (s32 y = BeginP.y; y <= EndP.y; y++)
+                    {
+                        u32 Row = Chunk->SolidMask[z][y] & RowMask;
+                        u32 x = 0;
+                        while (BitScanForward(&x, Row))
+                        {
+                            Func(ChunkP + vec3i{ (s32)x, y, z });
+                            Row &= Row - 1;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// World z of the highest non-air voxel of the column at P, looking at the final chunks of the window from the top down
+static bool FindColumnTopZ(world* World, vec2i P, s32* OutZ)
+{
+    bool Result = false;
+
+    vec3i PlayerChunkP = GetChunkP((vec3i)Floor(World->Player.P));
+    vec3i ColumnChunkP = GetChunkP(vec3i{ P.x, P.y, PlayerChunkP.z });
+    vec2i RelP = P - (vec2i)ColumnChunkP;
+    for (s32 ChunkZ = world::GenerationDistanceZ; (ChunkZ >= -world::GenerationDistanceZ) && !Result; ChunkZ--)
+    {
+        chunk* Chunk = GetChunkFromP(World, ColumnChunkP + vec3i{ 0, 0, ChunkZ * CHUNK_DIM_Z });
+        if (Chunk && (Chunk->GenerationLevel == ChunkGen_LevelFinal) && (Chunk->HighestNonAirZ[RelP.y][RelP.x] >= 0))
+        {
+            *OutZ = Chunk->P.z + Chunk->HighestNonAirZ[RelP.y][RelP.x];
+            Result = true;
+        }
+    }
+    return(Result);
+}
+
+static chunk* ReserveChunk(world* World, vec3i P)
+{
+    assert(!GetChunkFromP(World, P));
+
     chunk* Result = nullptr;
-    u32 Index = HashChunkP(World, P);
-    assert(Index < World->MaxChunkCount);
+    chunk_table* Table = &World->ChunkTable;
+    if (Table->Count + Table->TombstoneCount >= Table->MaxUsedCount)
+    {
+        RehashChunkTable(Table);
+    }
 
-    Result = World->Chunks + Index;
-    if (Result->P != P)
+    if (World->FreeChunkCount)
     {
-        FreeChunkMesh(World, Result);
-        Result->P = P;
-        Result->GenerationLevel = ChunkGen_Level0;
-        Result->IsMeshDirty = false;
+        chunk* Chunk = World->FreeChunks[World->FreeChunkCount - 1];
+        assert(!Chunk->Data && !Chunk->VertexBlock);
+        Chunk->P = P;
+        if (InsertChunk(Table, Chunk))
+        {
+            World->FreeChunkCount--;
+            Chunk->Data = AllocateChunkData(&World->ChunkDataPool, Chunk);
+            assert(Chunk->Data);
+            Result = Chunk;
+        }
     }
 
     return Result;
@@ -325,13 +518,8 @@ static chunk* FindPlayerChunk(world* World)
     TIMED_FUNCTION();
     chunk* Result = nullptr;
 
-    vec2i PlayerChunkP = ((vec2i)Floor(vec2{ World->Player.P.x / CHUNK_DIM_XY, World->Player.P.y / CHUNK_DIM_XY })) * vec2i{ CHUNK_DIM_XY, CHUNK_DIM_XY };
-    u32 Index = HashChunkP(World, PlayerChunkP);
-    chunk* Chunk = World->Chunks + Index;
-    if (Chunk->P == PlayerChunkP)
-    {
-        Result = Chunk;
-    }
+    vec3i PlayerChunkP = GetChunkP((vec3i)Floor(World->Player.P));
+    Result = GetChunkFromP(World, PlayerChunkP);
     return Result;
 }
 
@@ -356,30 +544,21 @@ bool RayCast(
     bool AnyHit = false;
     vec3i HitP = {};
     direction HitDirection = DIRECTION_First;
-    for (s32 z = StartP.z; z <= EndP.z; z++)
-    {
-        for (s32 y = StartP.y; y <= EndP.y; y++)
+    ForEachSolidVoxel(World, StartP, EndP, 
+        [&](vec3i VoxelP)
         {
-            for (s32 x = StartP.x; x <= EndP.x; x++)
-            {
-                u16 Voxel = GetVoxelTypeAt(World, vec3i{x, y, z});
-                if (Voxel != VOXEL_AIR)
-                {
-                    aabb Box = MakeAABB(vec3{ (f32)x, (f32)y, (f32)z }, vec3{ (f32)(x + 1), (f32)(y + 1), (f32)(z + 1) });
+            aabb Box = MakeAABB((vec3)VoxelP, (vec3)(VoxelP + vec3i{ 1, 1, 1 }));
 
-                    f32 tCurrent;
-                    direction CurrentDir;
-                    if (IntersectRayAABB(P, V, Box, 0.0f, tMax, &tCurrent, &CurrentDir))
-                    {
-                        tMax = Min(tMax, tCurrent);
-                        HitP = vec3i { x, y, z };
-                        HitDirection = CurrentDir;
-                        AnyHit = true;
-                    }
-                }
+            f32 tCurrent;
+            direction CurrentDir;
+            if (IntersectRayAABB(P, V, Box, 0.0f, tMax, &tCurrent, &CurrentDir))
+            {
+                tMax = Min(tMax, tCurrent);
+                HitP = VoxelP;
+                HitDirection = CurrentDir;
+                AnyHit = true;
             }
-        }
-    }
+        });
 
     if (AnyHit)
     {
@@ -413,27 +592,17 @@ vec3 MoveEntityBy(world* World, entity* Entity, aabb AABB, vec3 dP)
             u32 AABBAt = 0;
             aabb AABBStack[AABBStackSize];
 
-            for (s32 z = MinPi.z; z <= MaxPi.z; z++)
-            {
-                for (s32 y = MinPi.y; y <= MaxPi.y; y++)
+            ForEachSolidVoxel(World, MinPi, MaxPi,
+                [&](vec3i VoxelP)
                 {
-                    for (s32 x = MinPi.x; x <= MaxPi.x; x++)
+                    assert(AABBAt < AABBStackSize);
+                    aabb VoxelAABB = 
                     {
-                        u16 VoxelType = GetVoxelTypeAt(World, vec3i{x, y, z});
-                        const voxel_desc* VoxelDesc = &VoxelDescs[VoxelType];
-                        if (VoxelDesc->Flags & VOXEL_FLAGS_SOLID)
-                        {
-                            assert(AABBAt < AABBStackSize);
-                            aabb VoxelAABB = 
-                            {
-                                .Min = { (f32)x, (f32)y, (f32)z },
-                                .Max = { (f32)(x + 1), (f32)(y + 1), (f32)(z + 1) },
-                            };
-                            AABBStack[AABBAt++] = VoxelAABB;
-                        }
-                    }
-                }
-            }
+                        .Min = (vec3)VoxelP,
+                        .Max = (vec3)(VoxelP + vec3i{ 1, 1, 1 }),
+                    };
+                    AABBStack[AABBAt++] = VoxelAABB;
+                });
 
             float Displacement = 0.0f;
             IsCollision = false;
@@ -486,118 +655,138 @@ void LoadChunksAroundPlayer(world* World, memory_arena* TransientArena)
 {
     TIMED_FUNCTION();
 
-    vec2 PlayerP = (vec2)World->Player.P;
-    vec2i PlayerChunkP = ((vec2i)Floor(PlayerP / vec2{ (f32)CHUNK_DIM_XY, (f32)CHUNK_DIM_XY })) * vec2i{ CHUNK_DIM_XY, CHUNK_DIM_XY };
+    constexpr s32 MeshDistanceXY = world::MeshDistanceXY;
+    constexpr s32 MeshDistanceZ = world::MeshDistanceZ;
+    constexpr s32 GenerationDistanceXY = world::GenerationDistanceXY;
+    constexpr s32 GenerationDistanceZ = world::GenerationDistanceZ;
 
-    constexpr s32 ImmediateMeshDistance = 1;
-    constexpr s32 ImmediateGenerationDistance = ImmediateMeshDistance + 1;
-#if BLOKKER_TINY_RENDER_DISTANCE
-    constexpr s32 MeshDistance = 3;
-#else
-    constexpr s32 MeshDistance = 32;
-#endif
-    constexpr s32 GenerationDistance = MeshDistance + 1;
+    vec3i PlayerChunkP = GetChunkP((vec3i)Floor(World->Player.P));
 
-    // Create a stack that'll hold the chunks that haven't been meshed/generated around the player.
-    constexpr u32 StackSize = (2*GenerationDistance + 1)*(2*GenerationDistance + 1);
-    u32 StackAt = 0;
-    chunk** Stack = PushArray<chunk*>(TransientArena, StackSize);
-
-    chunk* PlayerChunk = FindPlayerChunk(World);
-    if (!PlayerChunk)
+    // NOTE(boti): The chunks that were left behind are only evicted when the player changes chunks,
+    //             or when the pool runs dry (because of the chunks that were skipped with work in flight)
+    if (PlayerChunkP != World->LastEvictionP || World->ChunkDataPool.FreeCount == 0)
     {
-        PlayerChunk = ReserveChunk(World, PlayerChunkP);
-        if (PlayerChunk)
-        {
-            Stack[StackAt++] = PlayerChunk;
-            PlayerChunk->P = PlayerChunkP;
-        }
+        EvictDistantChunks(World, PlayerChunkP);
     }
-    
-    if (PlayerChunk->GenerationLevel != ChunkGen_LevelFinal || !PlayerChunk->VertexBlock || PlayerChunk->IsMeshDirty)
+    CompressColdChunks(World, PlayerChunkP);
+
+    // NOTE(boti): The distance of a chunk is the larger of its horizontal (Chebyshev) and vertical distance from the player chunk,
+    //             so the rings around the player are the shells of a box that's cut off vertically
+    auto GetDistance = [PlayerChunkP](const chunk* Chunk) -> s32
     {
-        Stack[StackAt++] = PlayerChunk;
-    }
+        s32 DistanceXY = ChebyshevDistance((vec2i)Chunk->P, (vec2i)PlayerChunkP) / CHUNK_DIM_XY;
+        s32 DistanceZ = Abs(Chunk->P.z - PlayerChunkP.z) / CHUNK_DIM_Z;
+        return Max(DistanceXY, DistanceZ);
+    };
+
+    // Create a stack that'll hold the chunks that haven't been meshed/generated around the player.
+    // NOTE(boti): The stack gets sorted by distance (counting sort), so that the closer chunks are queued first
+    constexpr s32 MaxDistance = (GenerationDistanceXY > GenerationDistanceZ) ? GenerationDistanceXY : GenerationDistanceZ;
+    constexpr u32 StackSize = (2*GenerationDistanceXY + 1)*(2*GenerationDistanceXY + 1)*(2*GenerationDistanceZ + 1);
+    u32 StackAt = 0;
+    chunk** Stack = PushArray<chunk*>(TransientArena, StackSize);
+    chunk** UnsortedStack = PushArray<chunk*>(TransientArena, StackSize);
+    u32 DistanceOffsets[MaxDistance + 2] = {};
 
     // Keep track of closest rings around the player that have been fully generated or meshed
-    s32 ClosestNotGeneratedDistance = GenerationDistance + 1;
-    s32 ClosestNotMeshedDistance = MeshDistance + 1;
+    s32 ClosestNotGeneratedDistance = MaxDistance + 1;
+    s32 ClosestNotMeshedDistance = MeshDistanceXY + 1;
 
-    for (s32 Ring = 0; Ring <= GenerationDistance; Ring++)
+    for (s32 z = -GenerationDistanceZ; z <= GenerationDistanceZ; z++)
     {
-        u32 Diameter = 2*Ring + 1;
-        vec2i CurrentP = PlayerChunk->P - vec2i{ Ring * CHUNK_DIM_XY, Ring * CHUNK_DIM_XY};
-
-        u32 CurrentCardinal = South; // last
-        for (u32 CardinalIndex = 0; CardinalIndex < 4; CardinalIndex++)
+        for (s32 y = -GenerationDistanceXY; y <= GenerationDistanceXY; y++)
         {
-            CurrentCardinal = CardinalNext(CurrentCardinal);
-            for (u32 EdgeIndex = 0; EdgeIndex < Diameter - 1; EdgeIndex++)
+            for (s32 x = -GenerationDistanceXY; x <= GenerationDistanceXY; x++)
             {
-                CurrentP = CurrentP + CardinalDirections[CurrentCardinal] * CHUNK_DIM_XY;
+                vec3i CurrentP = PlayerChunkP + vec3i{ x, y, z } * CHUNK_DIM;
                 chunk* Chunk = GetChunkFromP(World, CurrentP);
                 if (!Chunk)
                 {
                     Chunk = ReserveChunk(World, CurrentP);
+                    if (!Chunk)
+                    {
+                        // NOTE(boti): Couldn't load the chunk this frame, but the rings around it still can't be considered generated
+                        s32 Distance = Max(Max(Abs(x), Abs(y)), Abs(z));
+                        ClosestNotGeneratedDistance = Min(Distance, ClosestNotGeneratedDistance);
+                        ClosestNotMeshedDistance = Min(Distance, ClosestNotMeshedDistance);
+                        continue;
+                    }
                 }
 
-                if (Chunk->GenerationLevel != ChunkGen_LevelFinal || !Chunk->VertexBlock || Chunk->IsMeshDirty)
+                if (Chunk->GenerationLevel != ChunkGen_LevelFinal || !Chunk->IsMeshed || Chunk->IsMeshDirty || Chunk->InMeshQueue)
                 {
-                    Stack[StackAt++] = Chunk;
+                    s32 Distance = GetDistance(Chunk);
+                    UnsortedStack[StackAt++] = Chunk;
+                    DistanceOffsets[Distance + 1]++;
 
-                    if (Chunk->GenerationLevel != ChunkGen_LevelFinal)
+                    // NOTE(boti): The top and bottom layers never have all of their neighbors, so they can't become final
+                    if (Chunk->GenerationLevel != ChunkGen_LevelFinal && Abs(z) < GenerationDistanceZ)
                     {
-                        ClosestNotGeneratedDistance = Min(Ring, ClosestNotGeneratedDistance);
+                        ClosestNotGeneratedDistance = Min(Distance, ClosestNotGeneratedDistance);
                     }
-                    if (!Chunk->VertexBlock)
+                    if (!Chunk->IsMeshed && Abs(z) <= MeshDistanceZ)
                     {
-                        ClosestNotMeshedDistance = Min(Ring, ClosestNotMeshedDistance);
+                        ClosestNotMeshedDistance = Min(Distance, ClosestNotMeshedDistance);
                     }
                 }
             }
         }
     }
 
+    for (s32 Distance = 0; Distance <= MaxDistance; Distance++)
+    {
+        DistanceOffsets[Distance + 1] += DistanceOffsets[Distance];
+    }
     for (u32 i = 0; i < StackAt; i++)
+    {
+        chunk* Chunk = UnsortedStack[i];
+        Stack[DistanceOffsets[GetDistance(Chunk)]++] = Chunk;
+    }
+
+    // NOTE(boti): The closest chunks get queued first, the rest has to wait until enough of the works in flight are flushed
+    for (u32 i = 0; (i < StackAt) && (World->ChunkWorkCount < world::MaxChunkWorkCount); i++)
     {
         chunk* Chunk = Stack[i];
-        s32 Distance = ChebyshevDistance(Chunk->P, PlayerChunkP) / CHUNK_DIM_XY;
+        s32 Distance = GetDistance(Chunk);
 
-        bool ShouldGenerate = Distance <= ClosestNotGeneratedDistance/* || Distance < ImmediateGenerationDistance*/;
+        // NOTE(boti): The terrain has to run one ring ahead, because the decorations need the neighbors' terrain
+        bool ShouldGenerate = (Chunk->GenerationLevel == ChunkGen_Level0) ?
+            Distance <= ClosestNotGeneratedDistance + 1 :
+            Distance <= ClosestNotGeneratedDistance;
 
-        if (ShouldGenerate && !Chunk->InGenerationQueue && Chunk->GenerationLevel != ChunkGen_LevelFinal)
+        if (ShouldGenerate && !Chunk->InGenerationQueue && CanGenerateChunk(World, Chunk))
         {
-            Chunk->InGenerationQueue = true;
-            Platform.AddWork(Platform.LowPriorityQueue,
-                [Chunk, World](memory_arena* Arena)
-                {
-                    Generate(Chunk, World);
-
-                    chunk_work* Work = GetNextChunkWorkToWrite(&World->ChunkWorkQueue);
-                    Work->Type = ChunkWork_Generate;
-                    Work->Chunk = Chunk;
-                    AtomicExchange(&Work->IsReady, true);
-                });
+            QueueChunkGeneration(World, Chunk);
         }
     }
 
-    for (u32 i = 0; i < StackAt; i++)
+    for (u32 i = 0; (i < StackAt) && (World->ChunkWorkCount < world::MaxChunkWorkCount); i++)
     {
         chunk* Chunk = Stack[i];
 
-        s32 Distance = ChebyshevDistance(Chunk->P, PlayerChunkP) / CHUNK_DIM_XY;
+        s32 Distance = GetDistance(Chunk);
+        s32 DistanceZ = Abs(Chunk->P.z - PlayerChunkP.z) / CHUNK_DIM_Z;
+        // NOTE(boti): Meshing reads the neighbors too, and decorations can spill over from them,
+        //             so the neighbors need to be final as well
         bool ShouldMesh = 
-            Distance < ClosestNotGeneratedDistance && 
+            Distance + 1 < ClosestNotGeneratedDistance && 
             Distance <= ClosestNotMeshedDistance && 
-            Distance <= MeshDistance;
+            Distance <= MeshDistanceXY &&
+            DistanceZ <= MeshDistanceZ;
         
         if (ShouldMesh && !Chunk->InMeshQueue &&
-            (!Chunk->VertexBlock || Chunk->IsMeshDirty))
+            (!Chunk->IsMeshed || Chunk->IsMeshDirty))
         {
             platform_work_queue* Queue = Chunk->IsMeshDirty ?
                 Platform.HighPriorityQueue : Platform.LowPriorityQueue;
 
+            // NOTE(boti): Meshing only reads the voxels of the chunk itself, the neighbors are read through their masks.
+            //             The dirty flag is cleared here instead of when the mesh arrives,
+            //             so that the edits made while the mesh is being built get another mesh
+            DecompressChunk(World, Chunk);
+            Chunk->IsMeshDirty = false;
             Chunk->InMeshQueue = true;
+            World->ChunkWorkCount++;
             Platform.AddWork(Queue,
                 [Chunk, World](memory_arena* Arena)
                 {
@@ -628,7 +817,113 @@ void LoadChunksAroundPlayer(world* World, memory_arena* TransientArena)
     }
 }
 
-static void FlushChunkWorks(world* World, render_frame* Frame, bool WaitForPlayerChunk, chunk* PlayerChunk)
+static bool CanGenerateChunk(world* World, chunk* Chunk)
+{
+    bool Result = false;
+    if (Chunk->GenerationLevel == ChunkGen_Level0)
+    {
+        Result = true;
+    }
+    else if (Chunk->GenerationLevel == ChunkGen_Level1)
+    {
+        // NOTE(boti): Structures can spill over from the neighbors, so they all need to have placed theirs
+        Result = true;
+        for (s32 z = -1; z <= 1; z++)
+        {
+            for (s32 y = -1; y <= 1; y++)
+            {
+                for (s32 x = -1; x <= 1; x++)
+                {
+                    chunk* Neighbor = Chunk->Neighbors[z + 1][y + 1][x + 1];
+                    if (!Neighbor || Neighbor->GenerationLevel < ChunkGen_Level1)
+                    {
+                        Result = false;
+                    }
+                }
+            }
+        }
+    }
+    return(Result);
+}
+
+static void QueueChunkGeneration(world* World, chunk* Chunk)
+{
+    assert(!Chunk->InGenerationQueue);
+    assert(CanGenerateChunk(World, Chunk));
+
+    u32 Level = Chunk->GenerationLevel;
+    Chunk->InGenerationQueue = true;
+    World->ChunkWorkCount++;
+    Platform.AddWork(Platform.LowPriorityQueue,
+        [Chunk, World, Level](memory_arena* Arena)
+        {
+            if (Level == ChunkGen_Level0)
+            {
+                Generate(Chunk, &World->Generator, Arena);
+            }
+            else
+            {
+                const chunk* Neighborhood[3][3][3] = {};
+                for (s32 z = -1; z <= 1; z++)
+                {
+                    for (s32 y = -1; y <= 1; y++)
+                    {
+                        for (s32 x = -1; x <= 1; x++)
+                        {
+                            Neighborhood[z + 1][y + 1][x + 1] = Chunk->Neighbors[z + 1][y + 1][x + 1];
+                        }
+                    }
+                }
+                GenerateDecorations(Chunk, Neighborhood, &World->Generator);
+            }
+
+            chunk_work* Work = GetNextChunkWorkToWrite(&World->ChunkWorkQueue);
+            Work->Type = ChunkWork_Generate;
+            Work->Chunk = Chunk;
+            AtomicExchange(&Work->IsReady, true);
+        });
+}
+
+// NOTE(boti): Queues whatever the player chunk is still waiting on, regardless of MaxChunkWorkCount:
+//             the terrain of its neighbors (for its decorations) and its own passes.
+//             The chunks that aren't loaded yet are reserved here too, evicting the distant ones if the pool ran dry.
+//             Returns the player chunk, nullptr if it couldn't be reserved yet
+static chunk* QueuePlayerChunkGeneration(world* World)
+{
+    vec3i PlayerChunkP = GetChunkP((vec3i)Floor(World->Player.P));
+    for (s32 z = -1; z <= 1; z++)
+    {
+        for (s32 y = -1; y <= 1; y++)
+        {
+            for (s32 x = -1; x <= 1; x++)
+            {
+                vec3i P = PlayerChunkP + vec3i{ x, y, z } * CHUNK_DIM;
+                chunk* Chunk = GetChunkFromP(World, P);
+                if (!Chunk)
+                {
+                    if (World->ChunkDataPool.FreeCount == 0)
+                    {
+                        EvictDistantChunks(World, PlayerChunkP);
+                    }
+                    Chunk = ReserveChunk(World, P);
+                }
+
+                bool IsPlayerChunk = (x == 0) && (y == 0) && (z == 0);
+                if (Chunk && !Chunk->InGenerationQueue &&
+                    ((Chunk->GenerationLevel == ChunkGen_Level0) || (IsPlayerChunk && Chunk->GenerationLevel != ChunkGen_LevelFinal)) &&
+                    CanGenerateChunk(World, Chunk))
+                {
+                    QueueChunkGeneration(World, Chunk);
+                }
+            }
+        }
+    }
+
+    chunk* Result = GetChunkFromP(World, PlayerChunkP);
+    return(Result);
+}
+
+static void FlushChunkWorks(world* World, render_frame* Frame, bool WaitForPlayerChunk)
 {
     do
     {
@@ -646,148 +941,109 @@ static void FlushChunkWorks(world* World, render_frame* Frame, bool WaitForPlaye
             {
                 Chunk->GenerationLevel++;
                 Chunk->InGenerationQueue = false;
-                if (Chunk == PlayerChunk)
-                {
-                    WaitForPlayerChunk = false;
-                }
+                World->ChunkWorkCount--;
             }
             else if (Work->Type == ChunkWork_BuildMesh)
             {
+                b32 IsMeshDirty = Chunk->IsMeshDirty;
                 FreeChunkMesh(World, Work->Chunk);
+                Chunk->IsMeshDirty = IsMeshDirty;
 
                 u64 Count = Work->Mesh.OnePastLastIndex - Work->Mesh.FirstIndex;
                 u64 Size = Count * sizeof(terrain_vertex);
 
-                u64 HeadCount = Count;
-                u64 TailCount = 0;
-                u64 FirstIndexModCount = Work->Mesh.FirstIndex % Queue->VertexBufferCount;
-                u64 OnePastLastIndexModCount = Work->Mesh.OnePastLastIndex % Queue->VertexBufferCount;
-                if (OnePastLastIndexModCount < FirstIndexModCount)
+                // NOTE(boti): Chunks with nothing to draw (e.g. the ones up in the air) don't get a vertex block,
+                //             and they don't take up any space in the vertex ring buffer either
+                if (Count)
                 {
-                    HeadCount = Queue->VertexBufferCount - FirstIndexModCount;
-                    TailCount = OnePastLastIndexModCount;
-                }
-                u64 HeadSize = HeadCount * sizeof(terrain_vertex);
-                u64 TailSize = TailCount * sizeof(terrain_vertex);
+                    u64 HeadCount = Count;
+                    u64 TailCount = 0;
+                    u64 FirstIndexModCount = Work->Mesh.FirstIndex % Queue->VertexBufferCount;
+                    u64 OnePastLastIndexModCount = Work->Mesh.OnePastLastIndex % Queue->VertexBufferCount;
+                    if (OnePastLastIndexModCount < FirstIndexModCount)
+                    {
+                        HeadCount = Queue->VertexBufferCount - FirstIndexModCount;
+                        TailCount = OnePastLastIndexModCount;
+                    }
+                    u64 HeadSize = HeadCount * sizeof(terrain_vertex);
+                    u64 TailSize = TailCount * sizeof(terrain_vertex);
 
-                Chunk->VertexBlock = AllocateAndUploadVertexBlock(Frame, 
-                                                                 HeadSize, Queue->VertexBuffer + FirstIndexModCount,
-                                                                 TailSize, Queue->VertexBuffer);
-                Chunk->IsMeshDirty = false;
+                    Chunk->VertexBlock = AllocateAndUploadVertexBlock(Frame, 
+                                                                     HeadSize, Queue->VertexBuffer + FirstIndexModCount,
+                                                                     TailSize, Queue->VertexBuffer);
                 
-                if (Queue->VertexReadIndex == Work->Mesh.FirstIndex)
-                {
-                    AtomicExchange(&Queue->VertexReadIndex, Work->Mesh.OnePastLastIndex);
-                    if (Queue->IsLastMeshValid)
+                    if (Queue->VertexReadIndex == Work->Mesh.FirstIndex)
                     {
-                        if (Queue->LastMeshFirstIndex == Queue->VertexReadIndex)
-                        {
-                            AtomicExchange(&Queue->VertexReadIndex, Queue->LastMeshOnePastLastIndex);
-                            Queue->IsLastMeshValid = false;
-                        }
-                        else
+                        AtomicExchange(&Queue->VertexReadIndex, Work->Mesh.OnePastLastIndex);
+                        if (Queue->IsLastMeshValid)
                         {
-                            FatalError("Too many out of order mesh chunk works");
+                            if (Queue->LastMeshFirstIndex == Queue->VertexReadIndex)
+                            {
+                                AtomicExchange(&Queue->VertexReadIndex, Queue->LastMeshOnePastLastIndex);
+                                Queue->IsLastMeshValid = false;
+                            }
+                            else
+                            {
+                                FatalError("Too many out of order mesh chunk works");
+                            }
                         }
                     }
+                    else
+                    {
+                        Assert(!Queue->IsLastMeshValid);
+                        Queue->IsLastMeshValid = true;
+                        Queue->LastMeshFirstIndex = Work->Mesh.FirstIndex;
+                        Queue->LastMeshOnePastLastIndex = Work->Mesh.OnePastLastIndex;
+                    }
                 }
-                else
-                {
-                    Assert(!Queue->IsLastMeshValid);
-                    Queue->IsLastMeshValid = true;
-                    Queue->LastMeshFirstIndex = Work->Mesh.FirstIndex;
-                    Queue->LastMeshOnePastLastIndex = Work->Mesh.OnePastLastIndex;
-                }
+                Chunk->IsMeshed = (Count == 0) || (Chunk->VertexBlock != nullptr);
 
                 Chunk->InMeshQueue = false;
+                World->ChunkWorkCount--;
             }
 
             AtomicExchange(&Work->IsReady, false);
         }
-    } while (WaitForPlayerChunk);
-}
-
-static void InitializeWorldGenerator(world_generator* Generator, u32 Seed, memory_arena* Arena)
-{
-    Generator->Seed = Seed;
-    Perlin2_Init(&Generator->Perlin2, Seed);
-    Perlin3_Init(&Generator->Perlin3, Seed);
-
-    Generator->StructureCount = 1;
-    Generator->Structures = PushArray<world_structure>(Arena, Generator->StructureCount);
-    if (Generator->Structures)
-    {
-        world_structure* Tree = Generator->TreeStructure = Generator->Structures + 0;
-        
-        constexpr u16 O = VOXEL_INVALID;
-        constexpr u16 T = VOXEL_TREE_TRUNK;
-        constexpr u16 L = VOXEL_LEAVES;
 
-        constexpr s32 DIM_Z = 6;
-        constexpr s32 DIM_Y = 5;
-        constexpr s32 DIM_X = 5;
-
-        u16 Voxels[DIM_Z][DIM_Y][DIM_X] = 
+        // NOTE(boti): The player chunk needs both generation passes, the second one can only be queued
+        //             once the neighbors have caught up. LoadChunksAroundPlayer might not have queued any of them
+        //             (e.g. right after a teleport with the works for the far rings at the cap), so they're queued here
+        if (WaitForPlayerChunk)
         {
-            {
-                { O, O, O, O, O, },
-                { O, O, O, O, O, },
-                { O, O, T, O, O, },
-                { O, O, O, O, O, },
-                { O, O, O, O, O, },
-            },
-            {
-                { O, O, O, O, O, },
-                { O, O, O, O, O, },
-                { O, O, T, O, O, },
-                { O, O, O, O, O, },
-                { O, O, O, O, O, },
-            },
-            {
-                { L, L, L, L, L, },
-                { L, L, L, L, L, },
-                { L, L, T, L, L, },
-                { L, L, L, L, L, },
-                { L, L, L, L, L, },
-            },
-            {
-                { L, L, L, L, L, },
-                { L, L, L, L, L, },
-                { L, L, T, L, L, },
-                { L, L, L, L, L, },
-                { L, L, L, L, L, },
-            },
-            {
-                { O, L, L, L, O, },
-                { L, L, L, L, L, },
-                { L, L, T, L, L, },
-                { L, L, L, L, L, },
-                { O, L, L, L, O, },
-            },
-            {
-                { O, O, O, O, O, },
-                { O, L, L, L, O, },
-                { O, L, L, L, O, },
-                { O, L, L, L, O, },
-                { O, O, O, O, O, },
-            },
-        };
-
-        Tree->Voxels = PushArray<u16>(Arena, DIM_Z*DIM_Y*DIM_X);
-        if (Tree->Voxels)
-        {
-            Tree->Extent = vec3i{ DIM_X, DIM_Y, DIM_Z };
-            memcpy(Tree->Voxels, Voxels, sizeof(Voxels));
+            chunk* PlayerChunk = QueuePlayerChunkGeneration(World);
+            WaitForPlayerChunk = !PlayerChunk || (PlayerChunk->GenerationLevel != ChunkGen_LevelFinal);
         }
-    }
+    } while (WaitForPlayerChunk);
 }
 
 bool InitializeWorld(world* World)
 {
     // Allocate chunk memory
-    World->Chunks = PushArray<chunk>(World->Arena, world::MaxChunkCount);
-    World->ChunkData = PushArray<chunk_data>(World->Arena, world::MaxChunkCount);
-    if (!World->Chunks || !World->ChunkData)
+    World->Chunks = PushArray<chunk>(World->Arena, world::MaxLoadedChunkCount);
+    World->FreeChunks = PushArray<chunk*>(World->Arena, world::MaxLoadedChunkCount);
+    if (!World->Chunks || !World->FreeChunks)
+    {
+        return false;
+    }
+    if (!InitializeChunkTable(&World->ChunkTable, world::ChunkTableCapacity, World->Arena))
+    {
+        return false;
+    }
+
+    // NOTE(boti): Both pools are sized for the chunks that can be loaded at the same time, not the whole chunk table.
+    //             The blocks of the section pool never move between size classes, and with the compressed sections
+    //             any of them can be in use for every section, so there's room for one block of each size (1+2+4 bits).
+    //             Only the pages that get used are ever touched
+    u64 SectionPoolSize = (u64)world::MaxLoadedChunkCount * CHUNK_SECTION_COUNT * 
+        (CHUNK_MAX_SECTION_INDICES_SIZE + CHUNK_MAX_SECTION_INDICES_SIZE / 2 + CHUNK_MAX_SECTION_INDICES_SIZE / 4);
+    void* SectionPoolMemory = PushSize(World->Arena, SectionPoolSize);
+    if (!SectionPoolMemory)
+    {
+        return false;
+    }
+    InitializeChunkSectionPool(&World->SectionPool, SectionPoolSize, SectionPoolMemory);
+    if (!InitializeChunkDataPool(&World->ChunkDataPool, world::MaxLoadedChunkCount, world::VoxelLayout,
+                                 &World->SectionPool, World->Arena))
     {
         return false;
     }
@@ -799,24 +1055,39 @@ bool InitializeWorld(world* World)
     }
 
     // Init chunks
-    for (u32 i = 0; i < World->MaxChunkCount; i++)
+    World->FreeChunkCount = world::MaxLoadedChunkCount;
+    for (u32 i = 0; i < world::MaxLoadedChunkCount; i++)
     {
         chunk* Chunk = World->Chunks + i;
-        chunk_data* ChunkData = World->ChunkData + i;
 
         Chunk->VertexBlock = nullptr;
-        Chunk->Data = ChunkData;
+        Chunk->IsMeshed = false;
+        Chunk->Data = nullptr;
+        // NOTE(boti): Reversed, so that the chunks get used from the front of the array
+        World->FreeChunks[i] = World->Chunks + (world::MaxLoadedChunkCount - 1 - i);
     }
 
-    // Place the player in the middle of the starting chunk
-    World->Player.P = { (0.5f * CHUNK_DIM_XY + 0.5f), 0.5f * CHUNK_DIM_XY + 0.5f, 100.0f };
+    // NOTE(boti): The terrain description is optional, the generator falls back to the built-in one if it's missing or invalid
+    {
+        u32 ErrorLine = 0;
+        buffer GraphSource = Platform.LoadEntireFile("worldgen/terrain.txt", World->Arena);
+        if (!InitializeWorldGenerator(&World->Generator, 1337, GraphSource, World->Arena, &ErrorLine))
+        {
+            Platform.DebugPrint("worldgen/terrain.txt(%u): invalid terrain description, using the default terrain\n", ErrorLine);
+        }
+    }
+
+    // Place the player in the middle of the starting chunk, on top of the terrain
+    World->Player.P = { (0.5f * CHUNK_DIM_XY + 0.5f), 0.5f * CHUNK_DIM_XY + 0.5f, 0.0f };
+    {
+        vec2i SpawnP = (vec2i)Floor((vec2)World->Player.P);
+        World->Player.P.z = GetTerrainHeight(&World->Generator, SpawnP) + 1 + World->Player.EyeHeight;
+    }
     World->Player.CurrentFov = World->Player.DefaultFov;
     World->Player.TargetFov = World->Player.TargetFov;
 
     World->Debug.DebugCamera.FieldOfView = ToRadians(90.0f);
 
-    InitializeWorldGenerator(&World->Generator, 1337, World->Arena);
-
     return true;
 }
 
@@ -919,6 +1190,11 @@ void UpdateAndRenderWorld(game_state* Game, world* World, game_io* IO, render_fr
             ImGui::Checkbox("Hitboxes", &World->Debug.IsHitboxEnabled);
             ImGui::Text("PlayerP: { %.1f, %.1f, %.1f }", 
                         World->Player.P.x, World->Player.P.y, World->Player.P.z);
+            if (World->Generator.Graph.BiomeCount)
+            {
+                u32 Biome = GetBiome(&World->Generator, vec2i{ (s32)Floor(World->Player.P.x), (s32)Floor(World->Player.P.y) });
+                ImGui::Text("Biome: %s", World->Generator.Graph.BiomeNames[Biome]);
+            }
             if (ImGui::Button("Reset player"))
             {
                 ResetPlayer(World);
@@ -937,13 +1213,24 @@ void UpdateAndRenderWorld(game_state* Game, world* World, game_io* IO, render_fr
             {
                 World->Player.P = Game->World->Debug.DebugCamera.P;
             }
+            ImGui::Checkbox("Teleport when the chunk works are at the cap", &World->Debug.IsTeleportStressEnabled);
+            ImGui::Text("Teleports: %u, chunk works: %u/%u", 
+                        World->Debug.StressTeleportCount, World->ChunkWorkCount, world::MaxChunkWorkCount);
         }
         ImGui::End();
     }
 
     if (World->MapView.IsEnabled)
     {
+        // NOTE(boti): The view orbits the top of the terrain under the target, it keeps the last height over unloaded columns
+        s32 TopZ = 0;
+        if (FindColumnTopZ(World, (vec2i)Floor(World->MapView.TargetP), &TopZ))
+        {
+            World->MapView.TargetZ = (f32)(TopZ + 1);
+        }
+
         World->MapView.CurrentP = Lerp(World->MapView.CurrentP, World->MapView.TargetP, 1.0f - Exp(-50.0f * IO->DeltaTime));
+        World->MapView.CurrentZ = Lerp(World->MapView.CurrentZ, World->MapView.TargetZ, 1.0f - Exp(-20.0f * IO->DeltaTime));
         World->MapView.CurrentYaw = Lerp(World->MapView.CurrentYaw, World->MapView.TargetYaw, 1.0f - Exp(-30.0f * IO->DeltaTime));
         World->MapView.CurrentPitch = Lerp(World->MapView.CurrentPitch, World->MapView.TargetPitch, 1.0f - Exp(-30.0f * IO->DeltaTime));
         World->MapView.ZoomCurrent = Lerp(World->MapView.ZoomCurrent, World->MapView.ZoomTarget, 1.0f - Exp(-20.0f * IO->DeltaTime));
@@ -975,7 +1262,7 @@ void UpdateAndRenderWorld(game_state* Game, world* World, game_io* IO, render_fr
         vec3 Right = Normalize(Cross(Forward, WorldUp));
         vec3 Up = Cross(Right, Forward);
 
-        vec3 P = vec3{ World->MapView.CurrentP.x, World->MapView.CurrentP.y, 80.0f };
+        vec3 P = vec3{ World->MapView.CurrentP.x, World->MapView.CurrentP.y, World->MapView.CurrentZ };
         mat4 ViewTransform = Mat4(
             Right.x, Right.y, Right.z, -Dot(Right, P),
             -Up.x, -Up.y, -Up.z, +Dot(Up, P),
@@ -996,17 +1283,17 @@ void UpdateAndRenderWorld(game_state* Game, world* World, game_io* IO, render_fr
         FreeVertexBlock(Frame, World->ChunkDeletionQueue[Index]);
     }
 
-    LoadChunksAroundPlayer(World, &Game->TransientArena);
-
-    bool WaitForPlayerChunk = false;
-    chunk* PlayerChunk = FindPlayerChunk(World);
-    if (PlayerChunk->GenerationLevel != ChunkGen_LevelFinal)
+    if (World->Debug.IsTeleportStressEnabled && (World->ChunkWorkCount >= world::MaxChunkWorkCount))
     {
-        WaitForPlayerChunk = true;
-        assert(PlayerChunk->InGenerationQueue);
+        World->Player.P.x += (f32)((world::GenerationDistanceXY + 1) * CHUNK_DIM_XY);
+        World->Debug.StressTeleportCount++;
     }
 
-    FlushChunkWorks(World, Frame, WaitForPlayerChunk, PlayerChunk);
+    LoadChunksAroundPlayer(World, &Game->TransientArena);
+
+    chunk* PlayerChunk = FindPlayerChunk(World);
+    bool WaitForPlayerChunk = !PlayerChunk || (PlayerChunk->GenerationLevel != ChunkGen_LevelFinal);
+    FlushChunkWorks(World, Frame, WaitForPlayerChunk);
 
 #if 1
     UpdatePlayer(Game, World, IO, &World->Player, Frame);
@@ -1027,18 +1314,60 @@ void UpdateAndRenderWorld(game_state* Game, world* World, game_io* IO, render_fr
         TIMED_BLOCK("ChunkUpdate");
 
         frustum CameraFrustum = Camera.GetFrustum((f32)Frame->RenderExtent.x / Frame->RenderExtent.y);
-        for (u32 i = 0; i < World->MaxChunkCount; i++)
+
+        // NOTE(boti): The meshed chunks are gathered in batches and culled together.
+        //             Only the chunks in the mesh window around the player are looked at, the ones outside of it
+        //             are about to be reused for other chunks anyway.
+        constexpr u32 CullBatchCount = 64;
+        const vec3 ChunkHalfExtent = { 0.5f * CHUNK_DIM_XY, 0.5f * CHUNK_DIM_XY, 0.5f * CHUNK_DIM_Z };
+        chunk* Batch[CullBatchCount];
+        f32 CenterX[CullBatchCount];
+        f32 CenterY[CullBatchCount];
+        f32 CenterZ[CullBatchCount];
+        u8 Visible[CullBatchCount];
+        u32 BatchCount = 0;
+
+        auto CullAndRenderBatch = [&]()
         {
-            chunk* Chunk = World->Chunks + i;
-            if (Chunk->VertexBlock)
+            Kernels->CullBoxes(&CameraFrustum, ChunkHalfExtent, BatchCount, CenterX, CenterY, CenterZ, Visible);
+            for (u32 BatchIndex = 0; BatchIndex < BatchCount; BatchIndex++)
             {
-                vec3 MinP = vec3{ (f32)Chunk->P.x, (f32)Chunk->P.y, 0.0f };
-                vec3 MaxP = MinP + vec3{ CHUNK_DIM_XY, CHUNK_DIM_XY, CHUNK_DIM_Z };
-                if (IntersectFrustumAABB(CameraFrustum, MakeAABB(MinP, MaxP)))
+                if (Visible[BatchIndex])
                 {
-                    RenderVertexBlock(Frame, Chunk->VertexBlock, (vec2)Chunk->P);
+                    RenderVertexBlock(Frame, Batch[BatchIndex]->VertexBlock, (vec3)Batch[BatchIndex]->P);
                 }
             }
+            BatchCount = 0;
+        };
+
+        vec3i PlayerChunkP = GetChunkP((vec3i)Floor(World->Player.P));
+        for (s32 z = -world::MeshDistanceZ; z <= world::MeshDistanceZ; z++)
+        {
+            for (s32 y = -world::MeshDistanceXY; y <= world::MeshDistanceXY; y++)
+            {
+                for (s32 x = -world::MeshDistanceXY; x <= world::MeshDistanceXY; x++)
+                {
+                    chunk* Chunk = GetChunkFromP(World, PlayerChunkP + vec3i{ x, y, z } * CHUNK_DIM);
+                    if (Chunk && Chunk->VertexBlock)
+                    {
+                        Batch[BatchCount] = Chunk;
+                        CenterX[BatchCount] = (f32)Chunk->P.x + ChunkHalfExtent.x;
+                        CenterY[BatchCount] = (f32)Chunk->P.y + ChunkHalfExtent.y;
+                        CenterZ[BatchCount] = (f32)Chunk->P.z + ChunkHalfExtent.z;
+                        BatchCount++;
+
+                        if (BatchCount == CullBatchCount)
+                        {
+                            CullAndRenderBatch();
+                        }
+                    }
+                }
+            }
+        }
+
+        if (BatchCount > 0)
+        {
+            CullAndRenderBatch();
         }
     }
 }
\ No newline at end of file
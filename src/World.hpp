@@ -5,6 +5,7 @@
 #include <Random.hpp>
 
 #include <Chunk.hpp>
+#include <WorldGen.hpp>
 #include <Camera.hpp>
 #include <Shapes.hpp>
 
@@ -16,12 +17,13 @@
 struct renderer;
 struct render_frame;
 
-inline vec2i GetChunkP(vec2i WorldP)
+inline vec3i GetChunkP(vec3i WorldP)
 {
-    vec2i Result = 
+    vec3i Result = 
     {
         FloorDiv(WorldP.x, CHUNK_DIM_XY) * CHUNK_DIM_XY,
         FloorDiv(WorldP.y, CHUNK_DIM_XY) * CHUNK_DIM_XY,
+        FloorDiv(WorldP.z, CHUNK_DIM_Z) * CHUNK_DIM_Z,
     };
     return(Result);
 }
@@ -83,6 +85,8 @@ struct map_view
 
     vec2 CurrentP;
     vec2 TargetP;
+    f32 CurrentZ;
+    f32 TargetZ;
     f32 CurrentYaw;
     f32 TargetYaw;
     f32 CurrentPitch;
@@ -97,24 +101,6 @@ struct map_view
     mat2 GetAxesXY() const;
 };
 
-struct world_structure
-{
-    vec3i Extent;
-    u16* Voxels;
-};
-
-struct world_generator
-{
-    u32 Seed;
-    perlin2 Perlin2;
-    perlin3 Perlin3;
-
-    u32 StructureCount;
-    world_structure* Structures;
-
-    world_structure* TreeStructure;
-};
-
 struct world
 {
     // NOTE(boti): for now the world just piggy-backs off of the game state's memory arena
@@ -122,16 +108,71 @@ struct world
 
     world_generator Generator;
 
-    static constexpr u32 MaxChunkCount = 16384;
-    static constexpr u32 MaxChunkCountSqrt = 128;
-    static_assert(MaxChunkCountSqrt*MaxChunkCountSqrt == MaxChunkCount);
-
+    // NOTE(boti): Distances are in chunks, the chunks are streamed in a box around the player
+    //             that's a lot shorter vertically than horizontally
+#if BLOKKER_TINY_RENDER_DISTANCE
+    static constexpr s32 MeshDistanceXY = 3;
+    static constexpr s32 MeshDistanceZ = 2;
+#else
+    static constexpr s32 MeshDistanceXY = 32;
+    static constexpr s32 MeshDistanceZ = 6;
+#endif
+    // NOTE(boti): +1 for the neighbors of the meshed chunks to be final, +1 for the neighbors of those to have their terrain
+    static constexpr s32 GenerationDistanceXY = MeshDistanceXY + 2;
+    static constexpr s32 GenerationDistanceZ = MeshDistanceZ + 2;
+
+    // NOTE(boti): Chunks keep their data until they're a ring outside of the generation window,
+    //             so that the jobs reading them as neighbors usually finish before they'd get evicted
+    //             (the ones that haven't are skipped, see IsChunkReadByWork).
+    //             Only the chunks inside this window can be loaded, which is what the chunk data pool is sized for.
+    static constexpr s32 EvictionDistanceXY = GenerationDistanceXY + 1;
+    static constexpr s32 EvictionDistanceZ = GenerationDistanceZ + 1;
+    static constexpr u32 MaxLoadedChunkCount = (2*EvictionDistanceXY + 1)*(2*EvictionDistanceXY + 1)*(2*EvictionDistanceZ + 1);
+    // NOTE(boti): The chunk table is kept at most half full, so that the probe sequences stay short
+    static constexpr u32 ChunkTableCapacity = 2 * MaxLoadedChunkCount;
+
+    // NOTE(boti): The brick layout measured within run-to-run noise of the linear one on both the neighborhood reads
+    //             and the ray casts (see the bench): a section is at most 2KiB, so it's in the cache either way
+    //             and the linear index is the simpler one to compute
+    static constexpr voxel_layout VoxelLayout = VoxelLayout_Linear;
+
+    // NOTE(boti): There are MaxLoadedChunkCount chunks, the loaded ones are in the chunk table and the rest are on the free list.
+    //             ChunkWorkCount is the number of generation/meshing works that haven't been flushed yet
     chunk* Chunks;
-    chunk_data* ChunkData;
+    u32 FreeChunkCount;
+    chunk** FreeChunks;
+    chunk_table ChunkTable;
+    u32 ChunkWorkCount;
+    // NOTE(boti): A work takes up a slot in the platform's work queue (512 works on Win32) until it runs,
+    //             and a slot in ChunkWorkQueue until the main thread flushes it.
+    //             Queueing more than what fits would have the main thread spin on a full queue that only it can drain.
+    //             The player chunk and its neighbors can go over the cap (see QueuePlayerChunkGeneration), by 27 works at most.
+    static constexpr u32 MaxChunkWorkCount = 384;
+    static_assert(MaxChunkWorkCount + 27 <= 512);
+    static_assert(MaxChunkWorkCount <= chunk_work_queue::MaxWorkCount);
+    chunk_data_pool ChunkDataPool;
+    chunk_section_pool SectionPool;
+    vec3i LastEvictionP; // Player chunk that the chunks were last evicted around
+
+    // NOTE(boti): The final chunks outside of the mesh window only get read again when the player walks back towards them,
+    //             so their data gets compressed a few at a time each frame (see CompressChunkData),
+    //             and decompressed when something needs the voxels again
+    static constexpr u32 ColdChunkVisitsPerFrame = 1024;
+    static constexpr u32 ColdChunkCompressionsPerFrame = 64;
+    struct
+    {
+        u32 Cursor; // Next chunk data pool slot to look at
+        u32 ChunkCount;
+        u64 DenseSize;
+        u64 CompressedSize;
+        u32 DecompressCount;
+        f32 TotalDecompressTime;
+        f32 MaxDecompressTime;
+    } ColdChunks;
 
     chunk_work_queue ChunkWorkQueue;
 
-    static constexpr u32 MaxChunkDeletionQueueCount = 8192;
+    static constexpr u32 MaxChunkDeletionQueueCount = 65536;
     u32 ChunkDeletionWriteIndex;
     u32 ChunkDeletionReadIndex;
     vertex_buffer_block* ChunkDeletionQueue[MaxChunkDeletionQueueCount];
@@ -143,6 +184,11 @@ struct world
         bool IsHitboxEnabled;
         bool IsDebugCameraEnabled;
         camera DebugCamera;
+
+        // NOTE(boti): Jumps the player a whole generation window ahead whenever the chunk works are at the cap,
+        //             so that the player chunk has to be waited for while nothing around it can be queued
+        bool IsTeleportStressEnabled;
+        u32 StressTeleportCount;
     } Debug;
 
     map_view MapView;
@@ -151,7 +197,7 @@ struct world
 static chunk_work* GetNextChunkWorkToWrite(chunk_work_queue* Queue);
 
 // From chunk position
-chunk* GetChunkFromP(world* World, vec2i P);
+chunk* GetChunkFromP(world* World, vec3i P);
 // From voxel position
 chunk* GetChunkFromP(world* World, vec3i P, vec3i* RelP);
 u16 GetVoxelTypeAt(world* World, vec3i P);
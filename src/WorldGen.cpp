@@ -0,0 +1,1653 @@
+#include "WorldGen.hpp"
+
+static bool InitializeWorldGenerator(world_generator* Generator, u32 Seed, buffer GraphSource, memory_arena* Arena, u32* GraphErrorLine /*= nullptr*/)
+{
+    bool Result = true;
+
+    Generator->Seed = Seed;
+    Perlin2_Init(&Generator->Perlin2, Seed);
+    Perlin3_Init(&Generator->Perlin3, Seed);
+    HashNoise_Init(&Generator->HashNoise, Seed);
+    Simplex3_Init(&Generator->Simplex3, Seed);
+    Generator->NoiseType = Noise_Perlin;
+    Generator->DensityNoiseType = Noise_Perlin;
+    Generator->DensityLatticeSpacing = 1;
+
+    if (GraphSource.Size)
+    {
+        Result = CompileNoiseGraph(&Generator->Graph, GraphSource, GraphErrorLine);
+    }
+    if (!GraphSource.Size || !Result)
+    {
+        CompileDefaultNoiseGraph(&Generator->Graph);
+    }
+
+    Generator->CaveCache = PushStruct<cave_region_cache>(Arena);
+    if (Generator->CaveCache)
+    {
+        memset(Generator->CaveCache, 0, sizeof(cave_region_cache));
+    }
+    Generator->ColumnCache = PushStruct<column_heightmap_cache>(Arena);
+    if (Generator->ColumnCache)
+    {
+        memset(Generator->ColumnCache, 0, sizeof(column_heightmap_cache));
+    }
+
+    Generator->StructureCount = 1;
+    Generator->Structures = PushArray<world_structure>(Arena, Generator->StructureCount);
+    if (Generator->Structures)
+    {
+        world_structure* Tree = Generator->TreeStructure = Generator->Structures + 0;
+        
+        constexpr u16 O = VOXEL_INVALID;
+        constexpr u16 T = VOXEL_TREE_TRUNK;
+        constexpr u16 L = VOXEL_LEAVES;
+
+        constexpr s32 DIM_Z = 6;
+        constexpr s32 DIM_Y = 5;
+        constexpr s32 DIM_X = 5;
+
+        u16 Voxels[DIM_Z][DIM_Y][DIM_X] = 
+        {
+            {
+                { O, O, O, O, O, },
+                { O, O, O, O, O, },
+                { O, O, T, O, O, },
+                { O, O, O, O, O, },
+                { O, O, O, O, O, },
+            },
+            {
+                { O, O, O, O, O, },
+                { O, O, O, O, O, },
+                { O, O, T, O, O, },
+                { O, O, O, O, O, },
+                { O, O, O, O, O, },
+            },
+            {
+                { L, L, L, L, L, },
+                { L, L, L, L, L, },
+                { L, L, T, L, L, },
+                { L, L, L, L, L, },
+                { L, L, L, L, L, },
+            },
+            {
+                { L, L, L, L, L, },
+                { L, L, L, L, L, },
+                { L, L, T, L, L, },
+                { L, L, L, L, L, },
+                { L, L, L, L, L, },
+            },
+            {
+                { O, L, L, L, O, },
+                { L, L, L, L, L, },
+                { L, L, T, L, L, },
+                { L, L, L, L, L, },
+                { O, L, L, L, O, },
+            },
+            {
+                { O, O, O, O, O, },
+                { O, L, L, L, O, },
+                { O, L, L, L, O, },
+                { O, L, L, L, O, },
+                { O, O, O, O, O, },
+            },
+        };
+
+        Tree->Voxels = PushArray<u16>(Arena, DIM_Z*DIM_Y*DIM_X);
+        if (Tree->Voxels)
+        {
+            Tree->Extent = vec3i{ DIM_X, DIM_Y, DIM_Z };
+            memcpy(Tree->Voxels, Voxels, sizeof(Voxels));
+        }
+    }
+
+    return(Result);
+}
+
+//
+// Noise graph evaluation
+//
+// NOTE(boti): Noise ops with the default persistence/lacunarity and at most MaxSpecializedOctaveCount octaves
+//             are dispatched to the compile-time specialized octave noise, everything else goes through the runtime loops.
+//             Both produce the exact same bits. The 2D ops go through the noise kernels, which do the same dispatch.
+static u32 GetSpecializedOctaveCount(const noise_op* Op)
+{
+    u32 Result = GetSpecializedOctaveCount(Op->OctaveCount, Op->Persistence, Op->Lacunarity);
+    return(Result);
+}
+
+template<typename noise_t>
+static f32 SampleOctaveOp(const noise_t* Noise, const noise_op* Op, vec2 P)
+{
+    f32 Result;
+    switch (GetSpecializedOctaveCount(Op))
+    {
+        case 1: Result = SampleOctave<1>(Noise, P); break;
+        case 2: Result = SampleOctave<2>(Noise, P); break;
+        case 3: Result = SampleOctave<3>(Noise, P); break;
+        case 4: Result = SampleOctave<4>(Noise, P); break;
+        case 5: Result = SampleOctave<5>(Noise, P); break;
+        case 6: Result = SampleOctave<6>(Noise, P); break;
+        case 7: Result = SampleOctave<7>(Noise, P); break;
+        case 8: Result = SampleOctave<8>(Noise, P); break;
+        default: Result = SampleOctave(Noise, P, Op->OctaveCount, Op->Persistence, Op->Lacunarity); break;
+    }
+    return(Result);
+}
+
+template<typename noise_t>
+static f32 OctaveNoiseOp(const noise_t* Noise, const noise_op* Op, vec3 P)
+{
+    f32 Result;
+    switch (GetSpecializedOctaveCount(Op))
+    {
+        case 1: Result = OctaveNoise<1>(Noise, P); break;
+        case 2: Result = OctaveNoise<2>(Noise, P); break;
+        case 3: Result = OctaveNoise<3>(Noise, P); break;
+        case 4: Result = OctaveNoise<4>(Noise, P); break;
+        case 5: Result = OctaveNoise<5>(Noise, P); break;
+        case 6: Result = OctaveNoise<6>(Noise, P); break;
+        case 7: Result = OctaveNoise<7>(Noise, P); break;
+        case 8: Result = OctaveNoise<8>(Noise, P); break;
+        default: Result = OctaveNoise(Noise, P, Op->OctaveCount, Op->Persistence, Op->Lacunarity); break;
+    }
+    return(Result);
+}
+
+template<typename noise_t>
+TARGET_AVX2 static __m256 OctaveNoiseOp8(const noise_t* Noise, const noise_op* Op, __m256 X, __m256 Y, __m256 Z)
+{
+    __m256 Result;
+    switch (GetSpecializedOctaveCount(Op))
+    {
+        case 1: Result = OctaveNoise8<1>(Noise, X, Y, Z); break;
+        case 2: Result = OctaveNoise8<2>(Noise, X, Y, Z); break;
+        case 3: Result = OctaveNoise8<3>(Noise, X, Y, Z); break;
+        case 4: Result = OctaveNoise8<4>(Noise, X, Y, Z); break;
+        case 5: Result = OctaveNoise8<5>(Noise, X, Y, Z); break;
+        case 6: Result = OctaveNoise8<6>(Noise, X, Y, Z); break;
+        case 7: Result = OctaveNoise8<7>(Noise, X, Y, Z); break;
+        case 8: Result = OctaveNoise8<8>(Noise, X, Y, Z); break;
+        default: Result = OctaveNoise8(Noise, X, Y, Z, Op->OctaveCount, Op->Persistence, Op->Lacunarity); break;
+    }
+    return(Result);
+}
+
+static f32 SampleNoiseOp(const world_generator* Generator, const noise_op* Op, vec2 P)
+{
+    assert(Generator->NoiseType != Noise_Simplex);
+    P = Op->Value * P;
+    f32 Result = (Generator->NoiseType == Noise_Hash) ?
+        SampleOctaveOp(&Generator->HashNoise, Op, P) :
+        SampleOctaveOp(&Generator->Perlin2, Op, P);
+    return Result;
+}
+
+// NOTE(boti): 3D ops of the density fields, the scalar one is what the generator uses below AVX2
+static f32 SampleNoiseOp(const world_generator* Generator, const noise_op* Op, vec3 P)
+{
+    P = Op->Value * P;
+    f32 Result;
+    switch (Generator->DensityNoiseType)
+    {
+        case Noise_Perlin:  Result = OctaveNoiseOp(&Generator->Perlin3, Op, P); break;
+        case Noise_Hash:    Result = OctaveNoiseOp(&Generator->HashNoise, Op, P); break;
+        case Noise_Simplex: Result = OctaveNoiseOp(&Generator->Simplex3, Op, P); break;
+        default:
+        {
+            assert(!"Invalid code path");
+            Result = 0.0f;
+        } break;
+    }
+    return Result;
+}
+
+TARGET_AVX2 static __m256 SampleNoiseOp8(const world_generator* Generator, const noise_op* Op, __m256 X, __m256 Y, __m256 Z)
+{
+    __m256 Frequency = _mm256_set1_ps(Op->Value);
+    X = _mm256_mul_ps(Frequency, X);
+    Y = _mm256_mul_ps(Frequency, Y);
+    Z = _mm256_mul_ps(Frequency, Z);
+    __m256 Result;
+    switch (Generator->DensityNoiseType)
+    {
+        case Noise_Perlin:  Result = OctaveNoiseOp8(&Generator->Perlin3, Op, X, Y, Z); break;
+        case Noise_Hash:    Result = OctaveNoiseOp8(&Generator->HashNoise, Op, X, Y, Z); break;
+        case Noise_Simplex: Result = OctaveNoiseOp8(&Generator->Simplex3, Op, X, Y, Z); break;
+        default:
+        {
+            assert(!"Invalid code path");
+            Result = _mm256_setzero_ps();
+        } break;
+    }
+    return Result;
+}
+
+// NOTE(boti): The 8-wide ops mirror the scalar ones exactly (no FMA, same operation order),
+//             so that the heightmap pass agrees with GetTerrainHeight
+static f32 ApplyNoiseOp(const noise_op* Op, f32 Value)
+{
+    f32 Result = Value;
+    switch (Op->Type)
+    {
+        case NoiseOp_Add:       Result = Value + Op->Value; break;
+        case NoiseOp_Mul:       Result = Op->Value * Value; break;
+        case NoiseOp_Square:    Result = Value * Value; break;
+        case NoiseOp_Fade3:     Result = Fade3(Value); break;
+        case NoiseOp_Round:     Result = Round(Value); break;
+        default: assert(!"Invalid code path"); break;
+    }
+    return Result;
+}
+
+TARGET_AVX2 static __m256 ApplyNoiseOp8(const noise_op* Op, __m256 Value)
+{
+    __m256 Result = Value;
+    switch (Op->Type)
+    {
+        case NoiseOp_Add:       Result = _mm256_add_ps(Value, _mm256_set1_ps(Op->Value)); break;
+        case NoiseOp_Mul:       Result = _mm256_mul_ps(_mm256_set1_ps(Op->Value), Value); break;
+        case NoiseOp_Square:    Result = _mm256_mul_ps(Value, Value); break;
+        case NoiseOp_Fade3:
+        {
+            __m256 t = Value;
+            Result = _mm256_mul_ps(_mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(3.0f), _mm256_mul_ps(_mm256_set1_ps(2.0f), t)), t), t);
+        } break;
+        case NoiseOp_Round:
+        {
+            // NOTE(boti): Round() rounds halfway cases away from zero, which _mm256_round_ps can't do directly
+            __m256 Truncated = _mm256_round_ps(Value, _MM_FROUND_TO_ZERO|_MM_FROUND_NO_EXC);
+            __m256 Fraction = _mm256_sub_ps(Value, Truncated);
+            __m256 AbsFraction = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), Fraction);
+            __m256 RoundUp = _mm256_cmp_ps(AbsFraction, _mm256_set1_ps(0.5f), _CMP_GE_OQ);
+            __m256 Step = _mm256_or_ps(_mm256_set1_ps(1.0f), _mm256_and_ps(Value, _mm256_set1_ps(-0.0f)));
+            Result = _mm256_add_ps(Truncated, _mm256_and_ps(RoundUp, Step));
+        } break;
+        default: assert(!"Invalid code path"); break;
+    }
+    return Result;
+}
+
+// NOTE(boti): BiomeScale/BiomeOffset are the blended biome parameters of the column, only the height program uses them
+static f32 EvaluateNoiseProgram(const world_generator* Generator, const noise_program* Program, vec2 P,
+                                f32 BiomeScale = 1.0f, f32 BiomeOffset = 0.0f)
+{
+    f32 Result = 0.0f;
+    for (u32 OpIndex = 0; OpIndex < Program->OpCount; OpIndex++)
+    {
+        const noise_op* Op = Program->Ops + OpIndex;
+        if (Op->Type == NoiseOp_Noise)
+        {
+            Result = (OpIndex == 0) ? SampleNoiseOp(Generator, Op, P) : Result + SampleNoiseOp(Generator, Op, P);
+        }
+        else if (Op->Type == NoiseOp_Biome)
+        {
+            Result = BiomeScale * Result + BiomeOffset;
+        }
+        else
+        {
+            Result = ApplyNoiseOp(Op, Result);
+        }
+    }
+    return Result;
+}
+
+// NOTE(boti): Evaluates a 2D program at Count independent points, the noise is sampled by the SIMD kernels.
+//             Same bits as EvaluateNoiseProgram at each point, null BiomeScale/BiomeOffset are the same as 1 and 0.
+constexpr u32 MaxNoiseBatchCount = CHUNK_DIM_XY * CHUNK_DIM_XY;
+
+static void EvaluateNoiseProgram(const world_generator* Generator, const noise_program* Program, u32 Count, const f32* X, const f32* Y,
+                                 const f32* BiomeScale, const f32* BiomeOffset, f32* Out)
+{
+    assert(Count <= MaxNoiseBatchCount);
+    assert(Generator->NoiseType != Noise_Simplex);
+
+    f32 ScaledX[MaxNoiseBatchCount];
+    f32 ScaledY[MaxNoiseBatchCount];
+    f32 Samples[MaxNoiseBatchCount];
+
+    for (u32 i = 0; i < Count; i++)
+    {
+        Out[i] = 0.0f;
+    }
+
+    for (u32 OpIndex = 0; OpIndex < Program->OpCount; OpIndex++)
+    {
+        const noise_op* Op = Program->Ops + OpIndex;
+        if (Op->Type == NoiseOp_Noise)
+        {
+            for (u32 i = 0; i < Count; i++)
+            {
+                ScaledX[i] = Op->Value * X[i];
+                ScaledY[i] = Op->Value * Y[i];
+            }
+
+            if (Generator->NoiseType == Noise_Hash)
+            {
+                SampleOctave(&Generator->HashNoise, Count, ScaledX, ScaledY, Op->OctaveCount, Op->Persistence, Op->Lacunarity, Samples);
+            }
+            else
+            {
+                SampleOctave(&Generator->Perlin2, Count, ScaledX, ScaledY, Op->OctaveCount, Op->Persistence, Op->Lacunarity, Samples);
+            }
+
+            for (u32 i = 0; i < Count; i++)
+            {
+                Out[i] = (OpIndex == 0) ? Samples[i] : Out[i] + Samples[i];
+            }
+        }
+        else if (Op->Type == NoiseOp_Biome)
+        {
+            for (u32 i = 0; i < Count; i++)
+            {
+                f32 Scale = BiomeScale ? BiomeScale[i] : 1.0f;
+                f32 Offset = BiomeOffset ? BiomeOffset[i] : 0.0f;
+                Out[i] = Scale * Out[i] + Offset;
+            }
+        }
+        else
+        {
+            for (u32 i = 0; i < Count; i++)
+            {
+                Out[i] = ApplyNoiseOp(Op, Out[i]);
+            }
+        }
+    }
+}
+
+static f32 EvaluateNoiseProgram(const world_generator* Generator, const noise_program* Program, vec3 P)
+{
+    f32 Result = 0.0f;
+    for (u32 OpIndex = 0; OpIndex < Program->OpCount; OpIndex++)
+    {
+        const noise_op* Op = Program->Ops + OpIndex;
+        if (Op->Type == NoiseOp_Noise)
+        {
+            f32 Sample = SampleNoiseOp(Generator, Op, P);
+            Result = (OpIndex == 0) ? Sample : Result + Sample;
+        }
+        else
+        {
+            Result = ApplyNoiseOp(Op, Result);
+        }
+    }
+    return Result;
+}
+
+TARGET_AVX2 static __m256 EvaluateNoiseProgram8(const world_generator* Generator, const noise_program* Program, __m256 X, __m256 Y, __m256 Z)
+{
+    __m256 Result = _mm256_setzero_ps();
+    for (u32 OpIndex = 0; OpIndex < Program->OpCount; OpIndex++)
+    {
+        const noise_op* Op = Program->Ops + OpIndex;
+        if (Op->Type == NoiseOp_Noise)
+        {
+            __m256 Sample = SampleNoiseOp8(Generator, Op, X, Y, Z);
+            Result = (OpIndex == 0) ? Sample : _mm256_add_ps(Result, Sample);
+        }
+        else
+        {
+            Result = ApplyNoiseOp8(Op, Result);
+        }
+    }
+    return Result;
+}
+
+//
+// Biomes
+//
+// NOTE(boti): The climate programs are only evaluated on the grid of BIOME_CELL_DIM columns.
+//             At each grid point the biomes get blended by their distance in climate space, then the blend is
+//             bilinearly upsampled to the columns, and each column picks the biome nearest to its (interpolated) climate.
+//             The chunk path and the single column queries go through the same scalar blending and interpolation,
+//             so they agree exactly.
+struct biome_blend
+{
+    f32 Temperature;
+    f32 Humidity;
+    f32 HeightScale;
+    f32 HeightOffset;
+};
+
+static biome_blend BlendBiomes(const noise_graph* Graph, f32 Temperature, f32 Humidity)
+{
+    assert(Graph->BiomeCount > 0);
+
+    biome_blend Result = { Temperature, Humidity, 0.0f, 0.0f };
+    f32 WeightSum = 0.0f;
+    for (u32 BiomeIndex = 0; BiomeIndex < Graph->BiomeCount; BiomeIndex++)
+    {
+        const noise_biome* Biome = Graph->Biomes + BiomeIndex;
+        f32 dT = Temperature - Biome->Temperature;
+        f32 dH = Humidity - Biome->Humidity;
+
+        // NOTE(boti): Inverse distance weighting (to the 4th power), so that biomes stay close to pure around their centers
+        //             and only blend near the borders
+        f32 DistanceSq = dT * dT + dH * dH + 1e-4f;
+        f32 Weight = 1.0f / (DistanceSq * DistanceSq);
+        WeightSum += Weight;
+        Result.HeightScale += Weight * Biome->HeightScale;
+        Result.HeightOffset += Weight * Biome->HeightOffset;
+    }
+    Result.HeightScale /= WeightSum;
+    Result.HeightOffset /= WeightSum;
+    return(Result);
+}
+
+static biome_blend LerpBiomeBlend(const biome_blend& A, const biome_blend& B, f32 t)
+{
+    biome_blend Result = 
+    {
+        Lerp(A.Temperature, B.Temperature, t),
+        Lerp(A.Humidity, B.Humidity, t),
+        Lerp(A.HeightScale, B.HeightScale, t),
+        Lerp(A.HeightOffset, B.HeightOffset, t),
+    };
+    return(Result);
+}
+
+static u8 FindNearestBiome(const noise_graph* Graph, f32 Temperature, f32 Humidity)
+{
+    static_assert(noise_graph::MaxBiomeCount <= 256);
+
+    u8 Result = 0;
+    f32 MinDistanceSq = 0.0f;
+    for (u32 BiomeIndex = 0; BiomeIndex < Graph->BiomeCount; BiomeIndex++)
+    {
+        f32 dT = Temperature - Graph->Biomes[BiomeIndex].Temperature;
+        f32 dH = Humidity - Graph->Biomes[BiomeIndex].Humidity;
+        f32 DistanceSq = dT * dT + dH * dH;
+        if ((BiomeIndex == 0) || (DistanceSq < MinDistanceSq))
+        {
+            MinDistanceSq = DistanceSq;
+            Result = (u8)BiomeIndex;
+        }
+    }
+    return(Result);
+}
+
+// Biome blend of a single column, this samples the climate at the 4 surrounding grid points
+static biome_blend GetBiomeBlend(const world_generator* Generator, vec2i P)
+{
+    const noise_graph* Graph = &Generator->Graph;
+
+    vec2i CellP = { FloorDiv(P.x, BIOME_CELL_DIM) * BIOME_CELL_DIM, FloorDiv(P.y, BIOME_CELL_DIM) * BIOME_CELL_DIM };
+    biome_blend Corners[2][2];
+    for (s32 y = 0; y < 2; y++)
+    {
+        for (s32 x = 0; x < 2; x++)
+        {
+            vec2 CornerP = { (f32)(CellP.x + x * BIOME_CELL_DIM), (f32)(CellP.y + y * BIOME_CELL_DIM) };
+            Corners[y][x] = BlendBiomes(Graph,
+                                        EvaluateNoiseProgram(Generator, &Graph->Temperature, CornerP),
+                                        EvaluateNoiseProgram(Generator, &Graph->Humidity, CornerP));
+        }
+    }
+
+    constexpr f32 InvCellDim = 1.0f / (f32)BIOME_CELL_DIM;
+    f32 tx = (f32)(P.x - CellP.x) * InvCellDim;
+    f32 ty = (f32)(P.y - CellP.y) * InvCellDim;
+    biome_blend Result = LerpBiomeBlend(LerpBiomeBlend(Corners[0][0], Corners[0][1], tx), 
+                                        LerpBiomeBlend(Corners[1][0], Corners[1][1], tx), ty);
+    return(Result);
+}
+
+// NOTE(boti): Height parameters of every column of a chunk, the biome indices go straight into the chunk
+struct biome_map
+{
+    f32 HeightScale[CHUNK_DIM_XY][CHUNK_DIM_XY];
+    f32 HeightOffset[CHUNK_DIM_XY][CHUNK_DIM_XY];
+};
+
+static void SampleBiomeMap(biome_map* Map, chunk* Chunk, const world_generator* Generator)
+{
+    TIMED_FUNCTION();
+
+    const noise_graph* Graph = &Generator->Graph;
+
+    // NOTE(boti): The grid includes the far edge too, so every column has 4 grid points to interpolate from
+    constexpr u32 CountXY = CHUNK_DIM_XY / BIOME_CELL_DIM + 1;
+    constexpr u32 PointCount = CountXY * CountXY;
+
+    f32 X[PointCount];
+    f32 Y[PointCount];
+    for (u32 Index = 0; Index < PointCount; Index++)
+    {
+        X[Index] = (f32)((Index % CountXY) * BIOME_CELL_DIM) + (f32)Chunk->P.x;
+        Y[Index] = (f32)((Index / CountXY) * BIOME_CELL_DIM) + (f32)Chunk->P.y;
+    }
+
+    f32 Temperatures[PointCount];
+    f32 Humidities[PointCount];
+    EvaluateNoiseProgram(Generator, &Graph->Temperature, PointCount, X, Y, nullptr, nullptr, Temperatures);
+    EvaluateNoiseProgram(Generator, &Graph->Humidity, PointCount, X, Y, nullptr, nullptr, Humidities);
+
+    biome_blend Grid[CountXY][CountXY];
+    for (u32 Index = 0; Index < PointCount; Index++)
+    {
+        Grid[Index / CountXY][Index % CountXY] = BlendBiomes(Graph, Temperatures[Index], Humidities[Index]);
+    }
+
+    constexpr f32 InvCellDim = 1.0f / (f32)BIOME_CELL_DIM;
+    for (u32 y = 0; y < CHUNK_DIM_XY; y++)
+    {
+        u32 GridY = y / BIOME_CELL_DIM;
+        f32 ty = (f32)(y % BIOME_CELL_DIM) * InvCellDim;
+        for (u32 x = 0; x < CHUNK_DIM_XY; x++)
+        {
+            u32 GridX = x / BIOME_CELL_DIM;
+            f32 tx = (f32)(x % BIOME_CELL_DIM) * InvCellDim;
+            biome_blend Blend = LerpBiomeBlend(LerpBiomeBlend(Grid[GridY][GridX], Grid[GridY][GridX + 1], tx),
+                                               LerpBiomeBlend(Grid[GridY + 1][GridX], Grid[GridY + 1][GridX + 1], tx), ty);
+            Map->HeightScale[y][x] = Blend.HeightScale;
+            Map->HeightOffset[y][x] = Blend.HeightOffset;
+            Chunk->Biomes[y][x] = FindNearestBiome(Graph, Blend.Temperature, Blend.Humidity);
+        }
+    }
+}
+
+s32 GetTerrainHeight(const world_generator* Generator, vec2i P)
+{
+    const noise_graph* Graph = &Generator->Graph;
+    biome_blend Blend = { 0.0f, 0.0f, 1.0f, 0.0f };
+    if (Graph->BiomeCount)
+    {
+        Blend = GetBiomeBlend(Generator, P);
+    }
+
+    f32 Height = EvaluateNoiseProgram(Generator, &Graph->Height, vec2{ (f32)P.x, (f32)P.y }, Blend.HeightScale, Blend.HeightOffset);
+    s32 Result = (s32)Height;
+    return Result;
+}
+
+u32 GetBiome(const world_generator* Generator, vec2i P)
+{
+    u32 Result = 0;
+    if (Generator->Graph.BiomeCount)
+    {
+        biome_blend Blend = GetBiomeBlend(Generator, P);
+        Result = FindNearestBiome(&Generator->Graph, Blend.Temperature, Blend.Humidity);
+    }
+    return(Result);
+}
+
+TARGET_AVX2 static __m256 GetRowX8(const chunk* Chunk, u32 Batch)
+{
+    __m256i x = _mm256_add_epi32(_mm256_set1_epi32(Batch * 8), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    __m256 Result = _mm256_add_ps(_mm256_cvtepi32_ps(x), _mm256_set1_ps((f32)Chunk->P.x));
+    return Result;
+}
+
+static void GenerateHeightmap(chunk* Chunk, const world_generator* Generator)
+{
+    TIMED_FUNCTION();
+
+    biome_map BiomeMap;
+    const bool HasBiomes = (Generator->Graph.BiomeCount > 0);
+    if (HasBiomes)
+    {
+        SampleBiomeMap(&BiomeMap, Chunk, Generator);
+    }
+    else
+    {
+        memset(Chunk->Biomes, 0, sizeof(Chunk->Biomes));
+    }
+
+    // NOTE(boti): Same column positions as the old 8-wide path, the heights are truncated like in GetTerrainHeight
+    constexpr u32 ColumnCount = CHUNK_DIM_XY * CHUNK_DIM_XY;
+    f32 X[ColumnCount];
+    f32 Y[ColumnCount];
+    for (u32 y = 0; y < CHUNK_DIM_XY; y++)
+    {
+        for (u32 x = 0; x < CHUNK_DIM_XY; x++)
+        {
+            X[y * CHUNK_DIM_XY + x] = (f32)x + (f32)Chunk->P.x;
+            Y[y * CHUNK_DIM_XY + x] = (f32)y + (f32)Chunk->P.y;
+        }
+    }
+
+    f32 Heights[ColumnCount];
+    EvaluateNoiseProgram(Generator, &Generator->Graph.Height, ColumnCount, X, Y,
+                         HasBiomes ? &BiomeMap.HeightScale[0][0] : nullptr,
+                         HasBiomes ? &BiomeMap.HeightOffset[0][0] : nullptr,
+                         Heights);
+
+    for (u32 y = 0; y < CHUNK_DIM_XY; y++)
+    {
+        for (u32 x = 0; x < CHUNK_DIM_XY; x++)
+        {
+            s32 Height = (s32)Heights[y * CHUNK_DIM_XY + x];
+            Chunk->Heightmap[y][x] = (s16)Min(Max(Height, -32768), 32767);
+        }
+    }
+}
+
+// Same as GenerateHeightmap, but only the first chunk of a column generates it when there's a column cache
+static void LoadColumnHeightmap(chunk* Chunk, const world_generator* Generator)
+{
+    column_heightmap_cache* Cache = Generator->ColumnCache;
+    if (Cache)
+    {
+        constexpr s32 CountSqrt = column_heightmap_cache::ColumnCountSqrt;
+        vec2i ColumnP = (vec2i)Chunk->P;
+        s32 CacheX = Modulo(FloorDiv(ColumnP.x, CHUNK_DIM_XY), CountSqrt);
+        s32 CacheY = Modulo(FloorDiv(ColumnP.y, CHUNK_DIM_XY), CountSqrt);
+        column_heightmap* Column = Cache->Columns + (CacheX + CacheY * CountSqrt);
+
+        BeginTicketMutex(&Column->Mutex);
+        if (!Column->IsValid || (Column->P != ColumnP) || (Column->Seed != Generator->Seed) || (Column->NoiseType != Generator->NoiseType))
+        {
+            GenerateHeightmap(Chunk, Generator);
+            Column->P = ColumnP;
+            Column->Seed = Generator->Seed;
+            Column->NoiseType = Generator->NoiseType;
+            memcpy(Column->Heightmap, Chunk->Heightmap, sizeof(Column->Heightmap));
+            memcpy(Column->Biomes, Chunk->Biomes, sizeof(Column->Biomes));
+            Column->IsValid = true;
+        }
+        else
+        {
+            memcpy(Chunk->Heightmap, Column->Heightmap, sizeof(Chunk->Heightmap));
+            memcpy(Chunk->Biomes, Column->Biomes, sizeof(Chunk->Biomes));
+        }
+        EndTicketMutex(&Column->Mutex);
+    }
+    else
+    {
+        GenerateHeightmap(Chunk, Generator);
+    }
+}
+
+// NOTE(boti): The fields of the noise graph sampled on the coarse lattice, already upsampled along x and y.
+//             Stored as [CountZ][CHUNK_DIM_XY][CHUNK_DIM_XY], the z interpolation is done when filling the voxel rows.
+struct density_lattice
+{
+    u32 Spacing;
+    u32 CountZ;
+    f32* Fields[noise_graph::MaxFieldCount];
+};
+
+// NOTE(boti): Lattice point Index of a CountXY * CountXY * (any) lattice of the chunk, in world space
+static vec3 GetLatticePoint(const chunk* Chunk, u32 Spacing, u32 CountXY, u32 Index)
+{
+    u32 x = (Index % CountXY) * Spacing;
+    u32 y = ((Index / CountXY) % CountXY) * Spacing;
+    u32 z = (Index / (CountXY * CountXY)) * Spacing;
+    vec3 Result = { (f32)x + (f32)Chunk->P.x, (f32)y + (f32)Chunk->P.y, (f32)((s32)z + Chunk->P.z) };
+    return(Result);
+}
+
+// NOTE(boti): The padding after PointCount (up to a multiple of 8) just samples the last point again
+TARGET_AVX2 static void SampleLatticePoints_AVX2(f32* const* Coarse, const chunk* Chunk, const world_generator* Gen,
+                                                 u32 Spacing, u32 CountXY, u32 PointCount)
+{
+    const noise_graph* Graph = &Gen->Graph;
+    for (u32 BaseIndex = 0; BaseIndex < PointCount; BaseIndex += 8)
+    {
+        alignas(32) f32 X[8];
+        alignas(32) f32 Y[8];
+        alignas(32) f32 Z[8];
+        for (u32 Lane = 0; Lane < 8; Lane++)
+        {
+            vec3 P = GetLatticePoint(Chunk, Spacing, CountXY, Min(BaseIndex + Lane, PointCount - 1));
+            X[Lane] = P.x;
+            Y[Lane] = P.y;
+            Z[Lane] = P.z;
+        }
+
+        __m256 X8 = _mm256_load_ps(X);
+        __m256 Y8 = _mm256_load_ps(Y);
+        __m256 Z8 = _mm256_load_ps(Z);
+        for (u32 FieldIndex = 0; FieldIndex < Graph->FieldCount; FieldIndex++)
+        {
+            _mm256_storeu_ps(Coarse[FieldIndex] + BaseIndex, EvaluateNoiseProgram8(Gen, Graph->Fields + FieldIndex, X8, Y8, Z8));
+        }
+    }
+}
+
+static void SampleLatticePoints(f32* const* Coarse, const chunk* Chunk, const world_generator* Gen,
+                                u32 Spacing, u32 CountXY, u32 PointCount)
+{
+    const noise_graph* Graph = &Gen->Graph;
+    for (u32 Index = 0; Index < PointCount; Index++)
+    {
+        vec3 P = GetLatticePoint(Chunk, Spacing, CountXY, Index);
+        for (u32 FieldIndex = 0; FieldIndex < Graph->FieldCount; FieldIndex++)
+        {
+            Coarse[FieldIndex][Index] = EvaluateNoiseProgram(Gen, Graph->Fields + FieldIndex, P);
+        }
+    }
+}
+
+// NOTE(boti): Only the part of the lattice needed to cover [0, MaxZ] (relative to the chunk) gets sampled
+static bool SampleDensityLattice(density_lattice* Lattice, const chunk* Chunk, const world_generator* Gen, u32 MaxZ, memory_arena* Arena)
+{
+    TIMED_FUNCTION();
+
+    bool Result = false;
+
+    const u32 Spacing = Gen->DensityLatticeSpacing;
+    assert((Spacing > 1) && (Spacing <= CHUNK_DIM_XY) && ((Spacing & (Spacing - 1)) == 0));
+
+    // NOTE(boti): The lattice includes the far edge too, so that every voxel has 8 corners to interpolate from
+    const u32 CountXY = CHUNK_DIM_XY / Spacing + 1;
+    const u32 CountZ = MaxZ / Spacing + 2;
+    const u32 PointCount = CountXY * CountXY * CountZ;
+    const u32 PaddedPointCount = (u32)AlignToPow2(PointCount, 8);
+
+    const noise_graph* Graph = &Gen->Graph;
+
+    bool IsAllocationSuccessful = true;
+    f32* Coarse[noise_graph::MaxFieldCount] = {};
+    Lattice->Spacing = Spacing;
+    Lattice->CountZ = CountZ;
+    for (u32 FieldIndex = 0; FieldIndex < Graph->FieldCount; FieldIndex++)
+    {
+        Coarse[FieldIndex] = PushArray<f32>(Arena, PaddedPointCount);
+        Lattice->Fields[FieldIndex] = PushArray<f32>(Arena, CountZ * CHUNK_DIM_XY * CHUNK_DIM_XY);
+        IsAllocationSuccessful = IsAllocationSuccessful && Coarse[FieldIndex] && Lattice->Fields[FieldIndex];
+    }
+
+    if (IsAllocationSuccessful)
+    {
+        if (Kernels->Level >= CPULevel_AVX2)
+        {
+            SampleLatticePoints_AVX2(Coarse, Chunk, Gen, Spacing, CountXY, PointCount);
+        }
+        else
+        {
+            SampleLatticePoints(Coarse, Chunk, Gen, Spacing, CountXY, PointCount);
+        }
+
+        // Upsample along x and y
+        const f32 InvSpacing = 1.0f / (f32)Spacing;
+        for (u32 FieldIndex = 0; FieldIndex < Graph->FieldCount; FieldIndex++)
+        {
+            const f32* CoarseField = Coarse[FieldIndex];
+            f32* Fine = Lattice->Fields[FieldIndex];
+
+            for (u32 LatticeZ = 0; LatticeZ < CountZ; LatticeZ++)
+            {
+                f32 Rows[CHUNK_DIM_XY + 1][CHUNK_DIM_XY];
+                for (u32 LatticeY = 0; LatticeY < CountXY; LatticeY++)
+                {
+                    const f32* CoarseRow = CoarseField + (LatticeZ * CountXY + LatticeY) * CountXY;
+                    for (u32 x = 0; x < CHUNK_DIM_XY; x++)
+                    {
+                        u32 LatticeX = x / Spacing;
+                        f32 t = (f32)(x % Spacing) * InvSpacing;
+                        Rows[LatticeY][x] = Lerp(CoarseRow[LatticeX], CoarseRow[LatticeX + 1], t);
+                    }
+                }
+
+                for (u32 y = 0; y < CHUNK_DIM_XY; y++)
+                {
+                    u32 LatticeY = y / Spacing;
+                    f32 t = (f32)(y % Spacing) * InvSpacing;
+                    f32* FineRow = Fine + (LatticeZ * CHUNK_DIM_XY + y) * CHUNK_DIM_XY;
+                    for (u32 x = 0; x < CHUNK_DIM_XY; x++)
+                    {
+                        FineRow[x] = Lerp(Rows[LatticeY][x], Rows[LatticeY + 1][x], t);
+                    }
+                }
+            }
+        }
+
+        Result = true;
+    }
+
+    return(Result);
+}
+
+// NOTE(boti): The Level0 passes work on the unpacked voxels of the chunk plus the bottom layer of the chunk above it,
+//             which is needed to tell whether a tree has room to grow on top of the chunk.
+//             Only the chunk's own voxels get packed into its data at the end.
+constexpr s32 GENERATOR_DIM_Z = CHUNK_DIM_Z + 1;
+struct generator_voxels
+{
+    u16 Voxels[GENERATOR_DIM_Z][CHUNK_DIM_XY][CHUNK_DIM_XY];
+};
+
+//
+// Ore veins
+//
+// NOTE(boti): Instead of evaluating a noise field at every voxel, each column of chunks gets a short list of spherical veins
+//             derived from its position. Since the list doesn't depend on any generated data, a chunk can rasterize
+//             the veins of its neighbors that reach into it during Level0, without waiting for the neighbors.
+//             Every ore type draws from its own range of random indices, so changing one doesn't move the others.
+struct ore_vein
+{
+    vec3 P; // Relative to the column the vein belongs to (z is in world space)
+    f32 Radius;
+    u16 Type;
+};
+
+constexpr u32 MaxOreVeinCountPerChunk = noise_graph::MaxOreCount * ((u32)noise_graph::MaxOreCountPerChunk + 1);
+
+static u32 GetOreVeins(const world_generator* Gen, vec2i ChunkP, ore_vein* Veins)
+{
+    const noise_graph* Graph = &Gen->Graph;
+
+    u32 Result = 0;
+    random_stream Stream = RandomStream(Gen->Seed, ChunkP, RandomPurpose_OreVeins);
+    for (u32 OreIndex = 0; OreIndex < Graph->OreCount; OreIndex++)
+    {
+        const noise_ore* Ore = Graph->Ores + OreIndex;
+        const u32 OreBaseIndex = OreIndex << 16;
+
+        // NOTE(boti): The fractional part of the count is the chance of an extra vein
+        u32 Count = (u32)Ore->CountPerChunk;
+        if (RandomUnilateral(&Stream, OreBaseIndex) < Ore->CountPerChunk - (f32)Count)
+        {
+            Count++;
+        }
+
+        for (u32 VeinIndex = 0; VeinIndex < Count; VeinIndex++)
+        {
+            assert(Result < MaxOreVeinCountPerChunk);
+            const u32 BaseIndex = OreBaseIndex + 1 + 4 * VeinIndex;
+            ore_vein* Vein = Veins + Result++;
+            Vein->P.x = RandomUnilateral(&Stream, BaseIndex + 0) * (f32)CHUNK_DIM_XY;
+            Vein->P.y = RandomUnilateral(&Stream, BaseIndex + 1) * (f32)CHUNK_DIM_XY;
+            Vein->P.z = (f32)Ore->MinZ + RandomUnilateral(&Stream, BaseIndex + 2) * (f32)(Ore->MaxZ - Ore->MinZ + 1);
+            Vein->Radius = Lerp(Ore->MinRadius, Ore->MaxRadius, RandomUnilateral(&Stream, BaseIndex + 3));
+            Vein->Type = Ore->Type;
+        }
+    }
+    return(Result);
+}
+
+// Turns the stone inside the veins of the 3x3 neighboring columns into ore
+static void PlaceOreVeins(const chunk* Chunk, generator_voxels* Voxels, const world_generator* Gen)
+{
+    TIMED_FUNCTION();
+
+    static_assert(noise_graph::MaxOreRadius <= (f32)CHUNK_DIM_XY);
+
+    for (s32 NeighborY = -1; NeighborY <= 1; NeighborY++)
+    {
+        for (s32 NeighborX = -1; NeighborX <= 1; NeighborX++)
+        {
+            vec2i Offset = vec2i{ NeighborX, NeighborY } * CHUNK_DIM_XY;
+
+            ore_vein Veins[MaxOreVeinCountPerChunk];
+            u32 VeinCount = GetOreVeins(Gen, (vec2i)Chunk->P + Offset, Veins);
+            for (u32 VeinIndex = 0; VeinIndex < VeinCount; VeinIndex++)
+            {
+                const ore_vein* Vein = Veins + VeinIndex;
+                vec3 P = Vein->P + vec3{ (f32)Offset.x, (f32)Offset.y, 0.0f };
+                f32 RadiusSq = Vein->Radius * Vein->Radius;
+
+                // Bounds of the voxels whose centers can be inside the vein, clipped to the chunk
+                vec3i BeginP = 
+                {
+                    Max((s32)Floor(P.x - Vein->Radius), 0),
+                    Max((s32)Floor(P.y - Vein->Radius), 0),
+                    Max((s32)Floor(P.z - Vein->Radius) - Chunk->P.z, 0),
+                };
+                vec3i EndP = 
+                {
+                    Min((s32)Floor(P.x + Vein->Radius) + 1, CHUNK_DIM_XY),
+                    Min((s32)Floor(P.y + Vein->Radius) + 1, CHUNK_DIM_XY),
+                    Min((s32)Floor(P.z + Vein->Radius) + 1 - Chunk->P.z, GENERATOR_DIM_Z),
+                };
+
+                for (s32 z = BeginP.z; z < EndP.z; z++)
+                {
+                    f32 dz = ((f32)(Chunk->P.z + z) + 0.5f) - P.z;
+                    for (s32 y = BeginP.y; y < EndP.y; y++)
+                    {
+                        f32 dy = ((f32)y + 0.5f) - P.y;
+                        for (s32 x = BeginP.x; x < EndP.x; x++)
+                        {
+                            f32 dx = ((f32)x + 0.5f) - P.x;
+                            u16* Voxel = &Voxels->Voxels[z][y][x];
+                            if ((dx*dx + dy*dy + dz*dz <= RadiusSq) && (*Voxel == VOXEL_STONE))
+                            {
+                                *Voxel = Vein->Type;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+//
+// Worm caves
+//
+// NOTE(boti): Every region of chunks traces a few random walks from the seed and its position, each step of a walk
+//             is a cave segment. A chunk collects the segments of the 3x3 regions around it that reach into it,
+//             and only carves those.
+
+// NOTE(boti): The 3 random numbers of step i are at StepBaseIndex + 3*i + [0, 3)
+TARGET_AVX2 static void DrawWormStepRandoms_AVX2(const random_stream* Stream, u32 StepBaseIndex, u32 SegmentCount, f32* StepRandoms[3])
+{
+    for (u32 SegmentIndex = 0; SegmentIndex < SegmentCount; SegmentIndex += 8)
+    {
+        for (u32 k = 0; k < 3; k++)
+        {
+            __m256i Index = _mm256_add_epi32(_mm256_set1_epi32((s32)(StepBaseIndex + 3 * SegmentIndex + k)),
+                                             _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21));
+            _mm256_store_ps(StepRandoms[k] + SegmentIndex, RandomUnilateral8(Stream, Index));
+        }
+    }
+}
+
+static void DrawWormStepRandoms(const random_stream* Stream, u32 StepBaseIndex, u32 SegmentCount, f32* StepRandoms[3])
+{
+    for (u32 SegmentIndex = 0; SegmentIndex < SegmentCount; SegmentIndex++)
+    {
+        for (u32 k = 0; k < 3; k++)
+        {
+            StepRandoms[k][SegmentIndex] = RandomUnilateral(Stream, StepBaseIndex + 3 * SegmentIndex + k);
+        }
+    }
+}
+
+static u32 TraceWorms(const world_generator* Gen, vec2i RegionP, cave_segment* Segments)
+{
+    TIMED_FUNCTION();
+
+    const noise_worms* Worms = &Gen->Graph.Worms;
+    constexpr f32 RegionDim = (f32)noise_graph::WormRegionDim;
+    constexpr f32 Step = noise_graph::WormStepLength;
+    const f32 MinZ = (f32)Worms->MinZ;
+    const f32 MaxZ = (f32)Worms->MaxZ;
+
+    // NOTE(boti): Only the walk itself is sequential, the random numbers of every step are drawn up front, 8 steps at a time
+    constexpr u32 MaxSegmentCountPerWorm = noise_graph::MaxWormSegmentCountPerRegion;
+    static_assert((MaxSegmentCountPerWorm % 8) == 0);
+    alignas(32) f32 StepRandoms[3][MaxSegmentCountPerWorm];
+    f32* StepRandomRows[3] = { StepRandoms[0], StepRandoms[1], StepRandoms[2] };
+
+    u32 Result = 0;
+    random_stream Stream = RandomStream(Gen->Seed, RegionP, RandomPurpose_WormCaves);
+    for (u32 WormIndex = 0; WormIndex < Worms->CountPerRegion; WormIndex++)
+    {
+        const u32 WormBaseIndex = WormIndex << 16;
+        const u32 StepBaseIndex = WormBaseIndex + 8;
+        if (Kernels->Level >= CPULevel_AVX2)
+        {
+            DrawWormStepRandoms_AVX2(&Stream, StepBaseIndex, Worms->SegmentCount, StepRandomRows);
+        }
+        else
+        {
+            DrawWormStepRandoms(&Stream, StepBaseIndex, Worms->SegmentCount, StepRandomRows);
+        }
+
+        vec3 P = 
+        {
+            ((f32)RegionP.x + RandomUnilateral(&Stream, WormBaseIndex + 0)) * RegionDim,
+            ((f32)RegionP.y + RandomUnilateral(&Stream, WormBaseIndex + 1)) * RegionDim,
+            Lerp(MinZ, MaxZ, RandomUnilateral(&Stream, WormBaseIndex + 2)),
+        };
+        f32 Radius = Lerp(Worms->MinRadius, Worms->MaxRadius, RandomUnilateral(&Stream, WormBaseIndex + 3));
+        f32 Yaw = 2.0f * PI * RandomUnilateral(&Stream, WormBaseIndex + 4);
+        f32 Pitch = 0.0f;
+
+        // NOTE(boti): The walk turns through its angular velocity instead of the angles directly, so the tunnels curve smoothly
+        f32 YawRate = 0.0f;
+        f32 PitchRate = 0.0f;
+        for (u32 SegmentIndex = 0; SegmentIndex < Worms->SegmentCount; SegmentIndex++)
+        {
+            YawRate = 0.75f * YawRate + 0.4f * (StepRandoms[0][SegmentIndex] - 0.5f);
+            PitchRate = 0.75f * PitchRate + 0.2f * (StepRandoms[1][SegmentIndex] - 0.5f);
+            Yaw += YawRate;
+            Pitch = Clamp(0.9f * Pitch + PitchRate, -0.7f, 0.7f);
+
+            vec3 Direction = { Cos(Pitch) * Cos(Yaw), Cos(Pitch) * Sin(Yaw), Sin(Pitch) };
+            vec3 NextP = P + Step * Direction;
+            NextP.z = Clamp(NextP.z, MinZ, MaxZ);
+            f32 NextRadius = Clamp(Radius + 0.5f * (StepRandoms[2][SegmentIndex] - 0.5f), Worms->MinRadius, Worms->MaxRadius);
+
+            assert(Result < noise_graph::MaxWormSegmentCountPerRegion);
+            Segments[Result++] = { P, NextP, Radius, NextRadius };
+            P = NextP;
+            Radius = NextRadius;
+        }
+    }
+    return(Result);
+}
+
+// NOTE(boti): Includes the extra layer of voxels the generator fills above the chunk
+static bool DoesCaveSegmentReachChunk(const cave_segment* Segment, vec3i ChunkP)
+{
+    f32 Radius = Max(Segment->Radius0, Segment->Radius1);
+    bool Result = 
+        (Min(Segment->P0.x, Segment->P1.x) - Radius < (f32)(ChunkP.x + CHUNK_DIM_XY)) &&
+        (Max(Segment->P0.x, Segment->P1.x) + Radius > (f32)ChunkP.x) &&
+        (Min(Segment->P0.y, Segment->P1.y) - Radius < (f32)(ChunkP.y + CHUNK_DIM_XY)) &&
+        (Max(Segment->P0.y, Segment->P1.y) + Radius > (f32)ChunkP.y) &&
+        (Min(Segment->P0.z, Segment->P1.z) - Radius < (f32)(ChunkP.z + GENERATOR_DIM_Z)) &&
+        (Max(Segment->P0.z, Segment->P1.z) + Radius > (f32)ChunkP.z);
+    return(Result);
+}
+
+// Appends the segments of a region that reach into the chunk at ChunkP to Segments, returns the number of segments appended
+static u32 GatherCaveSegments(const world_generator* Gen, vec2i RegionP, vec3i ChunkP, cave_segment* Segments, memory_arena* Arena)
+{
+    u32 Result = 0;
+
+    cave_region_cache* Cache = Gen->CaveCache;
+    if (Cache)
+    {
+        constexpr s32 CountSqrt = cave_region_cache::RegionCountSqrt;
+        cave_region* Region = Cache->Regions + (Modulo(RegionP.x, CountSqrt) + Modulo(RegionP.y, CountSqrt) * CountSqrt);
+
+        BeginTicketMutex(&Region->Mutex);
+        if (!Region->IsValid || (Region->P != RegionP) || (Region->Seed != Gen->Seed) ||
+            (memcmp(&Region->Worms, &Gen->Graph.Worms, sizeof(noise_worms)) != 0))
+        {
+            Region->P = RegionP;
+            Region->Seed = Gen->Seed;
+            Region->Worms = Gen->Graph.Worms;
+            Region->SegmentCount = TraceWorms(Gen, RegionP, Region->Segments);
+            Region->IsValid = true;
+        }
+
+        for (u32 SegmentIndex = 0; SegmentIndex < Region->SegmentCount; SegmentIndex++)
+        {
+            if (DoesCaveSegmentReachChunk(Region->Segments + SegmentIndex, ChunkP))
+            {
+                Segments[Result++] = Region->Segments[SegmentIndex];
+            }
+        }
+        EndTicketMutex(&Region->Mutex);
+    }
+    else
+    {
+        memory_arena_checkpoint Checkpoint = ArenaCheckpoint(Arena);
+        cave_segment* RegionSegments = PushArray<cave_segment>(Arena, noise_graph::MaxWormSegmentCountPerRegion);
+        if (RegionSegments)
+        {
+            u32 RegionSegmentCount = TraceWorms(Gen, RegionP, RegionSegments);
+            for (u32 SegmentIndex = 0; SegmentIndex < RegionSegmentCount; SegmentIndex++)
+            {
+                if (DoesCaveSegmentReachChunk(RegionSegments + SegmentIndex, ChunkP))
+                {
+                    Segments[Result++] = RegionSegments[SegmentIndex];
+                }
+            }
+        }
+        RestoreArena(Arena, Checkpoint);
+    }
+
+    return(Result);
+}
+
+static void CarveWormCaves(const chunk* Chunk, generator_voxels* Voxels, const world_generator* Gen, memory_arena* Arena)
+{
+    TIMED_FUNCTION();
+
+    memory_arena_checkpoint Checkpoint = ArenaCheckpoint(Arena);
+
+    constexpr u32 MaxSegmentCount = 9 * noise_graph::MaxWormSegmentCountPerRegion;
+    cave_segment* Segments = PushArray<cave_segment>(Arena, MaxSegmentCount);
+    if (Segments)
+    {
+        u32 SegmentCount = 0;
+        vec2i ChunkRegionP = 
+        {
+            FloorDiv(Chunk->P.x, noise_graph::WormRegionDim),
+            FloorDiv(Chunk->P.y, noise_graph::WormRegionDim),
+        };
+        for (s32 RegionY = -1; RegionY <= 1; RegionY++)
+        {
+            for (s32 RegionX = -1; RegionX <= 1; RegionX++)
+            {
+                SegmentCount += GatherCaveSegments(Gen, ChunkRegionP + vec2i{ RegionX, RegionY }, Chunk->P, Segments + SegmentCount, Arena);
+            }
+        }
+
+        for (u32 SegmentIndex = 0; SegmentIndex < SegmentCount; SegmentIndex++)
+        {
+            const cave_segment* Segment = Segments + SegmentIndex;
+
+            // Relative to the column, z stays in world space so that the voxel centers are the same in every chunk
+            vec3 ChunkOffset = { (f32)Chunk->P.x, (f32)Chunk->P.y, 0.0f };
+            vec3 P0 = Segment->P0 - ChunkOffset;
+            vec3 P1 = Segment->P1 - ChunkOffset;
+            vec3 D = P1 - P0;
+            f32 InvLengthSq = 1.0f / Max(Dot(D, D), 1e-6f);
+            f32 Radius = Max(Segment->Radius0, Segment->Radius1);
+
+            vec3i BeginP = 
+            {
+                Max((s32)Floor(Min(P0.x, P1.x) - Radius), 0),
+                Max((s32)Floor(Min(P0.y, P1.y) - Radius), 0),
+                Max((s32)Floor(Min(P0.z, P1.z) - Radius) - Chunk->P.z, 0),
+            };
+            vec3i EndP = 
+            {
+                Min((s32)Floor(Max(P0.x, P1.x) + Radius) + 1, CHUNK_DIM_XY),
+                Min((s32)Floor(Max(P0.y, P1.y) + Radius) + 1, CHUNK_DIM_XY),
+                Min((s32)Floor(Max(P0.z, P1.z) + Radius) + 1 - Chunk->P.z, GENERATOR_DIM_Z),
+            };
+
+            for (s32 z = BeginP.z; z < EndP.z; z++)
+            {
+                for (s32 y = BeginP.y; y < EndP.y; y++)
+                {
+                    for (s32 x = BeginP.x; x < EndP.x; x++)
+                    {
+                        vec3 V = vec3{ (f32)x + 0.5f, (f32)y + 0.5f, (f32)(Chunk->P.z + z) + 0.5f } - P0;
+                        f32 t = Clamp(Dot(V, D) * InvLengthSq, 0.0f, 1.0f);
+                        f32 r = Lerp(Segment->Radius0, Segment->Radius1, t);
+                        vec3 Delta = V - t * D;
+                        if (Dot(Delta, Delta) <= r * r)
+                        {
+                            Voxels->Voxels[z][y][x] = VOXEL_AIR;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    RestoreArena(Arena, Checkpoint);
+}
+
+// Picks where the trees go in a chunk that's already been filled with terrain.
+// NOTE(boti): Every chunk of a column draws the same attempts, a tree belongs to the chunk that has the ground it grows on.
+static void PlaceStructures(chunk* Chunk, const generator_voxels* Voxels, const world_generator* Gen)
+{
+    TIMED_FUNCTION();
+
+    Chunk->StructurePlacementCount = 0;
+
+    const world_structure* Tree = Gen->TreeStructure;
+    if (!Tree || !Tree->Voxels)
+    {
+        return;
+    }
+    // NOTE(boti): Structures can only spill over into the immediate neighbors
+    assert((Tree->Extent.x / 2 < CHUNK_DIM_XY) && (Tree->Extent.y / 2 < CHUNK_DIM_XY) && (Tree->Extent.z <= CHUNK_DIM_Z));
+
+    const noise_graph* Graph = &Gen->Graph;
+    random_stream Stream = RandomStream(Gen->Seed, (vec2i)Chunk->P, RandomPurpose_Trees);
+
+    constexpr u32 MaxTreeAttemptCount = 3;
+    static_assert(MaxTreeAttemptCount <= chunk::MaxStructurePlacementCount);
+
+    // NOTE(boti): The spacing is resolved for the whole column, from what every chunk of it knows (the heightmap and the biomes),
+    //             so a tree keeps the others of the column away even if its own ground gets carved out in a different chunk
+    vec2i ColumnTrees[MaxTreeAttemptCount];
+    u32 ColumnTreeCount = 0;
+
+    u32 AttemptCount = RandomU32(&Stream, 0) % (MaxTreeAttemptCount + 1);
+    for (u32 Attempt = 0; Attempt < AttemptCount; Attempt++)
+    {
+        u32 Random = RandomU32(&Stream, 1 + Attempt);
+        s32 x = (s32)(Random % CHUNK_DIM_XY);
+        s32 y = (s32)((Random / CHUNK_DIM_XY) % CHUNK_DIM_XY);
+
+        u32 SurfaceType = (Graph->BiomeCount > 0) ? Graph->Biomes[Chunk->Biomes[y][x]].SurfaceType : Graph->LayerTypes[0];
+        if (SurfaceType != VOXEL_GROUND)
+        {
+            continue;
+        }
+
+        // Don't let the trunks grow into each other's leaves
+        bool IsTooClose = false;
+        for (u32 TreeIndex = 0; TreeIndex < ColumnTreeCount; TreeIndex++)
+        {
+            vec2i OtherP = ColumnTrees[TreeIndex];
+            if ((Abs(OtherP.x - x) <= Tree->Extent.x / 2) && (Abs(OtherP.y - y) <= Tree->Extent.y / 2))
+            {
+                IsTooClose = true;
+                break;
+            }
+        }
+        if (IsTooClose)
+        {
+            continue;
+        }
+        ColumnTrees[ColumnTreeCount++] = vec2i{ x, y };
+
+        // Trees only grow on (uncarved) ground
+        s32 z = Chunk->Heightmap[y][x] + 1 - Chunk->P.z;
+        if ((z < 1) || (z > CHUNK_DIM_Z) ||
+            (Voxels->Voxels[z - 1][y][x] != VOXEL_GROUND) ||
+            (Voxels->Voxels[z][y][x] != VOXEL_AIR))
+        {
+            continue;
+        }
+
+        structure_placement* Placement = Chunk->StructurePlacements + Chunk->StructurePlacementCount++;
+        Placement->StructureIndex = (u32)(Tree - Gen->Structures);
+        Placement->P = vec3i{ x, y, z };
+    }
+}
+
+// NOTE(boti): Fills the voxel rows of [0, MaxZ] from the heightmap and the rules,
+//             the fields come from the lattice if there's one, otherwise they're evaluated at every voxel
+TARGET_AVX2 static void GenerateRows_AVX2(generator_voxels* Voxels, const chunk* Chunk, const world_generator* Gen,
+                                          const density_lattice* Lattice, u32 MaxZ)
+{
+    const noise_graph* Graph = &Gen->Graph;
+    const bool UseLattice = (Lattice != nullptr);
+    const f32 InvLatticeSpacing = UseLattice ? 1.0f / (f32)Lattice->Spacing : 0.0f;
+
+    // NOTE(boti): Voxels are generated in x-rows, 8 at a time, walking the voxels in memory order (z-slabs, then y-rows)
+    constexpr u32 LaneCount = 8;
+    constexpr u32 BatchCount = CHUNK_DIM_XY / LaneCount;
+    static_assert((CHUNK_DIM_XY % LaneCount) == 0);
+
+    __m256 RowX[BatchCount];
+    for (u32 Batch = 0; Batch < BatchCount; Batch++)
+    {
+        RowX[Batch] = GetRowX8(Chunk, Batch);
+    }
+
+    const __m256i One = _mm256_set1_epi32(1);
+    const __m256i Zero = _mm256_setzero_si256();
+    const u32 LastLayerIndex = Graph->LayerCount - 1;
+
+    // NOTE(boti): The biomes replace the type of the top layer
+    alignas(32) u32 TopLayerTypes[CHUNK_DIM_XY][CHUNK_DIM_XY];
+    for (u32 y = 0; y < CHUNK_DIM_XY; y++)
+    {
+        for (u32 x = 0; x < CHUNK_DIM_XY; x++)
+        {
+            TopLayerTypes[y][x] = (Graph->BiomeCount > 0) ? Graph->Biomes[Chunk->Biomes[y][x]].SurfaceType : Graph->LayerTypes[0];
+        }
+    }
+
+    for (u32 z = 0; z <= MaxZ; z++)
+    {
+        // NOTE(boti): The heights and the rules are in world space
+        s32 WorldZ = Chunk->P.z + (s32)z;
+        __m256i z8 = _mm256_set1_epi32(WorldZ);
+        __m256 RowZ = _mm256_set1_ps((f32)WorldZ);
+
+        u32 LatticeZ = 0;
+        __m256 tz = _mm256_setzero_ps();
+        if (UseLattice)
+        {
+            LatticeZ = z / Lattice->Spacing;
+            tz = _mm256_set1_ps((f32)(z % Lattice->Spacing) * InvLatticeSpacing);
+        }
+
+        for (u32 y = 0; y < CHUNK_DIM_XY; y++)
+        {
+            __m256 RowY = _mm256_set1_ps((f32)y + (f32)Chunk->P.y);
+
+            __m256i VoxelTypes[BatchCount];
+            for (u32 Batch = 0; Batch < BatchCount; Batch++)
+            {
+                __m256i Height = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&Chunk->Heightmap[y][Batch * LaneCount]));
+
+                // Layers, from the bottom up so that the upper ones win
+                __m256i TopLayerType = _mm256_load_si256((const __m256i*)&TopLayerTypes[y][Batch * LaneCount]);
+                __m256i VoxelType = (LastLayerIndex == 0) ? TopLayerType : _mm256_set1_epi32(Graph->LayerTypes[LastLayerIndex]);
+                for (u32 LayerIndex = LastLayerIndex; LayerIndex-- > 0; )
+                {
+                    __m256i LayerType = (LayerIndex == 0) ? TopLayerType : _mm256_set1_epi32(Graph->LayerTypes[LayerIndex]);
+                    __m256i IsInLayer = _mm256_cmpgt_epi32(z8, _mm256_sub_epi32(Height, _mm256_set1_epi32(Graph->LayerEndDepths[LayerIndex])));
+                    VoxelType = _mm256_blendv_epi8(VoxelType, LayerType, IsInLayer);
+                }
+                __m256i IsAir = _mm256_cmpgt_epi32(z8, Height);
+                VoxelType = _mm256_blendv_epi8(VoxelType, _mm256_set1_epi32(VOXEL_AIR), IsAir);
+
+                u32 LatticeOffset0 = 0, LatticeOffset1 = 0;
+                if (UseLattice)
+                {
+                    LatticeOffset0 = (LatticeZ * CHUNK_DIM_XY + y) * CHUNK_DIM_XY + Batch * LaneCount;
+                    LatticeOffset1 = LatticeOffset0 + CHUNK_DIM_XY * CHUNK_DIM_XY;
+                }
+
+                // NOTE(boti): Fields are only evaluated if there's at least one lane that a rule using it can actually change
+                u32 EvaluatedFieldMask = 0;
+                __m256 FieldValues[noise_graph::MaxFieldCount];
+                for (u32 RuleIndex = 0; RuleIndex < Graph->RuleCount; RuleIndex++)
+                {
+                    const noise_rule* Rule = Graph->Rules + RuleIndex;
+
+                    __m256i TypeBit = _mm256_sllv_epi32(One, VoxelType);
+                    __m256i CanApply = _mm256_cmpeq_epi32(_mm256_and_si256(TypeBit, _mm256_set1_epi32(Rule->FromTypeMask)), Zero);
+                    CanApply = _mm256_xor_si256(CanApply, _mm256_set1_epi32(-1));
+                    if (WorldZ >= Rule->Ceiling)
+                    {
+                        CanApply = _mm256_and_si256(CanApply, _mm256_cmpgt_epi32(Height, z8));
+                    }
+
+                    if (_mm256_testz_si256(CanApply, CanApply))
+                    {
+                        continue;
+                    }
+
+                    const u32 FieldIndex = Rule->FieldIndex;
+                    if (!(EvaluatedFieldMask & (1u << FieldIndex)))
+                    {
+                        EvaluatedFieldMask |= 1u << FieldIndex;
+                        FieldValues[FieldIndex] = UseLattice ?
+                            Lerp8(_mm256_loadu_ps(Lattice->Fields[FieldIndex] + LatticeOffset0), _mm256_loadu_ps(Lattice->Fields[FieldIndex] + LatticeOffset1), tz) :
+                            EvaluateNoiseProgram8(Gen, Graph->Fields + FieldIndex, RowX[Batch], RowY, RowZ);
+                    }
+
+                    __m256 Threshold = _mm256_set1_ps(Rule->Threshold);
+                    __m256i IsSelected = (Rule->Compare == NoiseCompare_Less) ?
+                        _mm256_castps_si256(_mm256_cmp_ps(FieldValues[FieldIndex], Threshold, _CMP_LT_OQ)) :
+                        _mm256_castps_si256(_mm256_cmp_ps(FieldValues[FieldIndex], Threshold, _CMP_GT_OQ));
+                    VoxelType = _mm256_blendv_epi8(VoxelType, _mm256_set1_epi32(Rule->ToType), _mm256_and_si256(CanApply, IsSelected));
+                }
+
+                VoxelTypes[Batch] = VoxelType;
+            }
+
+            // Pack the 2x8 32-bit voxel types into a 16-wide row of u16s
+            static_assert(BatchCount == 2);
+            __m256i Row = _mm256_packus_epi32(VoxelTypes[0], VoxelTypes[1]);
+            Row = _mm256_permute4x64_epi64(Row, _MM_SHUFFLE(3, 1, 2, 0));
+            _mm256_storeu_si256((__m256i*)Voxels->Voxels[z][y], Row);
+        }
+    }
+}
+
+// NOTE(boti): Same as GenerateRows_AVX2, one voxel at a time
+static void GenerateRows(generator_voxels* Voxels, const chunk* Chunk, const world_generator* Gen,
+                         const density_lattice* Lattice, u32 MaxZ)
+{
+    const noise_graph* Graph = &Gen->Graph;
+    const bool UseLattice = (Lattice != nullptr);
+    const f32 InvLatticeSpacing = UseLattice ? 1.0f / (f32)Lattice->Spacing : 0.0f;
+    const u32 LastLayerIndex = Graph->LayerCount - 1;
+
+    for (u32 z = 0; z <= MaxZ; z++)
+    {
+        s32 WorldZ = Chunk->P.z + (s32)z;
+
+        u32 LatticeZ = 0;
+        f32 tz = 0.0f;
+        if (UseLattice)
+        {
+            LatticeZ = z / Lattice->Spacing;
+            tz = (f32)(z % Lattice->Spacing) * InvLatticeSpacing;
+        }
+
+        for (u32 y = 0; y < CHUNK_DIM_XY; y++)
+        {
+            for (u32 x = 0; x < CHUNK_DIM_XY; x++)
+            {
+                s32 Height = Chunk->Heightmap[y][x];
+
+                // Layers, from the bottom up so that the upper ones win
+                u32 TopLayerType = (Graph->BiomeCount > 0) ? Graph->Biomes[Chunk->Biomes[y][x]].SurfaceType : Graph->LayerTypes[0];
+                u32 VoxelType = (LastLayerIndex == 0) ? TopLayerType : Graph->LayerTypes[LastLayerIndex];
+                for (u32 LayerIndex = LastLayerIndex; LayerIndex-- > 0; )
+                {
+                    if (WorldZ > Height - Graph->LayerEndDepths[LayerIndex])
+                    {
+                        VoxelType = (LayerIndex == 0) ? TopLayerType : Graph->LayerTypes[LayerIndex];
+                    }
+                }
+                if (WorldZ > Height)
+                {
+                    VoxelType = VOXEL_AIR;
+                }
+
+                u32 LatticeOffset0 = 0, LatticeOffset1 = 0;
+                if (UseLattice)
+                {
+                    LatticeOffset0 = (LatticeZ * CHUNK_DIM_XY + y) * CHUNK_DIM_XY + x;
+                    LatticeOffset1 = LatticeOffset0 + CHUNK_DIM_XY * CHUNK_DIM_XY;
+                }
+
+                u32 EvaluatedFieldMask = 0;
+                f32 FieldValues[noise_graph::MaxFieldCount];
+                for (u32 RuleIndex = 0; RuleIndex < Graph->RuleCount; RuleIndex++)
+                {
+                    const noise_rule* Rule = Graph->Rules + RuleIndex;
+
+                    u32 TypeBit = (VoxelType < 32) ? (1u << VoxelType) : 0u;
+                    bool CanApply = (TypeBit & Rule->FromTypeMask) != 0;
+                    if (WorldZ >= Rule->Ceiling)
+                    {
+                        CanApply = CanApply && (Height > WorldZ);
+                    }
+
+                    if (!CanApply)
+                    {
+                        continue;
+                    }
+
+                    const u32 FieldIndex = Rule->FieldIndex;
+                    if (!(EvaluatedFieldMask & (1u << FieldIndex)))
+                    {
+                        EvaluatedFieldMask |= 1u << FieldIndex;
+                        vec3 P = { (f32)x + (f32)Chunk->P.x, (f32)y + (f32)Chunk->P.y, (f32)WorldZ };
+                        FieldValues[FieldIndex] = UseLattice ?
+                            Lerp(Lattice->Fields[FieldIndex][LatticeOffset0], Lattice->Fields[FieldIndex][LatticeOffset1], tz) :
+                            EvaluateNoiseProgram(Gen, Graph->Fields + FieldIndex, P);
+                    }
+
+                    bool IsSelected = (Rule->Compare == NoiseCompare_Less) ?
+                        (FieldValues[FieldIndex] < Rule->Threshold) :
+                        (FieldValues[FieldIndex] > Rule->Threshold);
+                    if (IsSelected)
+                    {
+                        VoxelType = Rule->ToType;
+                    }
+                }
+
+                Voxels->Voxels[z][y][x] = (u16)VoxelType;
+            }
+        }
+    }
+}
+
+static void Generate(chunk* Chunk, const world_generator* Gen, memory_arena* Arena)
+{
+    TIMED_FUNCTION();
+
+    assert(Chunk);
+    assert(Chunk->Data);
+
+    const noise_graph* Graph = &Gen->Graph;
+    assert(Graph->LayerCount > 0);
+
+    LoadColumnHeightmap(Chunk, Gen);
+
+    // NOTE(boti): Everything above the highest column is air (rules never touch air),
+    //             so those slabs don't need any noise evaluated.
+    s32 MaxHeight = -32768;
+    for (u32 y = 0; y < CHUNK_DIM_XY; y++)
+    {
+        for (u32 x = 0; x < CHUNK_DIM_XY; x++)
+        {
+            MaxHeight = Max(MaxHeight, (s32)Chunk->Heightmap[y][x]);
+        }
+    }
+
+    // NOTE(boti): Chunks entirely above the terrain can't have any caves, ores or trees either
+    Chunk->StructurePlacementCount = 0;
+    if (MaxHeight < Chunk->P.z)
+    {
+        for (u32 SectionIndex = 0; SectionIndex < CHUNK_SECTION_COUNT; SectionIndex++)
+        {
+            SetUniformSection(Chunk->Data, SectionIndex, VOXEL_AIR);
+        }
+        memset(Chunk->HighestNonAirZ, 0xFF, sizeof(Chunk->HighestNonAirZ));
+        memset(Chunk->LowestAirZ, 0, sizeof(Chunk->LowestAirZ));
+        memset(Chunk->OpaqueMask, 0, sizeof(Chunk->OpaqueMask));
+        memset(Chunk->SolidMask, 0, sizeof(Chunk->SolidMask));
+        return;
+    }
+    // Relative to the chunk, including the layer above it
+    u32 MaxZ = (u32)Min(MaxHeight - Chunk->P.z, GENERATOR_DIM_Z - 1);
+
+    memory_arena_checkpoint VoxelCheckpoint = ArenaCheckpoint(Arena);
+    generator_voxels* Voxels = PushStruct<generator_voxels>(Arena);
+    assert(Voxels);
+
+    memory_arena_checkpoint Checkpoint = ArenaCheckpoint(Arena);
+
+    // NOTE(boti): Falls back to sampling every voxel if we couldn't get the memory for the lattice
+    density_lattice Lattice = {};
+    bool UseLattice = (Gen->DensityLatticeSpacing > 1) && SampleDensityLattice(&Lattice, Chunk, Gen, MaxZ, Arena);
+
+    // NOTE(boti): Same bits on every level, the 8-wide rows are only faster
+    if (Kernels->Level >= CPULevel_AVX2)
+    {
+        GenerateRows_AVX2(Voxels, Chunk, Gen, UseLattice ? &Lattice : nullptr, MaxZ);
+    }
+    else
+    {
+        GenerateRows(Voxels, Chunk, Gen, UseLattice ? &Lattice : nullptr, MaxZ);
+    }
+
+    // Clear everything above the terrain
+    static_assert(VOXEL_AIR == 0);
+    if (MaxZ + 1 < GENERATOR_DIM_Z)
+    {
+        memset(Voxels->Voxels[MaxZ + 1], 0, (GENERATOR_DIM_Z - (MaxZ + 1)) * sizeof(Voxels->Voxels[0]));
+    }
+
+    RestoreArena(Arena, Checkpoint);
+
+    if (Graph->Worms.CountPerRegion)
+    {
+        CarveWormCaves(Chunk, Voxels, Gen, Arena);
+    }
+
+    if (Graph->OreCount)
+    {
+        PlaceOreVeins(Chunk, Voxels, Gen);
+    }
+
+    PlaceStructures(Chunk, Voxels, Gen);
+
+    // Column bounds, only the voxels up to MaxZ can be anything other than air
+    s32 BoundsMaxZ = Min((s32)MaxZ, CHUNK_DIM_Z - 1);
+    for (s32 y = 0; y < CHUNK_DIM_XY; y++)
+    {
+        for (s32 x = 0; x < CHUNK_DIM_XY; x++)
+        {
+            s32 HighestNonAirZ = -1;
+            s32 LowestAirZ = BoundsMaxZ + 1;
+            for (s32 z = BoundsMaxZ; z >= 0; z--)
+            {
+                if (Voxels->Voxels[z][y][x] == VOXEL_AIR)
+                {
+                    LowestAirZ = z;
+                }
+                else if (HighestNonAirZ < 0)
+                {
+                    HighestNonAirZ = z;
+                }
+            }
+            Chunk->HighestNonAirZ[y][x] = (s8)HighestNonAirZ;
+            Chunk->LowestAirZ[y][x] = (s8)LowestAirZ;
+        }
+    }
+
+    // Voxel masks, the rows above BoundsMaxZ are all air
+    memset(Chunk->OpaqueMask, 0, sizeof(Chunk->OpaqueMask));
+    memset(Chunk->SolidMask, 0, sizeof(Chunk->SolidMask));
+    for (s32 z = 0; z <= BoundsMaxZ; z++)
+    {
+        for (s32 y = 0; y < CHUNK_DIM_XY; y++)
+        {
+            u32 OpaqueRow = 0;
+            u32 SolidRow = 0;
+            for (s32 x = 0; x < CHUNK_DIM_XY; x++)
+            {
+                u16 VoxelType = Voxels->Voxels[z][y][x];
+                OpaqueRow |= (IsOpaqueVoxel(VoxelType) ? 1u : 0u) << x;
+                SolidRow |= (IsSolidVoxel(VoxelType) ? 1u : 0u) << x;
+            }
+            Chunk->OpaqueMask[z][y] = (u16)OpaqueRow;
+            Chunk->SolidMask[z][y] = (u16)SolidRow;
+        }
+    }
+
+    // NOTE(boti): The sections above the terrain are known to be air, so they're set without looking at the voxels
+    u32 TerrainSectionCount = Min(MaxZ / CHUNK_SECTION_DIM + 1, CHUNK_SECTION_COUNT);
+    for (u32 SectionIndex = 0; SectionIndex < CHUNK_SECTION_COUNT; SectionIndex++)
+    {
+        if (SectionIndex < TerrainSectionCount)
+        {
+            PackChunkSection(Chunk->Data, SectionIndex, &Voxels->Voxels[SectionIndex * CHUNK_SECTION_DIM][0][0]);
+        }
+        else
+        {
+            SetUniformSection(Chunk->Data, SectionIndex, VOXEL_AIR);
+        }
+    }
+    RestoreArena(Arena, VoxelCheckpoint);
+}
+
+static void GenerateDecorations(chunk* Chunk, const chunk* const Neighborhood[3][3][3], const world_generator* Gen)
+{
+    TIMED_FUNCTION();
+
+    assert(Chunk);
+    assert(Chunk->Data);
+    assert(Neighborhood[1][1][1] == Chunk);
+
+    for (u32 NeighborZ = 0; NeighborZ < 3; NeighborZ++)
+    {
+        for (u32 NeighborY = 0; NeighborY < 3; NeighborY++)
+        {
+            for (u32 NeighborX = 0; NeighborX < 3; NeighborX++)
+            {
+                const chunk* Source = Neighborhood[NeighborZ][NeighborY][NeighborX];
+                assert(Source);
+
+                vec3i Offset = Source->P - Chunk->P;
+                for (u32 PlacementIndex = 0; PlacementIndex < Source->StructurePlacementCount; PlacementIndex++)
+                {
+                    const structure_placement* Placement = Source->StructurePlacements + PlacementIndex;
+                    assert(Placement->StructureIndex < Gen->StructureCount);
+                    const world_structure* Structure = Gen->Structures + Placement->StructureIndex;
+
+                    // Structure bounds relative to Chunk, clipped to the chunk
+                    vec3i MinP = 
+                    {
+                        Offset.x + Placement->P.x - Structure->Extent.x / 2,
+                        Offset.y + Placement->P.y - Structure->Extent.y / 2,
+                        Offset.z + Placement->P.z,
+                    };
+                    vec3i BeginP = 
+                    {
+                        Max(MinP.x, 0),
+                        Max(MinP.y, 0),
+                        Max(MinP.z, 0),
+                    };
+                    vec3i EndP = 
+                    {
+                        Min(MinP.x + Structure->Extent.x, CHUNK_DIM_XY),
+                        Min(MinP.y + Structure->Extent.y, CHUNK_DIM_XY),
+                        Min(MinP.z + Structure->Extent.z, CHUNK_DIM_Z),
+                    };
+
+                    for (s32 z = BeginP.z; z < EndP.z; z++)
+                    {
+                        for (s32 y = BeginP.y; y < EndP.y; y++)
+                        {
+                            for (s32 x = BeginP.x; x < EndP.x; x++)
+                            {
+                                vec3i StructureP = vec3i{ x, y, z } - MinP;
+                                s32 Index = StructureP.x + Structure->Extent.x * (StructureP.y + StructureP.z * Structure->Extent.y);
+                                u16 VoxelType = Structure->Voxels[Index];
+
+                                // NOTE(boti): Structures only grow into air, so overlapping structures
+                                //             resolve the same way regardless of which chunk they come from.
+                                //             Nothing below the lowest air voxel of the column can be air.
+                                if ((VoxelType != VOXEL_INVALID) && (z >= Chunk->LowestAirZ[y][x]) &&
+                                    (GetVoxel(Chunk->Data, x, y, z) == VOXEL_AIR))
+                                {
+                                    SetVoxel(Chunk->Data, x, y, z, VoxelType);
+                                    UpdateColumnBounds(Chunk, x, y, z, VoxelType);
+                                    UpdateVoxelMasks(Chunk, x, y, z, VoxelType);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <Common.hpp>
+#include <Math.hpp>
+#include <Random.hpp>
+#include <Memory.hpp>
+#include <Kernels.hpp>
+
+#include <Chunk.hpp>
+#include <NoiseGraph.hpp>
+
+// NOTE(boti): The climate (and the biome blend) is only sampled at every BIOME_CELL_DIM-th column,
+//             the columns in between are bilinearly interpolated
+constexpr s32 BIOME_CELL_DIM = 4;
+static_assert((CHUNK_DIM_XY % BIOME_CELL_DIM) == 0);
+
+struct world_structure
+{
+    vec3i Extent;
+    u16* Voxels;
+};
+
+enum noise_type : u32
+{
+    Noise_Perlin = 0,   // Permutation table based, repeats every 256 lattice cells
+    Noise_Hash,         // Hashes the lattice coordinates, doesn't repeat within 32-bit coordinates
+    Noise_Simplex,      // Hashed like Noise_Hash but on a tetrahedral lattice, 3D (density fields) only
+};
+
+// NOTE(boti): Capsule with a linearly changing radius, in world space (voxels)
+struct cave_segment
+{
+    vec3 P0;
+    vec3 P1;
+    f32 Radius0;
+    f32 Radius1;
+};
+
+// NOTE(boti): Worm caves are traced per region (noise_graph::WormRegionDim) and cached as segment lists,
+//             so the chunks of a region don't all have to trace the same worms again
+struct cave_region
+{
+    ticket_mutex Mutex;
+    b32 IsValid;
+    vec2i P; // In regions
+    u32 Seed;
+    noise_worms Worms; // What the segments were traced with
+    u32 SegmentCount;
+    cave_segment Segments[noise_graph::MaxWormSegmentCountPerRegion];
+};
+
+struct cave_region_cache
+{
+    // NOTE(boti): Regions map to the entries by their position modulo RegionCountSqrt,
+    //             so the regions around any chunk never evict each other
+    static constexpr s32 RegionCountSqrt = 8;
+    cave_region Regions[RegionCountSqrt * RegionCountSqrt];
+};
+
+// NOTE(boti): The heightmap and the biomes are the same for every chunk of a column,
+//             so they're only generated for the first chunk of the column that gets there and copied for the rest
+struct column_heightmap
+{
+    ticket_mutex Mutex;
+    b32 IsValid;
+    vec2i P; // Same as the chunks of the column
+    u32 Seed;
+    noise_type NoiseType;
+    s16 Heightmap[CHUNK_DIM_XY][CHUNK_DIM_XY];
+    u8 Biomes[CHUNK_DIM_XY][CHUNK_DIM_XY];
+};
+
+struct column_heightmap_cache
+{
+    // NOTE(boti): Columns map to the entries by their position modulo ColumnCountSqrt,
+    //             which is about the size of the game's generation window
+    static constexpr s32 ColumnCountSqrt = 64;
+    column_heightmap Columns[ColumnCountSqrt * ColumnCountSqrt];
+};
+
+struct world_generator
+{
+    u32 Seed;
+    noise_type NoiseType;           // Height (2D)
+    noise_type DensityNoiseType;    // Density fields (3D), e.g. ores and caves
+    perlin2 Perlin2;
+    perlin3 Perlin3;
+    hash_noise HashNoise;
+    simplex3 Simplex3;
+
+    noise_graph Graph;
+
+    // NOTE(boti): Spacing (in voxels) of the lattice the 3D density fields of the graph are sampled on,
+    //             voxels in between are trilinearly interpolated. 1 means every voxel is sampled.
+    //             Must be a power of 2 and at most CHUNK_DIM_XY.
+    u32 DensityLatticeSpacing;
+
+    // NOTE(boti): Shared by every thread generating with this generator (the entries are locked individually),
+    //             might be null, in which case the worms get traced for every chunk
+    cave_region_cache* CaveCache;
+    // NOTE(boti): Same as the cave cache, except the graph isn't checked:
+    //             copies of the generator with a different graph must not share it
+    column_heightmap_cache* ColumnCache;
+
+    u32 StructureCount;
+    world_structure* Structures;
+
+    world_structure* TreeStructure;
+};
+
+// GraphSource is the noise graph describing the terrain (see NoiseGraph.hpp), the built-in default graph is used if it's empty.
+// Returns false if GraphSource couldn't be compiled, in which case the default graph is used and GraphErrorLine is set.
+static bool InitializeWorldGenerator(world_generator* Generator, u32 Seed, buffer GraphSource, memory_arena* Arena, u32* GraphErrorLine = nullptr);
+
+// Height of the terrain surface at a column before caves are carved out of it.
+// Only evaluates the 2D terrain noise, so it's cheap enough to use without generating the chunk.
+s32 GetTerrainHeight(const world_generator* Generator, vec2i P);
+// Index of the biome (in the generator's noise graph) at a column, 0 if there are no biomes.
+u32 GetBiome(const world_generator* Generator, vec2i P);
+
+// Fills Chunk->Heightmap and Chunk->Biomes, this is the first pass of Generate
+static void GenerateHeightmap(chunk* Chunk, const world_generator* Generator);
+// Level0 pass: terrain and structure placement.
+// Arena is only used for scratch memory
+static void Generate(chunk* Chunk, const world_generator* Generator, memory_arena* Arena);
+
+// Level1 pass: writes the part of every structure placed in the 3x3x3 neighborhood (indexed [z][y][x], Chunk in the middle)
+// that overlaps Chunk into its data. Only Chunk gets written to, the neighbors must have finished Level0.
+static void GenerateDecorations(chunk* Chunk, const chunk* const Neighborhood[3][3][3], const world_generator* Generator);
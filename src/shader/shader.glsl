@@ -13,7 +13,7 @@ layout(push_constant) uniform PushConstants
 
 layout(location = ATTRIB_POS) in uint v_PackedPosition;
 layout(location = ATTRIB_TEXCOORD) in uint v_PackedTexCoord;
-layout(location = ATTRIB_CHUNK_P) in vec2 v_ChunkP;
+layout(location = ATTRIB_CHUNK_P) in vec3 v_ChunkP;
 
 const float AOTable[4] = { 1.0, 0.75, 0.5, 0.25 };
 
@@ -47,7 +47,7 @@ vec3 UnpackTexCoord(in uint Packed, out float AO)
 
 void main()
 {
-    vec3 P = UnpackPosition(v_PackedPosition) + vec3(v_ChunkP, 0);
+    vec3 P = UnpackPosition(v_PackedPosition) + v_ChunkP;
     gl_Position = Transform * vec4(P, 1);
     TexCoord = UnpackTexCoord(v_PackedTexCoord, AO);
 }